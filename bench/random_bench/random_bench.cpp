@@ -0,0 +1,1662 @@
+/*
+ *  random_bench.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Benchmarks for the Random Number Library.
+ *
+ *      Usage:
+ *          random_bench [-t threads] [-p compact|spread] [benchmark ...]
+ *
+ *      If no benchmark is named, all benchmarks are run.
+ *
+ *      The scaling benchmark measures requests from 1 to the given number
+ *      of threads (by default, one per CPU) for each way of sharing
+ *      generators among threads: an instance per thread, a thread-local
+ *      accessor, one generator shared under a mutex, one shared pool, and
+ *      one pool per CPU.  With -p, threads are pinned to CPUs, filling one
+ *      NUMA node before the next ("compact") or alternating between nodes
+ *      ("spread").
+ *
+ *  Portability Issues:
+ *      Thread pinning, the NUMA topology, CPU migrations, and context
+ *      switches are available only on Linux.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <span>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <latch>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TERRA_RANDOM_PERF_EVENTS
+#endif
+#endif
+#include <terra/random/health_test.h>
+#include <terra/random/jitter_source.h>
+#include <terra/random/random_generator.h>
+#include <terra/random/random_generator_pool.h>
+#include <terra/random/generator_metrics.h>
+#include <terra/random/mt19937.h>
+#include <terra/random/pcg32.h>
+#include <terra/random/philox.h>
+#include <terra/random/xoshiro.h>
+
+using namespace Terra::Random;
+
+namespace
+{
+
+// A benchmark that may be selected by name on the command line
+struct Benchmark
+{
+    const char *name;
+    const char *description;
+    void (*run)();
+};
+
+// Placement of the scaling benchmark's threads on CPUs
+enum class Placement
+{
+    None,
+    Compact,
+    Spread
+};
+
+// Options given on the command line
+struct Options
+{
+    unsigned threads = 0;
+    Placement placement = Placement::None;
+};
+
+Options options;
+
+// The generator and pool used by the scaling benchmark
+using ScalingGenerator = BasicRandomGenerator<Xoshiro256PlusPlus>;
+using ScalingPool = BasicRandomGeneratorPool<Xoshiro256PlusPlus>;
+
+// Octets in each scaling benchmark request
+constexpr std::size_t Request_Size = 32;
+
+// Requests each thread makes before the scaling benchmark is timed
+constexpr unsigned Warmup_Requests = 1'000;
+
+// One request in this many is timed
+constexpr unsigned Sample_Interval = 16;
+
+// Requests served by each lease from a pool (as for a connection)
+constexpr unsigned Lease_Requests = 64;
+
+// Time for which each strategy is measured with each number of threads
+constexpr std::chrono::milliseconds Scaling_Duration{250};
+
+// Counts read from the hardware counters
+struct PerfCounts
+{
+    std::array<std::uint64_t, 4> values{};
+    std::array<bool, 4> valid{};
+};
+
+// Hardware counters of the calling thread, read with perf_event_open()
+class PerfCounters
+{
+    public:
+        // Indices of the counters in PerfCounts
+        static constexpr std::size_t Cycles = 0;
+        static constexpr std::size_t Instructions = 1;
+        static constexpr std::size_t Cache_Misses = 2;
+        static constexpr std::size_t Branch_Misses = 3;
+        static constexpr std::size_t Counter_Count = 4;
+
+        PerfCounters();
+        PerfCounters(const PerfCounters &) = delete;
+        ~PerfCounters();
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        void Start() noexcept;
+        PerfCounts Stop() noexcept;
+        bool IsAvailable(std::size_t counter) const noexcept
+        {
+            return descriptors[counter] >= 0;
+        }
+        std::string Describe() const;
+
+    protected:
+        std::array<int, Counter_Count> descriptors;
+        bool user_only;
+        std::string error;
+};
+
+// Results of the scaling benchmark, for one thread or all threads
+struct ScalingResult
+{
+    std::uint64_t requests = 0;
+    std::uint64_t contended = 0;
+    std::uint64_t migrations = 0;
+    std::uint64_t context_switches = 0;
+    LatencyHistogram latency;
+    PerfCounts counts;
+};
+
+/*
+ *  SecondsSince()
+ *
+ *  Description:
+ *      Return the time elapsed since the given time.
+ *
+ *  Parameters:
+ *      start [in]
+ *          The starting time.
+ *
+ *  Returns:
+ *      The elapsed time in seconds.
+ *
+ *  Comments:
+ *      None.
+ */
+double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+/*
+ *  PerfCounters::PerfCounters()
+ *
+ *  Description:
+ *      Open the hardware counters for the calling thread.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      If the kernel does not permit counting kernel-mode events (see
+ *      /proc/sys/kernel/perf_event_paranoid), only user-mode events are
+ *      counted.  Counters that cannot be opened (e.g., in a virtual machine
+ *      that does not expose them) are left unavailable, and the reason the
+ *      cycle counter could not be opened is kept for Describe().
+ */
+PerfCounters::PerfCounters() : user_only{false}
+{
+    descriptors.fill(-1);
+
+#ifdef TERRA_RANDOM_PERF_EVENTS
+    constexpr std::array<std::uint64_t, Counter_Count> Events =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (std::size_t i = 0; i < Counter_Count; i++)
+    {
+        perf_event_attr attributes{};
+
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = Events[i];
+        attributes.disabled = 1;
+        attributes.exclude_hv = 1;
+        attributes.exclude_kernel = user_only ? 1 : 0;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                 PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        auto open = [&]()
+        {
+            return static_cast<int>(syscall(SYS_perf_event_open,
+                                            &attributes,
+                                            0,
+                                            -1,
+                                            -1,
+                                            PERF_FLAG_FD_CLOEXEC));
+        };
+
+        descriptors[i] = open();
+
+        if ((descriptors[i] < 0) && !user_only &&
+            ((errno == EACCES) || (errno == EPERM)))
+        {
+            user_only = true;
+            attributes.exclude_kernel = 1;
+            descriptors[i] = open();
+        }
+
+        if ((descriptors[i] < 0) && (i == Cycles))
+        {
+            error = std::strerror(errno);
+        }
+    }
+#else
+    error = "not supported on this platform";
+#endif
+}
+
+/*
+ *  PerfCounters::~PerfCounters()
+ *
+ *  Description:
+ *      Close the hardware counters.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+PerfCounters::~PerfCounters()
+{
+#ifdef TERRA_RANDOM_PERF_EVENTS
+    for (auto descriptor : descriptors)
+    {
+        if (descriptor >= 0) close(descriptor);
+    }
+#endif
+}
+
+/*
+ *  PerfCounters::Start()
+ *
+ *  Description:
+ *      Reset the counters and start counting.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void PerfCounters::Start() noexcept
+{
+#ifdef TERRA_RANDOM_PERF_EVENTS
+    for (auto descriptor : descriptors)
+    {
+        if (descriptor < 0) continue;
+        ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/*
+ *  PerfCounters::Stop()
+ *
+ *  Description:
+ *      Stop counting and read the counters.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The counts since Start() was called.
+ *
+ *  Comments:
+ *      When the kernel multiplexes more counters than the processor has,
+ *      each count is scaled by the fraction of the time it was counting.
+ *      A counter that was unavailable or never scheduled is marked as not
+ *      valid.
+ */
+PerfCounts PerfCounters::Stop() noexcept
+{
+    PerfCounts counts;
+
+#ifdef TERRA_RANDOM_PERF_EVENTS
+    for (auto descriptor : descriptors)
+    {
+        if (descriptor >= 0) ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (std::size_t i = 0; i < Counter_Count; i++)
+    {
+        // The value, the time enabled, and the time running
+        std::array<std::uint64_t, 3> values{};
+
+        if ((descriptors[i] < 0) ||
+            (read(descriptors[i], values.data(), sizeof(values)) !=
+             static_cast<ssize_t>(sizeof(values))) ||
+            (values[2] == 0))
+        {
+            continue;
+        }
+
+        counts.values[i] = static_cast<std::uint64_t>(
+            static_cast<double>(values[0]) * static_cast<double>(values[1]) /
+            static_cast<double>(values[2]));
+        counts.valid[i] = true;
+    }
+#endif
+
+    return counts;
+}
+
+/*
+ *  PerfCounters::Describe()
+ *
+ *  Description:
+ *      Describe which counters are available.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A description suitable for printing before a table of results.
+ *
+ *  Comments:
+ *      None.
+ */
+std::string PerfCounters::Describe() const
+{
+    if (!IsAvailable(Cycles))
+    {
+        return "hardware counters unavailable (" + error + ")";
+    }
+
+    return std::string("hardware counters available") +
+           (user_only ? " (user mode only)" : "");
+}
+
+/*
+ *  PrintPerKiB()
+ *
+ *  Description:
+ *      Print a count per KiB of output, or "-" if the count is not valid.
+ *
+ *  Parameters:
+ *      counts [in]
+ *          The counts.
+ *
+ *      counter [in]
+ *          The counter to print.
+ *
+ *      octets [in]
+ *          The number of octets over which the count was taken.
+ *
+ *      width [in]
+ *          The width of the column.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void PrintPerKiB(const PerfCounts &counts,
+                 std::size_t counter,
+                 double octets,
+                 int width)
+{
+    if (!counts.valid[counter])
+    {
+        std::cout << std::setw(width) << "-";
+        return;
+    }
+
+    std::cout << std::setw(width) << std::setprecision(2)
+              << static_cast<double>(counts.values[counter]) * 1024 / octets;
+}
+
+/*
+ *  JitterBenchmark()
+ *
+ *  Description:
+ *      Measure the startup cost and throughput of the JitterSource.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The startup cost includes the startup health test.
+ */
+void JitterBenchmark()
+{
+    constexpr unsigned Startup_Iterations = 20;
+    constexpr std::size_t Read_Size = 4096;
+
+    unsigned healthy = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < Startup_Iterations; i++)
+    {
+        JitterSource source;
+        if (source.IsHealthy()) healthy++;
+    }
+
+    double startup = SecondsSince(start) / Startup_Iterations;
+
+    JitterSource source;
+    std::vector<std::uint8_t> octets(Read_Size);
+
+    start = std::chrono::steady_clock::now();
+    std::size_t octets_read = source.Read(octets);
+    double elapsed = SecondsSince(start);
+
+    std::cout << "  startup:    " << std::fixed << std::setprecision(1)
+              << startup * 1e6 << " us (" << healthy << " of "
+              << Startup_Iterations << " healthy)" << std::endl
+              << "  throughput: " << octets_read / elapsed / 1024
+              << " KiB/s (" << octets_read << " of " << Read_Size
+              << " octets)" << std::endl
+              << "  32 octets:  " << 32 * elapsed / octets_read * 1e6
+              << " us" << std::endl;
+}
+
+/*
+ *  PrintHistogram()
+ *
+ *  Description:
+ *      Print the count and percentiles of a latency histogram.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The name of the histogram.
+ *
+ *      histogram [in]
+ *          The histogram to print.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Latencies are printed in microseconds.
+ */
+void PrintHistogram(const char *name, const LatencyHistogram &histogram)
+{
+    auto us = [](std::uint64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    };
+
+    std::cout << "  " << std::left << std::setw(12) << name << std::right
+              << "count " << histogram.GetCount() << std::fixed
+              << std::setprecision(3)
+              << ", p50 " << us(histogram.GetPercentile(50.0))
+              << " us, p99 " << us(histogram.GetPercentile(99.0))
+              << " us, p99.9 " << us(histogram.GetPercentile(99.9))
+              << " us, max " << us(histogram.GetMaximum()) << " us"
+              << std::endl;
+}
+
+/*
+ *  LatencyBenchmark()
+ *
+ *  Description:
+ *      Print the latency histograms recorded by the library for random
+ *      source reads and seed pool refills.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Constructing generators draws seeds from the seed pool, which causes
+ *      the pool to be refilled.  The histograms include anything recorded
+ *      earlier in the process.
+ */
+void LatencyBenchmark()
+{
+    constexpr unsigned Read_Iterations = 100'000;
+    constexpr unsigned Generator_Count = 2'000;
+
+    std::array<std::uint8_t, 16> octets;
+    RandomGenerator generator;
+
+    SetGeneratorTiming(true);
+
+    for (unsigned i = 0; i < Read_Iterations; i++)
+    {
+        generator.GetRandomOctets(octets);
+    }
+
+    for (unsigned i = 0; i < Generator_Count; i++)
+    {
+        CompactRandomGenerator seeded(true);
+    }
+
+    SetGeneratorTiming(false);
+
+    GeneratorMetrics metrics = GetGeneratorMetrics();
+
+    PrintHistogram("source read", metrics.source_latency);
+    PrintHistogram("pool refill", metrics.refill_latency);
+}
+
+/*
+ *  HealthBenchmark()
+ *
+ *  Description:
+ *      Measure the cost of the continuous health tests applied to each seed
+ *      pool refill, relative to the cost of the refill.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The refill latency is the median recorded by the library, which
+ *      includes the health tests.
+ */
+void HealthBenchmark()
+{
+    constexpr unsigned Test_Iterations = 100'000;
+    constexpr unsigned Generator_Count = 2'000;
+    constexpr std::size_t Refill_Size = 4096;
+
+    std::vector<std::uint8_t> octets(Refill_Size);
+    RandomGenerator generator;
+    HealthTest health_test;
+    unsigned failures = 0;
+
+    generator.GetRandomOctets(octets);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < Test_Iterations; i++)
+    {
+        if (!health_test.Test(octets))
+        {
+            failures++;
+            health_test.Reset();
+        }
+    }
+
+    double test = SecondsSince(start) / Test_Iterations * 1e9;
+
+    for (unsigned i = 0; i < Generator_Count; i++)
+    {
+        CompactRandomGenerator seeded(true);
+    }
+
+    double refill = static_cast<double>(
+        GetGeneratorMetrics().refill_latency.GetPercentile(50.0));
+
+    std::cout << "  test:       " << std::fixed << std::setprecision(1)
+              << test << " ns per " << Refill_Size << " octets ("
+              << failures << " failures)" << std::endl
+              << "  refill:     " << refill << " ns (p50)" << std::endl
+              << "  overhead:   " << std::setprecision(2)
+              << (refill > 0 ? 100.0 * test / refill : 0.0) << "%"
+              << std::endl;
+}
+
+/*
+ *  ParseCPUList()
+ *
+ *  Description:
+ *      Parse a Linux CPU list (e.g., "0-3,8-11").
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to parse.
+ *
+ *  Returns:
+ *      The CPUs in the list.
+ *
+ *  Comments:
+ *      Throws std::invalid_argument if the text is not a valid CPU list.
+ */
+std::vector<unsigned> ParseCPUList(const std::string &text)
+{
+    std::vector<unsigned> cpus;
+    std::istringstream stream(text);
+    std::string range;
+
+    while (std::getline(stream, range, ','))
+    {
+        if (range.empty()) continue;
+
+        const std::size_t dash = range.find('-');
+        const auto first =
+            static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+        const auto last =
+            (dash == std::string::npos) ?
+                first :
+                static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+
+        for (unsigned cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+/*
+ *  GetNodes()
+ *
+ *  Description:
+ *      Get the CPUs on which this process may run, grouped by NUMA node.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The CPUs of each node that has any.
+ *
+ *  Comments:
+ *      Where the NUMA topology cannot be read, all CPUs are placed in one
+ *      node, numbered from 0 unless the process affinity mask says
+ *      otherwise.
+ */
+std::vector<std::vector<unsigned>> GetNodes()
+{
+    std::vector<std::vector<unsigned>> nodes;
+    std::vector<unsigned> allowed;
+
+#ifdef __linux__
+    cpu_set_t mask;
+
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+    {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &mask)) allowed.push_back(cpu);
+        }
+    }
+
+    for (unsigned node = 0;; node++)
+    {
+        std::ifstream file("/sys/devices/system/node/node" +
+                           std::to_string(node) + "/cpulist");
+        std::string line;
+
+        if (!file || !std::getline(file, line)) break;
+
+        std::vector<unsigned> cpus;
+
+        for (auto cpu : ParseCPUList(line))
+        {
+            if (std::find(allowed.begin(), allowed.end(), cpu) !=
+                allowed.end())
+            {
+                cpus.push_back(cpu);
+            }
+        }
+
+        if (!cpus.empty()) nodes.push_back(std::move(cpus));
+    }
+#endif
+
+    if (nodes.empty())
+    {
+        if (allowed.empty())
+        {
+            for (unsigned cpu = 0;
+                 cpu < std::max(1U, std::thread::hardware_concurrency());
+                 cpu++)
+            {
+                allowed.push_back(cpu);
+            }
+        }
+
+        nodes.push_back(allowed);
+    }
+
+    return nodes;
+}
+
+/*
+ *  PlaceThreads()
+ *
+ *  Description:
+ *      Choose the CPUs on which threads are to run.
+ *
+ *  Parameters:
+ *      nodes [in]
+ *          The CPUs of each NUMA node.
+ *
+ *      placement [in]
+ *          How threads are to be placed.
+ *
+ *  Returns:
+ *      The CPUs in the order in which threads are assigned to them.
+ *
+ *  Comments:
+ *      Compact placement fills one node before using the next, so a
+ *      small number of threads shares one node's caches and memory;
+ *      spread placement assigns successive threads to successive nodes.
+ */
+std::vector<unsigned> PlaceThreads(
+                            const std::vector<std::vector<unsigned>> &nodes,
+                            Placement placement)
+{
+    std::vector<unsigned> cpus;
+    std::size_t total = 0;
+
+    for (const auto &node : nodes) total += node.size();
+
+    if (placement == Placement::Spread)
+    {
+        for (std::size_t i = 0; cpus.size() < total; i++)
+        {
+            for (const auto &node : nodes)
+            {
+                if (i < node.size()) cpus.push_back(node[i]);
+            }
+        }
+    }
+    else
+    {
+        for (const auto &node : nodes)
+        {
+            cpus.insert(cpus.end(), node.begin(), node.end());
+        }
+    }
+
+    return cpus;
+}
+
+/*
+ *  PinThread()
+ *
+ *  Description:
+ *      Restrict the calling thread to run only on the given CPU.
+ *
+ *  Parameters:
+ *      cpu [in]
+ *          The CPU on which the thread is to run.
+ *
+ *  Returns:
+ *      True if the thread was pinned, false if not.
+ *
+ *  Comments:
+ *      Threads are pinned only on Linux.
+ */
+bool PinThread([[maybe_unused]] unsigned cpu)
+{
+#ifdef __linux__
+    cpu_set_t mask;
+
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+    return false;
+#endif
+}
+
+/*
+ *  CurrentCPU()
+ *
+ *  Description:
+ *      Get the CPU on which the calling thread is running.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The CPU number, or 0 if it cannot be determined.
+ *
+ *  Comments:
+ *      On Linux, this is read from the vDSO without a system call.
+ */
+unsigned CurrentCPU()
+{
+#ifdef __linux__
+    const int cpu = sched_getcpu();
+
+    return (cpu < 0) ? 0 : static_cast<unsigned>(cpu);
+#else
+    return 0;
+#endif
+}
+
+/*
+ *  ContextSwitches()
+ *
+ *  Description:
+ *      Get the number of context switches of the calling thread.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of voluntary and involuntary context switches, or 0 if
+ *      it cannot be determined.
+ *
+ *  Comments:
+ *      Voluntary switches include those made while waiting for a lock.
+ */
+std::uint64_t ContextSwitches()
+{
+#ifdef __linux__
+    rusage usage{};
+
+    if (getrusage(RUSAGE_THREAD, &usage) == 0)
+    {
+        return static_cast<std::uint64_t>(usage.ru_nvcsw) +
+               static_cast<std::uint64_t>(usage.ru_nivcsw);
+    }
+#endif
+
+    return 0;
+}
+
+// Each thread constructs and uses its own generator
+struct InstanceStrategy
+{
+    static constexpr const char *Name = "instance";
+
+    explicit InstanceStrategy(unsigned) {}
+
+    struct Worker
+    {
+        explicit Worker(InstanceStrategy &) : generator(true) {}
+
+        void Request(std::span<std::uint8_t> octets, ScalingResult &)
+        {
+            generator.GetRandomOctets(octets);
+        }
+
+        ScalingGenerator generator;
+    };
+};
+
+/*
+ *  ThreadGenerator()
+ *
+ *  Description:
+ *      Get the calling thread's generator, constructing it on first use.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the calling thread's generator.
+ *
+ *  Comments:
+ *      This is the accessor an application would use to avoid passing
+ *      generators to the functions that need them.
+ */
+ScalingGenerator &ThreadGenerator()
+{
+    thread_local ScalingGenerator generator(true);
+
+    return generator;
+}
+
+// Each request goes through the thread-local accessor
+struct ThreadLocalStrategy
+{
+    static constexpr const char *Name = "thread_local";
+
+    explicit ThreadLocalStrategy(unsigned) {}
+
+    struct Worker
+    {
+        explicit Worker(ThreadLocalStrategy &) {}
+
+        void Request(std::span<std::uint8_t> octets, ScalingResult &)
+        {
+            ThreadGenerator().GetRandomOctets(octets);
+        }
+    };
+};
+
+// All threads share one generator guarded by a mutex
+struct SharedStrategy
+{
+    static constexpr const char *Name = "shared";
+
+    explicit SharedStrategy(unsigned) : generator(true) {}
+
+    struct Worker
+    {
+        explicit Worker(SharedStrategy &strategy) : strategy(strategy) {}
+
+        void Request(std::span<std::uint8_t> octets, ScalingResult &result)
+        {
+            std::unique_lock<std::mutex> lock(strategy.mutex,
+                                              std::try_to_lock);
+
+            if (!lock.owns_lock())
+            {
+                result.contended++;
+                lock.lock();
+            }
+
+            strategy.generator.GetRandomOctets(octets);
+        }
+
+        SharedStrategy &strategy;
+    };
+
+    std::mutex mutex;
+    ScalingGenerator generator;
+};
+
+/*
+ *  LeaseRequest()
+ *
+ *  Description:
+ *      Serve a request from a pooled generator, checking out another
+ *      generator once the current lease has served Lease_Requests
+ *      requests.
+ *
+ *  Parameters:
+ *      pool [in]
+ *          A function returning the pool from which to check out a
+ *          generator.
+ *
+ *      lease [in/out]
+ *          The current lease.
+ *
+ *      remaining [in/out]
+ *          The number of requests the current lease is still to serve.
+ *
+ *      octets [out]
+ *          The octets to fill.
+ *
+ *      result [in/out]
+ *          The results, in which a checkout that found the pool empty is
+ *          counted as contended.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The lease is returned before the next checkout so that a thread
+ *      never holds two pooled generators.
+ */
+template<typename GetPool>
+void LeaseRequest(GetPool pool,
+                  ScalingPool::Lease &lease,
+                  unsigned &remaining,
+                  std::span<std::uint8_t> octets,
+                  ScalingResult &result)
+{
+    if (remaining == 0)
+    {
+        lease.Return();
+        lease = pool().Checkout();
+        if (!lease.IsPooled()) result.contended++;
+        remaining = Lease_Requests;
+    }
+
+    remaining--;
+    lease->GetRandomOctets(octets);
+}
+
+// Threads lease generators from one shared pool
+struct PoolStrategy
+{
+    static constexpr const char *Name = "pool";
+
+    explicit PoolStrategy(unsigned threads) :
+        pool(threads, true, PoolReturnPolicy::Jump)
+    {
+    }
+
+    struct Worker
+    {
+        explicit Worker(PoolStrategy &strategy) : strategy(strategy) {}
+
+        void Request(std::span<std::uint8_t> octets, ScalingResult &result)
+        {
+            LeaseRequest([&]() -> ScalingPool & { return strategy.pool; },
+                         lease,
+                         remaining,
+                         octets,
+                         result);
+        }
+
+        PoolStrategy &strategy;
+        ScalingPool::Lease lease;
+        unsigned remaining = 0;
+    };
+
+    ScalingPool pool;
+};
+
+// Threads lease generators from a pool for the CPU on which they run;
+// each pool is constructed by the first thread to use it, so its memory
+// is allocated on that thread's NUMA node
+struct CPUPoolStrategy
+{
+    static constexpr const char *Name = "cpu_pool";
+
+    explicit CPUPoolStrategy(unsigned threads) :
+        cpus(std::max(1U, std::thread::hardware_concurrency())),
+        capacity(std::max(2U, (threads + cpus - 1) / cpus)),
+        pools(cpus),
+        constructed(std::make_unique<std::once_flag[]>(cpus))
+    {
+    }
+
+    ScalingPool &GetPool()
+    {
+        const unsigned cpu = CurrentCPU() % cpus;
+
+        std::call_once(constructed[cpu],
+                       [&]()
+                       {
+                           pools[cpu] = std::make_unique<ScalingPool>(
+                               capacity,
+                               true,
+                               PoolReturnPolicy::Jump);
+                       });
+
+        return *pools[cpu];
+    }
+
+    struct Worker
+    {
+        explicit Worker(CPUPoolStrategy &strategy) : strategy(strategy) {}
+
+        void Request(std::span<std::uint8_t> octets, ScalingResult &result)
+        {
+            LeaseRequest([&]() -> ScalingPool & { return strategy.GetPool(); },
+                         lease,
+                         remaining,
+                         octets,
+                         result);
+        }
+
+        CPUPoolStrategy &strategy;
+        ScalingPool::Lease lease;
+        unsigned remaining = 0;
+    };
+
+    const unsigned cpus;
+    const unsigned capacity;
+    std::vector<std::unique_ptr<ScalingPool>> pools;
+    std::unique_ptr<std::once_flag[]> constructed;
+};
+
+/*
+ *  ScalingWorker()
+ *
+ *  Description:
+ *      Issue requests using the given strategy until told to stop.
+ *
+ *  Parameters:
+ *      strategy [in]
+ *          The strategy shared by all threads.
+ *
+ *      cpu [in]
+ *          The CPU to which to pin the thread, if pin is true.
+ *
+ *      pin [in]
+ *          True if the thread is to be pinned.
+ *
+ *      ready [in]
+ *          A latch on which to wait once warmed up, so that all threads
+ *          start together.
+ *
+ *      stop [in]
+ *          Set when the thread is to stop.
+ *
+ *      result [out]
+ *          The thread's results.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Only one request in Sample_Interval is timed, as reading the clock
+ *      costs about as much as a request.  The CPU is checked at the same
+ *      time to count migrations.
+ */
+template<typename Strategy>
+void ScalingWorker(Strategy &strategy,
+                   unsigned cpu,
+                   bool pin,
+                   std::latch &ready,
+                   const std::atomic<bool> &stop,
+                   ScalingResult &result)
+{
+    if (pin) PinThread(cpu);
+
+    typename Strategy::Worker worker(strategy);
+    std::array<std::uint8_t, Request_Size> octets;
+
+    for (unsigned i = 0; i < Warmup_Requests; i++)
+    {
+        worker.Request(octets, result);
+    }
+    result.contended = 0;
+
+    PerfCounters counters;
+
+    ready.arrive_and_wait();
+
+    counters.Start();
+    const std::uint64_t switches = ContextSwitches();
+    unsigned last_cpu = CurrentCPU();
+
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        for (unsigned i = 0; i < Sample_Interval - 1; i++)
+        {
+            worker.Request(octets, result);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        worker.Request(octets, result);
+        result.latency.Record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count()));
+
+        const unsigned current_cpu = CurrentCPU();
+        if (current_cpu != last_cpu) result.migrations++;
+        last_cpu = current_cpu;
+
+        result.requests += Sample_Interval;
+    }
+
+    result.context_switches = ContextSwitches() - switches;
+    result.counts = counters.Stop();
+}
+
+/*
+ *  RunScaling()
+ *
+ *  Description:
+ *      Measure one strategy with each number of threads.
+ *
+ *  Parameters:
+ *      cpus [in]
+ *          The CPUs in the order in which threads are assigned to them.
+ *
+ *      thread_counts [in]
+ *          The numbers of threads with which to measure.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Each thread count is measured for Scaling_Duration with a new
+ *      instance of the strategy and new threads.
+ */
+template<typename Strategy>
+void RunScaling(const std::vector<unsigned> &cpus,
+                const std::vector<unsigned> &thread_counts)
+{
+    std::cout << "  " << Strategy::Name << std::endl
+              << "    threads   Mreq/s    MiB/s   p50 ns   p99 ns p99.9 ns"
+              << "  contended migrations switches  cache-miss/KiB"
+              << std::endl;
+
+    for (auto threads : thread_counts)
+    {
+        Strategy strategy(threads);
+        std::vector<ScalingResult> results(threads);
+        std::vector<std::thread> workers;
+        std::latch ready(threads + 1);
+        std::atomic<bool> stop = false;
+
+        for (unsigned t = 0; t < threads; t++)
+        {
+            workers.emplace_back(ScalingWorker<Strategy>,
+                                 std::ref(strategy),
+                                 cpus[t % cpus.size()],
+                                 options.placement != Placement::None,
+                                 std::ref(ready),
+                                 std::cref(stop),
+                                 std::ref(results[t]));
+        }
+
+        ready.arrive_and_wait();
+        const auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(Scaling_Duration);
+        stop = true;
+        for (auto &worker : workers) worker.join();
+        const double elapsed = SecondsSince(start);
+
+        ScalingResult total;
+
+        total.counts.valid.fill(true);
+
+        for (const auto &result : results)
+        {
+            for (std::size_t i = 0; i < PerfCounters::Counter_Count; i++)
+            {
+                total.counts.values[i] += result.counts.values[i];
+                total.counts.valid[i] =
+                    total.counts.valid[i] && result.counts.valid[i];
+            }
+            total.requests += result.requests;
+            total.contended += result.contended;
+            total.migrations += result.migrations;
+            total.context_switches += result.context_switches;
+            total.latency.Merge(result.latency);
+        }
+
+        const double rate = static_cast<double>(total.requests) / elapsed;
+
+        std::cout << std::fixed << std::setprecision(2) << "    "
+                  << std::setw(7) << threads << std::setw(9) << rate / 1e6
+                  << std::setw(9) << std::setprecision(1)
+                  << rate * Request_Size / (1 << 20)
+                  << std::setw(9) << total.latency.GetPercentile(50.0)
+                  << std::setw(9) << total.latency.GetPercentile(99.0)
+                  << std::setw(9) << total.latency.GetPercentile(99.9)
+                  << std::setw(11) << total.contended
+                  << std::setw(11) << total.migrations
+                  << std::setw(9) << total.context_switches;
+        PrintPerKiB(total.counts,
+                    PerfCounters::Cache_Misses,
+                    static_cast<double>(total.requests * Request_Size),
+                    16);
+        std::cout << std::endl;
+    }
+}
+
+/*
+ *  ScalingBenchmark()
+ *
+ *  Description:
+ *      Measure how the throughput and latency of Request_Size-octet
+ *      requests scale with the number of threads for each way of sharing
+ *      generators among threads.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The thread counts are the powers of two up to the maximum, and the
+ *      maximum.  The "contended" column counts requests that found the
+ *      shared generator's mutex held or a pool empty.
+ */
+void ScalingBenchmark()
+{
+    const auto nodes = GetNodes();
+    const auto cpus = PlaceThreads(nodes, options.placement);
+    const unsigned maximum = (options.threads > 0) ?
+                                 options.threads :
+                                 static_cast<unsigned>(cpus.size());
+    std::vector<unsigned> thread_counts;
+
+    for (unsigned threads = 1; threads < maximum; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(maximum);
+
+    std::cout << "  " << nodes.size() << " NUMA node(s), " << cpus.size()
+              << " CPU(s), threads "
+              << ((options.placement == Placement::None) ? "not pinned" :
+                  (options.placement == Placement::Compact) ?
+                      "pinned compactly" :
+                      "pinned spread across nodes")
+              << std::endl;
+
+    RunScaling<InstanceStrategy>(cpus, thread_counts);
+    RunScaling<ThreadLocalStrategy>(cpus, thread_counts);
+    RunScaling<SharedStrategy>(cpus, thread_counts);
+    RunScaling<PoolStrategy>(cpus, thread_counts);
+    RunScaling<CPUPoolStrategy>(cpus, thread_counts);
+}
+
+/*
+ *  EngineKernel()
+ *
+ *  Description:
+ *      Fill octets with values produced by an engine, one step at a time.
+ *
+ *  Parameters:
+ *      engine [in/out]
+ *          The engine.
+ *
+ *      octets [out]
+ *          The octets to fill.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+void EngineKernel(Engine &engine, std::span<std::uint8_t> octets)
+{
+    using Value = typename Engine::result_type;
+
+    for (std::size_t i = 0; i + sizeof(Value) <= octets.size();
+         i += sizeof(Value))
+    {
+        const Value value = engine();
+        std::memcpy(octets.data() + i, &value, sizeof(value));
+    }
+}
+
+/*
+ *  DistributionKernel()
+ *
+ *  Description:
+ *      Fill octets with values drawn from a distribution.
+ *
+ *  Parameters:
+ *      distribution [in/out]
+ *          The distribution.
+ *
+ *      engine [in/out]
+ *          The engine from which the distribution draws.
+ *
+ *      octets [out]
+ *          The octets to fill.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The cost is reported per octet of the values produced.
+ */
+template<typename Distribution>
+void DistributionKernel(Distribution &distribution,
+                        Xoshiro256PlusPlus &engine,
+                        std::span<std::uint8_t> octets)
+{
+    using Value = typename Distribution::result_type;
+
+    for (std::size_t i = 0; i + sizeof(Value) <= octets.size();
+         i += sizeof(Value))
+    {
+        const Value value = distribution(engine);
+        std::memcpy(octets.data() + i, &value, sizeof(value));
+    }
+}
+
+/*
+ *  CyclesBenchmark()
+ *
+ *  Description:
+ *      Measure the cost per octet of the library's kernels, in time and
+ *      (where available) in processor cycles, with the instructions per
+ *      cycle and the cache and branch misses per KiB.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Cycles per octet do not vary with the processor's clock frequency
+ *      as time does, so they compare kernels more precisely on hosts whose
+ *      frequency changes or that are shared.  Each kernel runs on a buffer
+ *      of Kernel_Octets for Kernel_Duration.  The source read includes
+ *      the time spent in the kernel, which is counted in cycles only if
+ *      kernel-mode events may be counted.
+ */
+void CyclesBenchmark()
+{
+    constexpr std::size_t Kernel_Octets = 4096;
+    constexpr std::chrono::milliseconds Kernel_Duration{200};
+    constexpr unsigned Calls_Per_Check = 16;
+
+    // A kernel, which fills the given octets
+    struct Kernel
+    {
+        const char *name;
+        std::function<void(std::span<std::uint8_t>)> run;
+    };
+
+    MT19937 mt19937;
+    Xoshiro256PlusPlus xoshiro256;
+    Xoshiro128PlusPlus xoshiro128;
+    PCG32 pcg32;
+    Philox4x32 philox;
+    std::uint64_t philox_counter = 0;
+    RandomGenerator generator(true);
+    RandomGenerator source_generator;
+    HealthTest health_test;
+    std::vector<std::uint8_t> health_octets(Kernel_Octets);
+    std::uniform_int_distribution<std::uint32_t> uniform_int(0, 999);
+    std::uniform_real_distribution<double> uniform_real;
+    std::normal_distribution<double> normal;
+
+    generator.GetRandomOctets(health_octets);
+
+    const std::vector<Kernel> kernels =
+    {
+        {"mt19937", [&](auto o) { EngineKernel(mt19937, o); }},
+        {"xoshiro256", [&](auto o) { EngineKernel(xoshiro256, o); }},
+        {"xoshiro128", [&](auto o) { EngineKernel(xoshiro128, o); }},
+        {"pcg32", [&](auto o) { EngineKernel(pcg32, o); }},
+        {"philox", [&](auto o) { EngineKernel(philox, o); }},
+        {"philox_fill",
+         [&](auto o)
+         {
+             Philox4x32::FillRange({1, 2}, philox_counter, o);
+             philox_counter += o.size() / Philox4x32::Block_Size;
+         }},
+        {"octets", [&](auto o) { generator.GetRandomOctets(o); }},
+        {"uniform_int",
+         [&](auto o) { DistributionKernel(uniform_int, xoshiro256, o); }},
+        {"uniform_real",
+         [&](auto o) { DistributionKernel(uniform_real, xoshiro256, o); }},
+        {"normal", [&](auto o) { DistributionKernel(normal, xoshiro256, o); }},
+        {"health",
+         [&](auto o)
+         {
+             if (!health_test.Test(health_octets)) health_test.Reset();
+             o[0] = health_octets[0];
+         }},
+        {"source_read", [&](auto o) { source_generator.GetRandomOctets(o); }}
+    };
+
+    PerfCounters counters;
+    std::vector<std::uint8_t> octets(Kernel_Octets);
+
+    std::cout << "  " << counters.Describe() << std::endl
+              << "    kernel          ns/B     GB/s  cycles/B     IPC"
+              << "  cache-miss/KiB  branch-miss/KiB" << std::endl;
+
+    for (const auto &kernel : kernels)
+    {
+        std::uint64_t calls = 0;
+
+        kernel.run(octets);
+
+        counters.Start();
+        const auto start = std::chrono::steady_clock::now();
+        do
+        {
+            for (unsigned i = 0; i < Calls_Per_Check; i++) kernel.run(octets);
+            calls += Calls_Per_Check;
+        } while (SecondsSince(start) <
+                 std::chrono::duration<double>(Kernel_Duration).count());
+        const double elapsed = SecondsSince(start);
+        const PerfCounts counts = counters.Stop();
+
+        const double total = static_cast<double>(calls * Kernel_Octets);
+
+        std::cout << "    " << std::left << std::setw(14) << kernel.name
+                  << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(7) << elapsed * 1e9 / total
+                  << std::setw(9) << std::setprecision(2)
+                  << total / elapsed / 1e9;
+
+        if (counts.valid[PerfCounters::Cycles])
+        {
+            const auto cycles =
+                static_cast<double>(counts.values[PerfCounters::Cycles]);
+
+            std::cout << std::setw(10) << std::setprecision(3)
+                      << cycles / total;
+
+            if (counts.valid[PerfCounters::Instructions] && (cycles > 0))
+            {
+                std::cout << std::setw(8) << std::setprecision(2)
+                          << static_cast<double>(
+                                 counts.values[PerfCounters::Instructions]) /
+                                 cycles;
+            }
+            else
+            {
+                std::cout << std::setw(8) << "-";
+            }
+        }
+        else
+        {
+            std::cout << std::setw(10) << "-" << std::setw(8) << "-";
+        }
+
+        PrintPerKiB(counts, PerfCounters::Cache_Misses, total, 16);
+        PrintPerKiB(counts, PerfCounters::Branch_Misses, total, 17);
+        std::cout << std::endl;
+    }
+}
+
+// All benchmarks in the order they are run
+constexpr std::array<Benchmark, 5> Benchmarks =
+{{
+    {"jitter", "JitterSource startup cost and throughput", JitterBenchmark},
+    {"latency", "Latency of 16-octet source reads and seed pool refills",
+     LatencyBenchmark},
+    {"health", "Cost of the health tests relative to a seed pool refill",
+     HealthBenchmark},
+    {"scaling", "Multithreaded scaling of ways to share generators",
+     ScalingBenchmark},
+    {"cycles", "Cycles per octet of the library's kernels", CyclesBenchmark}
+}};
+
+/*
+ *  Usage()
+ *
+ *  Description:
+ *      Print the program usage.
+ *
+ *  Parameters:
+ *      program [in]
+ *          The name of the program.
+ *
+ *  Returns:
+ *      The program's exit code.
+ *
+ *  Comments:
+ *      None.
+ */
+int Usage(const std::string &program)
+{
+    std::cerr << "Usage: " << program
+              << " [-t threads] [-p compact|spread] [benchmark ...]"
+              << std::endl
+              << std::endl
+              << "Benchmarks:" << std::endl;
+
+    for (const auto &benchmark : Benchmarks)
+    {
+        std::cerr << "  " << std::left << std::setw(12) << benchmark.name
+                  << benchmark.description << std::endl;
+    }
+
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::vector<const Benchmark *> selected;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string name = argv[i];
+        const Benchmark *found = nullptr;
+
+        if ((name == "-t") || (name == "-p"))
+        {
+            if (i + 1 >= argc) return Usage(argv[0]);
+
+            const std::string value = argv[++i];
+
+            if (name == "-t")
+            {
+                const unsigned long threads =
+                    std::strtoul(value.c_str(), nullptr, 10);
+
+                if ((threads == 0) || (threads > 4096)) return Usage(argv[0]);
+                options.threads = static_cast<unsigned>(threads);
+            }
+            else if (value == "compact")
+            {
+                options.placement = Placement::Compact;
+            }
+            else if (value == "spread")
+            {
+                options.placement = Placement::Spread;
+            }
+            else
+            {
+                return Usage(argv[0]);
+            }
+
+            continue;
+        }
+
+        for (const auto &benchmark : Benchmarks)
+        {
+            if (name == benchmark.name) found = &benchmark;
+        }
+
+        if (found == nullptr) return Usage(argv[0]);
+
+        selected.push_back(found);
+    }
+
+    if (selected.empty())
+    {
+        for (const auto &benchmark : Benchmarks) selected.push_back(&benchmark);
+    }
+
+    for (const auto *benchmark : selected)
+    {
+        std::cout << benchmark->name << ": " << benchmark->description
+                  << std::endl;
+        benchmark->run();
+    }
+
+    return 0;
+}
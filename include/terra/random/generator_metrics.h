@@ -0,0 +1,146 @@
+/*
+ *  generator_metrics.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the GeneratorCounters structure, the
+ *      LatencyHistogram object, and the functions that report how the
+ *      library's generators behave.
+ *
+ *      Each thread updates its own counters without synchronization
+ *      (other than relaxed atomic operations, which are ordinary loads and
+ *      stores on common processors), so counting adds only a few
+ *      instructions to each operation.  GetGeneratorCounters() sums the
+ *      counters of all threads, including threads that have exited.  The
+ *      counters are read individually, so a snapshot taken while other
+ *      threads are running may reflect an operation in some counters but
+ *      not yet in others.
+ *
+ *      Reading the clock costs more than the rest of a small request, so
+ *      the time spent reading random sources is measured only after
+ *      SetGeneratorTiming(true) is called.  Refills of the seed pool are
+ *      rare and slow, so they are always timed.
+ *
+ *      The latencies are recorded in log-linear histograms, in the manner
+ *      of HdrHistogram: each power of two is divided into Sub_Bucket_Count
+ *      linear buckets, so a latency is known to within 1/Sub_Bucket_Count
+ *      (6.25%) of its value, from 1 ns up to Max_Latency (about 34 s), and
+ *      recording one takes a few instructions.  Each bucket holds latencies
+ *      greater than the limit of the prior bucket and no greater than its
+ *      own limit (see GetBucketLimit()).  The maximum is recorded exactly.
+ *      GetPercentile() reports the limit of the bucket holding the given
+ *      percentile (e.g., 99.9), so it overstates by at most one bucket.
+ *
+ *      WritePrometheusMetrics() renders a snapshot in the Prometheus text
+ *      exposition format (version 0.0.4) without allocating memory, so it
+ *      may be called from a metrics endpoint's request handler.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <bit>
+#include <span>
+
+namespace Terra::Random
+{
+
+struct GeneratorCounters
+{
+    std::uint64_t octets_served;        // Octets returned by generators
+    std::uint64_t source_octets;        // Octets read from random sources
+    std::uint64_t system_calls;         // System calls to read sources
+    std::uint64_t short_reads;          // Reads producing too few octets
+    std::uint64_t fallbacks;            // Requests needing a later source
+    std::uint64_t reseeds;              // Calls to Reseed()
+    std::uint64_t pool_refills;         // Refills of the seed pool
+    std::uint64_t health_failures;      // Reads failing the health tests
+    std::uint64_t sources_disabled;     // Sources disabled after failures
+    std::uint64_t source_nanoseconds;   // Time reading random sources
+};
+
+struct GeneratorMetrics;
+GeneratorMetrics GetGeneratorMetrics();
+
+class LatencyHistogram
+{
+    public:
+        static constexpr unsigned Sub_Bucket_Bits = 4;
+        static constexpr std::uint64_t Sub_Bucket_Count =
+            std::uint64_t{1} << Sub_Bucket_Bits;
+        static constexpr std::uint64_t Max_Latency = std::uint64_t{1} << 35;
+        static constexpr std::size_t Bucket_Count = 512;
+
+        static constexpr std::size_t GetBucket(
+                                    std::uint64_t nanoseconds) noexcept
+        {
+            // Bucket 0 holds 0 and 1, so that limits are powers of two
+            const std::uint64_t value = nanoseconds - (nanoseconds != 0);
+
+            if (value >= Max_Latency) return Bucket_Count - 1;
+
+            const unsigned shift = static_cast<unsigned>(
+                std::bit_width(value | Sub_Bucket_Count) -
+                (Sub_Bucket_Bits + 1));
+
+            return (std::size_t{shift} << Sub_Bucket_Bits) +
+                   static_cast<std::size_t>(value >> shift);
+        }
+        static constexpr std::uint64_t GetBucketLimit(
+                                            std::size_t bucket) noexcept
+        {
+            if (bucket >= Bucket_Count - 1) return ~std::uint64_t{0};
+
+            const unsigned octave =
+                static_cast<unsigned>(bucket >> Sub_Bucket_Bits);
+            const unsigned shift = (octave > 0) ? octave - 1 : 0;
+            const std::uint64_t sub_bucket =
+                bucket - (std::size_t{shift} << Sub_Bucket_Bits);
+
+            return (sub_bucket + 1) << shift;
+        }
+
+        void Record(std::uint64_t nanoseconds) noexcept;
+        void Merge(const LatencyHistogram &other) noexcept;
+
+        std::uint64_t GetCount() const noexcept;
+        std::uint64_t GetSum() const noexcept { return sum; }
+        std::uint64_t GetMaximum() const noexcept { return maximum; }
+        std::uint64_t GetPercentile(double percentile) const noexcept;
+        std::uint64_t GetBucketCount(std::size_t bucket) const noexcept
+        {
+            return buckets[bucket];
+        }
+
+    protected:
+        friend GeneratorMetrics GetGeneratorMetrics();
+
+        std::array<std::uint64_t, Bucket_Count> buckets{};
+        std::uint64_t sum = 0;
+        std::uint64_t maximum = 0;
+};
+
+struct GeneratorMetrics
+{
+    GeneratorCounters counters;
+    LatencyHistogram source_latency;    // Reads of the random sources
+    LatencyHistogram refill_latency;    // Refills of the seed pool
+};
+
+GeneratorCounters GetGeneratorCounters();
+void SetGeneratorTiming(bool enabled) noexcept;
+std::size_t WritePrometheusMetrics(const GeneratorMetrics &metrics,
+                                   std::span<char> buffer) noexcept;
+
+} // namespace Terra::Random
@@ -0,0 +1,73 @@
+/*
+ *  generator_state.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the GeneratorStateView object, which is a
+ *      read-only view of the saved state of a BasicRandomGenerator.  The view
+ *      does not copy the saved state, so it may be used directly on a
+ *      memory-mapped checkpoint file.
+ *
+ *      The saved state has the following binary format, with all integers
+ *      in little-endian order:
+ *
+ *          Offset  Size  Field
+ *          0       4     Magic value "TRNG"
+ *          4       2     Format version (1)
+ *          6       2     Engine identifier (Engine::Engine_Id)
+ *          8       4     Flags (bit 0: pseudo_random_only)
+ *          12      4     Size of the engine state
+ *          16      8     Distribution minimum
+ *          24      8     Distribution maximum
+ *          32      n     Engine state (Engine::SaveState())
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace Terra::Random
+{
+
+class GeneratorStateView
+{
+    public:
+        static constexpr std::uint16_t Version = 1;
+        static constexpr std::size_t Header_Size = 32;
+        static constexpr std::uint32_t Pseudo_Random_Only_Flag = 0x01;
+
+        GeneratorStateView(std::span<const std::uint8_t> octets) noexcept;
+
+        bool IsValid() const noexcept { return valid; }
+        std::uint16_t GetVersion() const noexcept;
+        std::uint16_t GetEngineId() const noexcept;
+        std::uint32_t GetFlags() const noexcept;
+        std::uint64_t GetDistributionMin() const noexcept;
+        std::uint64_t GetDistributionMax() const noexcept;
+        std::span<const std::uint8_t> GetEngineState() const noexcept;
+        std::size_t Size() const noexcept;
+
+        static void WriteHeader(std::span<std::uint8_t> octets,
+                                std::uint16_t engine_id,
+                                std::uint32_t flags,
+                                std::uint32_t engine_state_size,
+                                std::uint64_t distribution_min,
+                                std::uint64_t distribution_max) noexcept;
+
+    protected:
+        std::span<const std::uint8_t> octets;
+        bool valid;
+};
+
+} // namespace Terra::Random
@@ -0,0 +1,77 @@
+/*
+ *  health_test.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the HealthTest object, which performs the
+ *      continuous health tests of NIST SP 800-90B (section 4.4) on a
+ *      stream of octets: the Repetition Count Test (RCT) and the Adaptive
+ *      Proportion Test (APT).  The library applies these to all octets read
+ *      from the random sources, with separate state for each thread and
+ *      source.
+ *
+ *      Each octet is treated as a sample with an assessed min-entropy of
+ *      8 bits (as the sources' output is conditioned), and the cutoffs are
+ *      chosen for a false positive probability of at most 2^-40 (2^-40 per
+ *      octet for the RCT and about 2^-40.9 per window for the APT):
+ *
+ *          - The RCT fails if RCT_Cutoff consecutive octets are identical.
+ *          - The APT fails if, in a window of APT_Window octets, the first
+ *            octet occurs APT_Cutoff or more times.
+ *
+ *      The state of both tests carries over from one call to Test() to the
+ *      next, so the octets may be tested in pieces of any size.  On x86
+ *      processors, 16 or 32 octets are tested at a time with SSE2 or AVX2
+ *      instructions, and both tests are applied in a single pass over each
+ *      complete APT window.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace Terra::Random
+{
+
+class HealthTest
+{
+    public:
+        static constexpr unsigned RCT_Cutoff = 6;
+        static constexpr std::size_t APT_Window = 512;
+        static constexpr unsigned APT_Cutoff = 20;
+
+        constexpr HealthTest() noexcept = default;
+        ~HealthTest() = default;
+
+        bool Test(std::span<const std::uint8_t> octets) noexcept;
+        void Reset() noexcept;
+
+    protected:
+        bool TestWindows(std::span<const std::uint8_t> octets) noexcept;
+        bool TestRepetition(std::span<const std::uint8_t> octets) noexcept;
+        bool TestProportion(std::span<const std::uint8_t> octets) noexcept;
+        bool ContinueRun(std::span<const std::uint8_t> octets) noexcept;
+        void SaveRun(std::span<const std::uint8_t> octets) noexcept;
+
+        // Repetition Count Test state
+        std::uint8_t rct_octet = 0;
+        unsigned rct_count = 0;
+
+        // Adaptive Proportion Test state
+        std::uint8_t apt_octet = 0;
+        std::size_t apt_position = 0;
+        unsigned apt_count = 0;
+};
+
+} // namespace Terra::Random
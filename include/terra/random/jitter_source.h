@@ -0,0 +1,99 @@
+/*
+ *  jitter_source.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the JitterSource object, which produces
+ *      random octets from variations in the time the processor takes to
+ *      execute a loop of memory accesses, in the manner of the jitterentropy
+ *      library used by the Linux kernel.  The variations arise from caches,
+ *      pipelines, interrupts, and other activity on the system, so no
+ *      operating system random source or special instruction is needed.
+ *
+ *      This is slow (on the order of tens of kilobytes per second) and is
+ *      intended only as a last-resort seed source (e.g., in sandboxes where
+ *      the operating system's random sources cannot be opened).  The seed
+ *      pool shared by the generators uses it for any octets the operating
+ *      system's sources do not provide.
+ *
+ *      Each sample is the time taken by one loop of memory accesses.  A
+ *      sample is "stuck" if it or its first or second difference from the
+ *      prior samples is zero, as such samples are assumed to contain no
+ *      entropy.  Each 64 bits of output are produced by hashing at least
+ *      Oversampling * 64 samples that are not stuck.
+ *
+ *      The following health tests are performed:
+ *
+ *          - When constructed, Startup_Samples samples are taken, and the
+ *            source is unhealthy if the timer does not advance, runs
+ *            backward more than rarely, if nine in ten samples are stuck,
+ *            or if Stuck_Cutoff consecutive samples are stuck.
+ *          - While producing output, the source becomes unhealthy if
+ *            Stuck_Cutoff consecutive samples are stuck (a repetition
+ *            count test).
+ *
+ *      An unhealthy source produces no output.
+ *
+ *  Portability Issues:
+ *      The processor's time stamp counter is used on x86 processors.
+ *      Elsewhere, std::chrono::steady_clock is used, whose resolution may
+ *      be too coarse, in which case the source is unhealthy.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <span>
+
+namespace Terra::Random
+{
+
+class JitterSource
+{
+    public:
+        static constexpr std::size_t Memory_Size = 64 * 1024;
+        static constexpr std::size_t Memory_Stride = 4093;
+        static constexpr unsigned Memory_Accesses = 128;
+        static constexpr unsigned Oversampling = 3;
+        static constexpr unsigned Startup_Samples = 1024;
+        static constexpr unsigned Stuck_Cutoff = 60;
+
+        JitterSource();
+        JitterSource(const JitterSource &) = delete;
+        ~JitterSource() = default;
+        JitterSource &operator=(const JitterSource &) = delete;
+
+        bool IsHealthy() const noexcept { return healthy; }
+        std::size_t Read(std::span<std::uint8_t> buffer) noexcept;
+
+    protected:
+        // Function reading the timer (replaceable for testing)
+        using Timer = std::uint64_t (*)() noexcept;
+
+        explicit JitterSource(Timer timer);
+
+        std::uint64_t Sample() noexcept;
+        bool IsStuck(std::uint64_t delta) noexcept;
+        bool Generate(std::uint64_t &value) noexcept;
+
+        const Timer timer;
+        std::vector<std::uint8_t> memory;
+        std::size_t memory_position;
+        std::uint64_t last_time;
+        std::uint64_t last_delta;
+        std::uint64_t last_delta2;
+        unsigned stuck_count;
+        std::array<std::uint64_t, 2> key;
+        bool healthy;
+};
+
+} // namespace Terra::Random
@@ -0,0 +1,95 @@
+/*
+ *  mt19937.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the MT19937 object.  This is the 32-bit
+ *      Mersenne Twister and it produces exactly the same sequence as
+ *      std::mt19937 for the same seed.  Unlike std::mt19937, the state
+ *      is advanced one word at a time, which allows the engine to be
+ *      advanced by an arbitrary number of steps in logarithmic time using
+ *      a polynomial jump (see Discard(), Jump(), and LongJump()).
+ *
+ *      The engine state may be saved to and loaded from a fixed-size octet
+ *      array (see SaveState() and LoadState()).
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+
+namespace Terra::Random
+{
+
+class MT19937
+{
+    public:
+        using result_type = std::uint32_t;
+        static constexpr std::size_t State_Size = 624;
+        static constexpr result_type Default_Seed = 5489U;
+        static constexpr std::uint16_t Engine_Id = 1;
+        static constexpr std::size_t Saved_State_Size = 4 * State_Size + 4;
+
+        MT19937(result_type seed = Default_Seed) noexcept;
+        MT19937(std::span<const std::uint32_t> seed_data);
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept { return 0xffff'ffff; }
+
+        void Seed(result_type seed) noexcept;
+        void Seed(std::span<const std::uint32_t> seed_data);
+
+        // Produce the next value in the sequence
+        result_type operator()() noexcept
+        {
+            constexpr std::uint32_t Upper_Mask = 0x8000'0000;
+            constexpr std::uint32_t Lower_Mask = 0x7fff'ffff;
+            constexpr std::uint32_t Matrix_A = 0x9908'b0df;
+
+            std::size_t next = (index + 1 == State_Size) ? 0 : index + 1;
+            std::size_t middle = (index + 397 >= State_Size) ?
+                                     index + 397 - State_Size :
+                                     index + 397;
+
+            std::uint32_t y = (state[index] & Upper_Mask) |
+                              (state[next] & Lower_Mask);
+            y = state[middle] ^ (y >> 1) ^ ((y & 1) ? Matrix_A : 0);
+            state[index] = y;
+            index = next;
+
+            // Temper the value
+            y ^= (y >> 11);
+            y ^= (y << 7) & 0x9d2c'5680;
+            y ^= (y << 15) & 0xefc6'0000;
+            y ^= (y >> 18);
+
+            return y;
+        }
+
+        void Discard(std::uint64_t count);
+        void Jump();
+        void LongJump();
+
+        void SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept;
+        bool LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept;
+
+    protected:
+        std::array<std::uint32_t, State_Size> state;
+        std::size_t index;
+};
+
+} // namespace Terra::Random
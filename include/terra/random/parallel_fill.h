@@ -0,0 +1,48 @@
+/*
+ *  parallel_fill.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the ParallelFill() function, which fills
+ *      a large buffer with pseudo-random octets using multiple threads.
+ *
+ *      The buffer is divided into fixed-size chunks, each of which is
+ *      produced from the Philox4x32 counter-based engine starting at the
+ *      counter corresponding to the chunk's offset.  Chunks are scheduled
+ *      on a set of worker threads that steal work from one another, but
+ *      since each chunk's content depends only on its position, the
+ *      result is identical for a given seed regardless of the number of
+ *      threads or the order in which chunks are produced.  Specifically,
+ *      the result is the same as that of Philox4x32::FillRange() with a
+ *      key formed from the seed (the same key used by Philox4x32::Seed())
+ *      and a first counter of zero.
+ *
+ *      A first block counter may be given to fill a buffer with a segment
+ *      of a longer sequence, so a sequence too large to hold in memory may
+ *      be produced one segment at a time.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace Terra::Random
+{
+
+void ParallelFill(std::span<std::uint8_t> octets,
+                  unsigned threads,
+                  std::uint64_t seed,
+                  std::uint64_t first_block = 0);
+
+} // namespace Terra::Random
@@ -0,0 +1,84 @@
+/*
+ *  pcg32.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the PCG32 object.  This is the PCG-XSH-RR
+ *      engine by Melissa O'Neill with 64 bits of state and 32-bit output.
+ *      Since the underlying engine is a linear congruential generator, it
+ *      can be advanced by an arbitrary number of steps in logarithmic time
+ *      (see Discard()).  Jump() and LongJump() advance the engine by 2^48
+ *      and 2^56 steps, respectively, to split the 2^64 period into
+ *      non-overlapping sub-sequences.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace Terra::Random
+{
+
+class PCG32
+{
+    public:
+        using result_type = std::uint32_t;
+        static constexpr std::uint64_t Default_Seed = 0x853c'49e6'748f'ea9b;
+        static constexpr std::uint64_t Default_Stream = 0x6d1f'1ce5'ca5c'daed;
+        static constexpr std::uint16_t Engine_Id = 3;
+        static constexpr std::size_t Saved_State_Size = 16;
+
+        PCG32(std::uint64_t seed = Default_Seed,
+              std::uint64_t stream = Default_Stream) noexcept;
+        PCG32(std::span<const std::uint32_t> seed_data);
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept { return 0xffff'ffff; }
+
+        void Seed(std::uint64_t seed,
+                  std::uint64_t stream = Default_Stream) noexcept;
+        void Seed(std::span<const std::uint32_t> seed_data);
+
+        // Produce the next value in the sequence
+        result_type operator()() noexcept
+        {
+            const std::uint64_t old_state = state;
+
+            state = old_state * Multiplier + increment;
+
+            const auto xor_shifted = static_cast<std::uint32_t>(
+                ((old_state >> 18) ^ old_state) >> 27);
+            const auto rotation = static_cast<unsigned>(old_state >> 59);
+
+            return (xor_shifted >> rotation) |
+                   (xor_shifted << ((32 - rotation) & 31));
+        }
+
+        void Discard(std::uint64_t count) noexcept;
+        void Jump() noexcept;
+        void LongJump() noexcept;
+
+        void SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept;
+        bool LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept;
+
+    protected:
+        static constexpr std::uint64_t Multiplier = 6'364'136'223'846'793'005;
+
+        std::uint64_t state;
+        std::uint64_t increment;
+};
+
+} // namespace Terra::Random
@@ -0,0 +1,101 @@
+/*
+ *  philox.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the Philox4x32 object.  This is the
+ *      Philox4x32-10 counter-based engine by Salmon, et al. ("Parallel
+ *      Random Numbers: As Easy as 1, 2, 3").  Each 128-bit counter value is
+ *      mapped through a keyed bijection to a block of four 32-bit values,
+ *      so any position in the sequence may be computed directly without
+ *      producing the values that precede it.
+ *
+ *      At() returns the block for a given key and counter, and FillRange()
+ *      fills a span of octets with the sequence starting at a given block
+ *      counter.  Octet i of the sequence is octet (i % 16) of the block at
+ *      counter (i / 16), with each 32-bit value serialized in little-endian
+ *      order.  Thus, filling any sub-range of a large buffer produces the
+ *      same octets regardless of how the buffer is divided among threads.
+ *      FillRange() uses SIMD instructions (SSE2 or AVX2) when available.
+ *
+ *      The object may also be used as a sequential engine, in which case
+ *      Discard(), Jump() and LongJump() simply advance the counter.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+
+namespace Terra::Random
+{
+
+class Philox4x32
+{
+    public:
+        using result_type = std::uint32_t;
+        using Key = std::array<std::uint32_t, 2>;
+        using Counter = std::array<std::uint32_t, 4>;
+        using Block = std::array<std::uint32_t, 4>;
+        static constexpr std::uint64_t Default_Seed = 0;
+        static constexpr std::size_t Block_Size = 16;
+        static constexpr std::uint16_t Engine_Id = 4;
+        static constexpr std::size_t Saved_State_Size = 44;
+
+        Philox4x32(std::uint64_t seed = Default_Seed) noexcept;
+        Philox4x32(std::span<const std::uint32_t> seed_data);
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept { return 0xffff'ffff; }
+
+        void Seed(std::uint64_t seed) noexcept;
+        void Seed(std::span<const std::uint32_t> seed_data);
+
+        // Produce the next value in the sequence
+        result_type operator()() noexcept
+        {
+            if (position >= block.size())
+            {
+                block = At(key, counter);
+                Increment(counter, 1);
+                position = 0;
+            }
+
+            return block[position++];
+        }
+
+        void Discard(std::uint64_t count) noexcept;
+        void Jump() noexcept;
+        void LongJump() noexcept;
+
+        void SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept;
+        bool LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept;
+
+        static Block At(const Key &key, const Counter &counter) noexcept;
+        static void FillRange(const Key &key,
+                              std::uint64_t first_counter,
+                              std::span<std::uint8_t> octets) noexcept;
+
+    protected:
+        static void Increment(Counter &value, std::uint64_t count) noexcept;
+
+        Key key;
+        Counter counter;
+        Block block;
+        std::size_t position;
+};
+
+} // namespace Terra::Random
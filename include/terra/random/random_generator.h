@@ -12,17 +12,75 @@
  *      Header file that defines the RandomGenerator object.  This object will
  *      generate random numbers from one or two entropy sources.
  *
+ *      RandomGenerator is the BasicRandomGenerator template using the MT19937
+ *      engine.  Other engines may be selected by using BasicRandomGenerator
+ *      directly with one of the engines for which the template is
+ *      instantiated: MT19937, Xoshiro256PlusPlus, Xoshiro128PlusPlus, PCG32,
+ *      or Philox4x32.
+ *
+ *      The MT19937 engine holds about 2.5 KB of state.  Applications that
+ *      hold a very large number of generators (e.g., one per session) should
+ *      use CompactRandomGenerator, which uses the Xoshiro128PlusPlus engine
+ *      is no larger than a 64-octet cache line.  The members are ordered
+ *      to avoid padding for that reason.  The type is not aligned to a
+ *      cache line, so a generator that must not straddle two lines (or
+ *      share one with other data) should be placed accordingly (as
+ *      BasicRandomGeneratorPool does).
+ *
  *      If the constructor's pseudo_random_only argument is true, this object
- *      will generate random octets using C++'s std::mt19937 PRNG.
+ *      will generate random octets using the engine's PRNG.  The default
+ *      MT19937 engine produces the same sequence as C++'s std::mt19937.
+ *
+ *      The operating system's random sources are opened once and shared by
+ *      all generators in the process, and the full state of each
+ *      generator's PRNG is seeded from 256 bits taken from a shared pool of
+ *      octets read from those sources in bulk, so constructing a generator
+ *      usually requires no system calls.
  *
  *      If the constructor's pseudo_random_only argument is false (default),
- *      the object will first read random octets from the operating system's
- *      random sources (and pseudo-random sources as a fallback, if available).
+ *      the object will first read random octets from the chain of random
+ *      sources probed once per process (see random_source.h), such as the
+ *      getrandom() system call or the processor's RDRAND instruction.
+ *      GetLastSource() reports which source served the most recent request.
  *      In addition, it will then XOR those operating-system provided random
- *      octets with octets from C++'s std::mt19937 PRNG.  This will provide
- *      a greater degree of randomness in case one of the two sources has
+ *      octets with octets from the engine's PRNG.  This will provide a
+ *      greater degree of randomness in case one of the two sources has
  *      low entropy.
  *
+ *      GetRandomOctets() uses whatever octets the sources produce in one
+ *      read from each, so should every source fail (e.g., be interrupted
+ *      by a signal), some octets come only from the PRNG.
+ *      FillRandomOctets() instead retries each source that is interrupted,
+ *      temporarily unavailable, or produces too few octets, for up to the
+ *      given time budget, before moving on to the next source.  If the
+ *      octets cannot all be read from the sources, it throws
+ *      std::system_error (or sets the given error code and clears the
+ *      octets).  When the first read succeeds, it costs no more than
+ *      GetRandomOctets().
+ *
+ *      Reseed() reseeds the PRNG's full state (e.g., before a generator is
+ *      reused for an unrelated purpose).  The seed is taken from the shared
+ *      seed pool and, on processors that support RDRAND, the processor's
+ *      output is XORed into it as an additional input.
+ *
+ *      When using only the PRNG, the generator may be seeded explicitly
+ *      via Seed() to produce a reproducible sequence.  Constructing the
+ *      object with seed data does the same without consuming any entropy
+ *      from the operating system (see also StreamKey).  Each pseudo-random
+ *      octet consumes one value from the engine, so Discard() may be used
+ *      to skip ahead by a given number of octets in logarithmic time, and
+ *      Jump() or LongJump() may be used to split one seeded sequence into
+ *      non-overlapping sub-sequences (e.g., one per thread).
+ *
+ *      A generator may be moved (e.g., into a container or a pool), but not
+ *      copied, since a copy would produce the same sequence as the original.
+ *      A moved-from generator may only be destroyed or assigned.
+ *
+ *      The state of the PRNG may be saved with SaveState() and restored
+ *      with LoadState() (e.g., for checkpointing).  The saved state is a
+ *      compact, versioned binary format (see generator_state.h) that may be
+ *      loaded directly from a memory-mapped file without copying.
+ *
  *  Portability Issues:
  *      None.
  */
@@ -34,32 +92,98 @@
 #include <vector>
 #include <cstddef>
 #include <span>
+#include <chrono>
+#include <system_error>
+#include "mt19937.h"
+#include "xoshiro.h"
+#include "pcg32.h"
+#include "philox.h"
+#include "generator_state.h"
+#include "random_source.h"
 
 namespace Terra::Random
 {
 
-class RandomGenerator
+class OSSource;
+
+template<typename Engine>
+class BasicRandomGeneratorPool;
+
+template<typename Engine>
+class BasicRandomGenerator
 {
     public:
-        RandomGenerator(bool pseudo_random_only = false);
-        ~RandomGenerator();
+        // Number of 32-bit words of seed data used to seed the engine
+        static constexpr std::size_t Seed_Words = 8;
+        static constexpr std::size_t Saved_State_Size =
+            GeneratorStateView::Header_Size + Engine::Saved_State_Size;
+        static constexpr std::chrono::microseconds Default_Fill_Budget{
+            10'000};
+
+        BasicRandomGenerator(bool pseudo_random_only = false);
+        explicit BasicRandomGenerator(
+                                    std::span<const std::uint32_t> seed_data);
+        BasicRandomGenerator(const BasicRandomGenerator &) = delete;
+        BasicRandomGenerator(BasicRandomGenerator &&) noexcept = default;
+        ~BasicRandomGenerator();
+        BasicRandomGenerator &operator=(const BasicRandomGenerator &) =
+            delete;
+        BasicRandomGenerator &operator=(BasicRandomGenerator &&) noexcept =
+            default;
+
         std::uint8_t GetRandomOctet() noexcept;
         std::vector<std::uint8_t> GetRandomOctets(std::size_t count);
         void GetRandomOctets(std::span<std::uint8_t> octets) noexcept;
+        void FillRandomOctets(
+            std::span<std::uint8_t> octets,
+            std::chrono::microseconds budget = Default_Fill_Budget);
+        void FillRandomOctets(
+            std::span<std::uint8_t> octets,
+            std::error_code &error,
+            std::chrono::microseconds budget = Default_Fill_Budget) noexcept;
+        void Seed(std::span<const std::uint32_t> seed_data);
+        void Reseed();
+        void Discard(std::uint64_t count);
+        void Jump();
+        void LongJump();
+        std::size_t SaveState(std::span<std::uint8_t> octets) const noexcept;
+        std::vector<std::uint8_t> SaveState() const;
+        bool LoadState(std::span<const std::uint8_t> octets) noexcept;
+        bool LoadState(const GeneratorStateView &state) noexcept;
+        RandomSource GetLastSource() const noexcept { return last_source; }
 
     protected:
+        friend class BasicRandomGeneratorPool<Engine>;
+
+        void Reseed(std::span<const std::uint32_t> seed_data) noexcept;
         std::uint8_t GetPseudoRandomOctet();
         std::size_t SourceRandomOctets(
-                                std::span<std::uint8_t> buffer) const noexcept;
+                                    std::span<std::uint8_t> buffer) noexcept;
 
+        OSSource *os_source = nullptr;
+        Engine random_engine;
+        std::uniform_int_distribution<typename Engine::result_type>
+            distribution;
         bool pseudo_random_only;
-        std::uniform_int_distribution<std::mt19937::result_type> distribution;
-        std::mt19937 random_engine;
-
-#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-        int random_fd;
-        int pseudo_random_fd;
-#endif
+        RandomSource last_source;
 };
 
+// The engines for which BasicRandomGenerator is instantiated
+extern template class BasicRandomGenerator<MT19937>;
+extern template class BasicRandomGenerator<Xoshiro256PlusPlus>;
+extern template class BasicRandomGenerator<Xoshiro128PlusPlus>;
+extern template class BasicRandomGenerator<PCG32>;
+extern template class BasicRandomGenerator<Philox4x32>;
+
+// The default random generator
+using RandomGenerator = BasicRandomGenerator<MT19937>;
+
+// A random generator with a small state no larger than a cache line
+using CompactRandomGenerator = BasicRandomGenerator<Xoshiro128PlusPlus>;
+static_assert(sizeof(CompactRandomGenerator) <= 64,
+              "CompactRandomGenerator must be no larger than a cache line");
+static_assert(sizeof(BasicRandomGenerator<PCG32>) <= 64,
+              "BasicRandomGenerator<PCG32> must be no larger than a cache "
+              "line");
+
 } // namespace Terra::Random
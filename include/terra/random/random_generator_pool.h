@@ -0,0 +1,170 @@
+/*
+ *  random_generator_pool.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the BasicRandomGeneratorPool object, which
+ *      holds a fixed number of pre-seeded generators that may be checked out
+ *      (e.g., one per connection) and returned, so that a generator need not
+ *      be constructed for each use.
+ *
+ *      Checkout() and the return of a generator are lock-free: the free
+ *      generators are kept on a stack whose head holds a version tag to
+ *      prevent the ABA problem.  The pool's memory is allocated once when
+ *      the pool is constructed.  Each generator and each link of the stack
+ *      occupies its own cache lines, so generators leased to different
+ *      threads do not share a cache line.  If all generators are checked
+ *      out, Checkout() constructs a temporary generator that is destroyed
+ *      (not pooled) when returned, so memory use remains bounded.  That
+ *      construction takes its seed from the process-wide seed pool, which
+ *      requires a lock.
+ *
+ *      When a generator is returned, it is either reseeded (the default)
+ *      or advanced with Jump().  Each pooled generator keeps a reserve of
+ *      Reserved_Seeds seeds, read from the random sources without taking
+ *      the process-wide seed pool's lock, so reseeding on return is
+ *      lock-free except in the rare case that the sources fail to produce
+ *      enough octets and the shared seed pool is used.  Reseeding ensures
+ *      that the next user of the generator never receives a sequence
+ *      related to that received by the previous user.  Jump() is
+ *      deterministic, so it only separates the users' sequences
+ *      statistically: a previous user who learned the generator's state
+ *      (e.g., by seeding it) can compute the sequence the next user will
+ *      receive.  The Jump policy is therefore unsuitable when the users of
+ *      a pool do not trust one another.  Jump() is inexpensive for all
+ *      engines except MT19937, whose jump takes milliseconds.
+ *
+ *      A Lease returns its generator to the pool when destroyed, so the
+ *      pool must outlive all leases.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+#include "random_generator.h"
+
+namespace Terra::Random
+{
+
+// Action taken on a generator as it is returned to the pool
+enum class PoolReturnPolicy
+{
+    Reseed,
+    Jump
+};
+
+template<typename Engine>
+class BasicRandomGeneratorPool
+{
+    public:
+        using Generator = BasicRandomGenerator<Engine>;
+
+        // Number of seeds each pooled generator keeps for reseeding
+        static constexpr std::size_t Reserved_Seeds = 4;
+
+        // Handle to a checked-out generator that returns it when destroyed
+        class Lease
+        {
+            public:
+                Lease() noexcept = default;
+                Lease(const Lease &) = delete;
+                Lease(Lease &&other) noexcept;
+                ~Lease();
+                Lease &operator=(const Lease &) = delete;
+                Lease &operator=(Lease &&other) noexcept;
+
+                Generator &operator*() const noexcept { return *generator; }
+                Generator *operator->() const noexcept { return generator; }
+                bool IsPooled() const noexcept { return pool != nullptr; }
+                void Return() noexcept;
+
+            protected:
+                friend class BasicRandomGeneratorPool;
+
+                Lease(BasicRandomGeneratorPool *pool,
+                      std::uint32_t slot,
+                      std::unique_ptr<Generator> overflow) noexcept;
+
+                BasicRandomGeneratorPool *pool = nullptr;
+                std::uint32_t slot = 0;
+                std::unique_ptr<Generator> overflow;
+                Generator *generator = nullptr;
+        };
+
+        BasicRandomGeneratorPool(
+                        std::size_t capacity,
+                        bool pseudo_random_only = false,
+                        PoolReturnPolicy policy = PoolReturnPolicy::Reseed);
+        BasicRandomGeneratorPool(const BasicRandomGeneratorPool &) = delete;
+        ~BasicRandomGeneratorPool() = default;
+        BasicRandomGeneratorPool &operator=(const BasicRandomGeneratorPool &) =
+            delete;
+
+        Lease Checkout();
+        std::size_t Capacity() const noexcept { return slots.size(); }
+
+    protected:
+        static constexpr std::uint32_t Empty = 0xffff'ffff;
+        static constexpr std::size_t Cache_Line_Size = 64;
+
+        // A pooled generator and its reserve of seeds
+        struct alignas(Cache_Line_Size) Slot
+        {
+            explicit Slot(bool pseudo_random_only) :
+                generator(pseudo_random_only)
+            {
+            }
+
+            Generator generator;
+            std::array<std::uint32_t,
+                       Generator::Seed_Words * Reserved_Seeds> seeds{};
+            std::size_t seeds_used = Reserved_Seeds;
+        };
+
+        // A link of the free stack
+        struct alignas(Cache_Line_Size) Link
+        {
+            std::atomic<std::uint32_t> next;
+        };
+
+        void Push(std::uint32_t slot) noexcept;
+        std::uint32_t Pop() noexcept;
+        void Return(std::uint32_t slot) noexcept;
+        void Reseed(Slot &entry) noexcept;
+
+        const bool pseudo_random_only;
+        const PoolReturnPolicy policy;
+        OSSource &os_source;
+        std::vector<Slot> slots;
+        std::unique_ptr<Link[]> next;
+
+        // Free stack head: version tag (upper 32 bits) and slot (lower 32)
+        alignas(64) std::atomic<std::uint64_t> head;
+};
+
+// The engines for which BasicRandomGeneratorPool is instantiated
+extern template class BasicRandomGeneratorPool<MT19937>;
+extern template class BasicRandomGeneratorPool<Xoshiro256PlusPlus>;
+extern template class BasicRandomGeneratorPool<Xoshiro128PlusPlus>;
+extern template class BasicRandomGeneratorPool<PCG32>;
+extern template class BasicRandomGeneratorPool<Philox4x32>;
+
+// The pool of default random generators
+using RandomGeneratorPool = BasicRandomGeneratorPool<MT19937>;
+
+} // namespace Terra::Random
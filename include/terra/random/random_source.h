@@ -0,0 +1,98 @@
+/*
+ *  random_source.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the RandomSource enumeration, which names
+ *      the sources of random octets that the library may use, and functions
+ *      that report which sources are available.
+ *
+ *      The sources are probed once per process, when first needed, and
+ *      form an ordered chain that is shared by all generators.  Each request
+ *      for random octets is served by the first source in the chain, with
+ *      each following source used only if the prior ones do not produce
+ *      all of the requested octets.  The chain is, in order, those of the
+ *      following that are available:
+ *
+ *          VDSOGetRandom - getrandom() in the Linux vDSO (no system call)
+ *          GetRandom     - The getrandom() system call
+ *          DevURandom    - The /dev/urandom device
+ *          BCrypt        - BCryptGenRandom() on Windows
+ *          RDRAND        - The x86 RDRAND instruction
+ *          Jitter        - CPU timing jitter (see JitterSource)
+ *
+ *      Jitter is probed only if none of the operating system's sources is
+ *      available, and it is used only to seed generators, as it is too
+ *      slow to serve requests directly.
+ *
+ *      BasicRandomGenerator::GetLastSource() reports the source that served
+ *      a generator's most recent request, so that it can be verified that
+ *      a host uses its fastest source.
+ *
+ *      All octets read from the sources are checked with the continuous
+ *      health tests of NIST SP 800-90B (see HealthTest), with separate test
+ *      state for each thread and source.  Octets that fail are discarded,
+ *      and the response set with SetHealthTestResponse() is taken:
+ *
+ *          SwitchSource - The request continues with the next source, and
+ *                         a source failing 3 consecutive reads is not
+ *                         used by the process for 60 seconds (the default)
+ *          Reseed       - The request continues with the next source, and
+ *                         the generator that made the request reseeds its
+ *                         PRNG; the source remains in use
+ *          Error        - No other source is used for the request, so
+ *                         FillRandomOctets() reports std::errc::bad_message
+ *                         (other requests receive octets only from the PRNG)
+ *
+ *      ReadRandomSource() reads from one source in the chain exactly as
+ *      generators do (including the health tests), so that the sources
+ *      can be characterized (e.g., by the random_sources tool).
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <system_error>
+
+namespace Terra::Random
+{
+
+enum class RandomSource : std::uint8_t
+{
+    None,
+    VDSOGetRandom,
+    GetRandom,
+    DevURandom,
+    BCrypt,
+    RDRAND,
+    Jitter
+};
+
+// Response to octets from a random source failing the health tests
+enum class HealthTestResponse : std::uint8_t
+{
+    SwitchSource,
+    Reseed,
+    Error
+};
+
+std::span<const RandomSource> GetRandomSources();
+const char *GetRandomSourceName(RandomSource source) noexcept;
+void SetHealthTestResponse(HealthTestResponse response) noexcept;
+HealthTestResponse GetHealthTestResponse() noexcept;
+std::size_t ReadRandomSource(RandomSource source,
+                             std::span<std::uint8_t> octets,
+                             std::error_code &error);
+
+} // namespace Terra::Random
@@ -0,0 +1,95 @@
+/*
+ *  random_tape.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the RandomTape object.  A random tape is a
+ *      file of pseudo-random octets that is generated once (see Create()) and
+ *      then read by any number of runs of a program that must consume the
+ *      same octets each time.  Reading the tape costs only a memory copy (or
+ *      nothing, using ViewRandomOctets()) once the file is in the page cache.
+ *
+ *      The tape's content is that of ParallelFill() for the tape's seed, so
+ *      it is produced using all available threads and is identical
+ *      regardless of the number of threads used to create it.
+ *
+ *      The tape file has a header of Data_Offset octets, so that the data is
+ *      page-aligned, with the following format (little-endian integers):
+ *
+ *          Offset  Size  Field
+ *          0       4     Magic value "TRTP"
+ *          4       2     Format version (1)
+ *          6       2     Reserved (0)
+ *          8       8     Seed
+ *          16      8     Size of the data
+ *
+ *      The tape is memory-mapped with hints that it will be read
+ *      sequentially and that huge pages should be used where possible.
+ *      The read position may be changed with Seek().  Reading beyond the
+ *      end of the tape throws std::out_of_range.
+ *
+ *  Portability Issues:
+ *      On systems without mmap(), the tape is read into memory.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <span>
+
+namespace Terra::Random
+{
+
+class RandomTape
+{
+    public:
+        static constexpr std::size_t Data_Offset = 4096;
+        static constexpr std::uint16_t Version = 1;
+
+        static void Create(const std::string &filename,
+                           std::uint64_t size,
+                           std::uint64_t seed,
+                           unsigned threads = 0);
+
+        RandomTape(const std::string &filename);
+        RandomTape(const RandomTape &) = delete;
+        ~RandomTape();
+        RandomTape &operator=(const RandomTape &) = delete;
+
+        std::uint64_t GetSeed() const noexcept { return seed; }
+        std::uint64_t Size() const noexcept { return data.size(); }
+        std::uint64_t Tell() const noexcept { return position; }
+        std::uint64_t Remaining() const noexcept
+        {
+            return data.size() - position;
+        }
+        void Seek(std::uint64_t offset);
+
+        std::uint8_t GetRandomOctet();
+        std::vector<std::uint8_t> GetRandomOctets(std::size_t count);
+        void GetRandomOctets(std::span<std::uint8_t> octets);
+        std::span<const std::uint8_t> ViewRandomOctets(std::size_t count);
+
+    protected:
+        std::span<const std::uint8_t> data;
+        std::size_t position;
+        std::uint64_t seed;
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+        void *mapping;
+        std::size_t mapping_size;
+#else
+        std::vector<std::uint8_t> buffer;
+#endif
+};
+
+} // namespace Terra::Random
@@ -0,0 +1,83 @@
+/*
+ *  recording_generator.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the BasicRecordingGenerator object.  This
+ *      object wraps a BasicRandomGenerator and records every block of
+ *      octets it returns, along with a caller-supplied call-site tag, to a
+ *      log file.  The log may later be served back exactly by the
+ *      ReplayGenerator to reproduce an execution that depended on random
+ *      choices.
+ *
+ *      Records are placed into a lock-free single-producer ring buffer and
+ *      written to the file by a background thread, so recording adds only
+ *      a copy of the output to each call.  The caller waits only if the ring
+ *      fills faster than the file can be written.
+ *
+ *      Like BasicRandomGenerator, this object must only be used by one
+ *      thread at a time.  The wrapped generator must outlive this object
+ *      and should not be used directly while recording.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <memory>
+#include <span>
+#include "random_generator.h"
+
+namespace Terra::Random
+{
+
+class RandomLogWriter;
+
+template<typename Engine>
+class BasicRecordingGenerator
+{
+    public:
+        static constexpr std::size_t Default_Ring_Size = 1024 * 1024;
+
+        BasicRecordingGenerator(BasicRandomGenerator<Engine> &generator,
+                                const std::string &filename,
+                                std::size_t ring_size = Default_Ring_Size);
+        BasicRecordingGenerator(const BasicRecordingGenerator &) = delete;
+        ~BasicRecordingGenerator();
+        BasicRecordingGenerator &operator=(const BasicRecordingGenerator &) =
+            delete;
+
+        std::uint8_t GetRandomOctet(std::uint32_t tag = 0) noexcept;
+        std::vector<std::uint8_t> GetRandomOctets(std::size_t count,
+                                                  std::uint32_t tag = 0);
+        void GetRandomOctets(std::span<std::uint8_t> octets,
+                             std::uint32_t tag = 0) noexcept;
+        bool Flush() noexcept;
+
+    protected:
+        BasicRandomGenerator<Engine> &generator;
+        std::unique_ptr<RandomLogWriter> writer;
+};
+
+// The engines for which BasicRecordingGenerator is instantiated
+extern template class BasicRecordingGenerator<MT19937>;
+extern template class BasicRecordingGenerator<Xoshiro256PlusPlus>;
+extern template class BasicRecordingGenerator<Xoshiro128PlusPlus>;
+extern template class BasicRecordingGenerator<PCG32>;
+extern template class BasicRecordingGenerator<Philox4x32>;
+
+// The recording generator for the default random generator
+using RecordingGenerator = BasicRecordingGenerator<MT19937>;
+
+} // namespace Terra::Random
@@ -0,0 +1,68 @@
+/*
+ *  replay_generator.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the ReplayGenerator object.  This object
+ *      serves back the octets recorded by a BasicRecordingGenerator, in the
+ *      same order, so that an execution that depended on random choices
+ *      may be reproduced exactly.
+ *
+ *      Each call must request the same number of octets with the same tag
+ *      as the corresponding recorded call.  If it does not, or if the log is
+ *      exhausted, the execution has diverged from the recording and a
+ *      std::runtime_error exception is thrown.
+ *
+ *      The log is memory-mapped where supported, so ViewRandomOctets()
+ *      returns recorded octets without copying them.
+ *
+ *  Portability Issues:
+ *      On systems without mmap(), the log is read into memory.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <span>
+
+namespace Terra::Random
+{
+
+class ReplayGenerator
+{
+    public:
+        ReplayGenerator(const std::string &filename);
+        ReplayGenerator(const ReplayGenerator &) = delete;
+        ~ReplayGenerator();
+        ReplayGenerator &operator=(const ReplayGenerator &) = delete;
+
+        std::uint8_t GetRandomOctet(std::uint32_t tag = 0);
+        std::vector<std::uint8_t> GetRandomOctets(std::size_t count,
+                                                  std::uint32_t tag = 0);
+        void GetRandomOctets(std::span<std::uint8_t> octets,
+                             std::uint32_t tag = 0);
+        std::span<const std::uint8_t> ViewRandomOctets(std::size_t count,
+                                                       std::uint32_t tag = 0);
+        bool AtEnd() const noexcept;
+
+    protected:
+        std::span<const std::uint8_t> log;
+        std::size_t position;
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+        void *mapping;
+#else
+        std::vector<std::uint8_t> buffer;
+#endif
+};
+
+} // namespace Terra::Random
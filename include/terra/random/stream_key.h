@@ -0,0 +1,96 @@
+/*
+ *  stream_key.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the StreamKey object and the Derive()
+ *      function, which derive independent pseudo-random streams from a
+ *      master seed and a path (e.g., node, rank, thread, "purpose").
+ *
+ *      A StreamKey holds a 128-bit key.  Deriving a child key computes
+ *      SipHash-2-4 (128-bit output), keyed with the parent key, over an
+ *      unambiguous encoding of one path element, which is either an integer
+ *      or a string.  Derivation is hierarchical, so a key derived for a node
+ *      may be handed to that node, which then derives keys for its ranks
+ *      and threads without coordination.  Distinct paths yield unrelated
+ *      keys, and no operating system entropy is consumed.
+ *
+ *      The SeedData() function returns seed data suitable for seeding any
+ *      of the engines or the BasicRandomGenerator object, e.g.:
+ *
+ *          StreamKey master(1234);
+ *          auto key = Derive(master, node, rank, thread, "sampling");
+ *          RandomGenerator generator(key.SeedData());
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <string_view>
+
+namespace Terra::Random
+{
+
+class StreamKey
+{
+    public:
+        using Value = std::array<std::uint64_t, 2>;
+        using SeedWords = std::array<std::uint32_t, 4>;
+
+        explicit StreamKey(std::uint64_t master_seed) noexcept;
+        explicit StreamKey(const Value &value) noexcept;
+
+        StreamKey Derive(std::uint64_t id) const;
+        StreamKey Derive(std::string_view label) const;
+
+        const Value &GetValue() const noexcept { return value; }
+        SeedWords SeedData() const noexcept;
+
+        bool operator==(const StreamKey &other) const = default;
+
+    protected:
+        Value value;
+};
+
+/*
+ *  Derive()
+ *
+ *  Description:
+ *      Derive the key for the given path beneath a parent key.
+ *
+ *  Parameters:
+ *      parent [in]
+ *          The parent key.
+ *
+ *      path [in]
+ *          Zero or more path elements, each of which is an integer or a
+ *          string.
+ *
+ *  Returns:
+ *      The derived key, which is the result of deriving each path element
+ *      in turn.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename... Path>
+StreamKey Derive(const StreamKey &parent, const Path &...path)
+{
+    StreamKey key = parent;
+
+    ((key = key.Derive(path)), ...);
+
+    return key;
+}
+
+} // namespace Terra::Random
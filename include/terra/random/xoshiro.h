@@ -0,0 +1,149 @@
+/*
+ *  xoshiro.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Header file that defines the Xoshiro256PlusPlus object.  This is the
+ *      xoshiro256++ engine by David Blackman and Sebastiano Vigna, which is
+ *      fast, has a small state, and can be advanced by 2^128 steps (Jump())
+ *      or 2^192 steps (LongJump()) to produce non-overlapping sub-sequences.
+ *      Discard() advances the engine by an arbitrary number of steps in
+ *      logarithmic time.
+ *
+ *      This file also defines the Xoshiro128PlusPlus object, the xoshiro128++
+ *      engine by the same authors.  It has only 16 octets of state and 32-bit
+ *      output, and is intended for applications that hold a very large
+ *      number of generators (e.g., one per session).  Its period is
+ *      2^128 - 1, and Jump() and LongJump() advance it by 2^64 and 2^96
+ *      steps, respectively.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+
+namespace Terra::Random
+{
+
+class Xoshiro256PlusPlus
+{
+    public:
+        using result_type = std::uint64_t;
+        static constexpr result_type Default_Seed = 0;
+        static constexpr std::uint16_t Engine_Id = 2;
+        static constexpr std::size_t Saved_State_Size = 32;
+
+        Xoshiro256PlusPlus(result_type seed = Default_Seed) noexcept;
+        Xoshiro256PlusPlus(std::span<const std::uint32_t> seed_data);
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept
+        {
+            return 0xffff'ffff'ffff'ffff;
+        }
+
+        void Seed(result_type seed) noexcept;
+        void Seed(std::span<const std::uint32_t> seed_data);
+
+        // Produce the next value in the sequence
+        result_type operator()() noexcept
+        {
+            const result_type result = Rotate(state[0] + state[3], 23) +
+                                       state[0];
+            const result_type t = state[1] << 17;
+
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = Rotate(state[3], 45);
+
+            return result;
+        }
+
+        void Discard(std::uint64_t count);
+        void Jump() noexcept;
+        void LongJump() noexcept;
+
+        void SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept;
+        bool LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept;
+
+    protected:
+        static constexpr result_type Rotate(result_type value,
+                                            unsigned bits) noexcept
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        std::array<std::uint64_t, 4> state;
+};
+
+class Xoshiro128PlusPlus
+{
+    public:
+        using result_type = std::uint32_t;
+        static constexpr std::uint64_t Default_Seed = 0;
+        static constexpr std::uint16_t Engine_Id = 5;
+        static constexpr std::size_t Saved_State_Size = 16;
+
+        Xoshiro128PlusPlus(std::uint64_t seed = Default_Seed) noexcept;
+        Xoshiro128PlusPlus(std::span<const std::uint32_t> seed_data);
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept { return 0xffff'ffff; }
+
+        void Seed(std::uint64_t seed) noexcept;
+        void Seed(std::span<const std::uint32_t> seed_data);
+
+        // Produce the next value in the sequence
+        result_type operator()() noexcept
+        {
+            const result_type result = Rotate(state[0] + state[3], 7) +
+                                       state[0];
+            const result_type t = state[1] << 9;
+
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = Rotate(state[3], 11);
+
+            return result;
+        }
+
+        void Discard(std::uint64_t count);
+        void Jump() noexcept;
+        void LongJump() noexcept;
+
+        void SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept;
+        bool LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept;
+
+    protected:
+        static constexpr result_type Rotate(result_type value,
+                                            unsigned bits) noexcept
+        {
+            return (value << bits) | (value >> (32 - bits));
+        }
+
+        std::array<std::uint32_t, 4> state;
+};
+
+} // namespace Terra::Random
@@ -0,0 +1,204 @@
+/*
+ *  cpu_source.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the CPUSource object.
+ *
+ *  Portability Issues:
+ *      The instructions are used only on x86-64 processors when using GCC,
+ *      Clang, or MSVC.
+ */
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define TERRA_RANDOM_CPU_SOURCE
+#define TERRA_RANDOM_TARGET(feature) __attribute__((target(feature)))
+#elif defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define TERRA_RANDOM_CPU_SOURCE
+#define TERRA_RANDOM_TARGET(feature)
+#endif
+#include <cstring>
+#include <algorithm>
+#include "cpu_source.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+#ifdef TERRA_RANDOM_CPU_SOURCE
+
+// CPUID feature bit (leaf 1, ECX) indicating support for RDRAND
+constexpr unsigned RDRAND_Bit = 1U << 30;
+
+// Value returned by some defective processors in place of random values
+constexpr unsigned long long All_Ones = ~0ULL;
+
+/*
+ *  QueryCPUID()
+ *
+ *  Description:
+ *      Execute the CPUID instruction for the given leaf.
+ *
+ *  Parameters:
+ *      leaf [in]
+ *          The CPUID leaf to query.
+ *
+ *      registers [out]
+ *          The resulting values of EAX, EBX, ECX, and EDX, in that order.
+ *
+ *  Returns:
+ *      True if the leaf is supported, false if not.
+ *
+ *  Comments:
+ *      Sub-leaf 0 is queried.
+ */
+bool QueryCPUID(unsigned leaf, unsigned (&registers)[4]) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __get_cpuid_count(leaf,
+                             0,
+                             &registers[0],
+                             &registers[1],
+                             &registers[2],
+                             &registers[3]) != 0;
+#else
+    int values[4];
+
+    __cpuid(values, 0);
+    if (static_cast<unsigned>(values[0]) < leaf) return false;
+
+    __cpuidex(values, static_cast<int>(leaf), 0);
+    for (unsigned i = 0; i < 4; i++)
+    {
+        registers[i] = static_cast<unsigned>(values[i]);
+    }
+
+    return true;
+#endif
+}
+
+/*
+ *  RandomValue()
+ *
+ *  Description:
+ *      Produce a 64-bit value using RDRAND.
+ *
+ *  Parameters:
+ *      value [out]
+ *          The random value.
+ *
+ *  Returns:
+ *      True if a value was produced, false if the instruction failed
+ *      Retry_Limit times.
+ *
+ *  Comments:
+ *      The instruction's return value is the carry flag.
+ */
+TERRA_RANDOM_TARGET("rdrnd")
+bool RandomValue(std::uint64_t &value) noexcept
+{
+    for (unsigned i = 0; i < CPUSource::Retry_Limit; i++)
+    {
+        unsigned long long result;
+
+        if ((_rdrand64_step(&result) != 0) && (result != All_Ones))
+        {
+            value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif // TERRA_RANDOM_CPU_SOURCE
+
+} // namespace
+
+/*
+ *  CPUSource::HaveRDRAND()
+ *
+ *  Description:
+ *      Determine whether the processor supports RDRAND.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if RDRAND is supported, false if not.
+ *
+ *  Comments:
+ *      The processor is queried once.
+ */
+bool CPUSource::HaveRDRAND() noexcept
+{
+#ifdef TERRA_RANDOM_CPU_SOURCE
+    static const bool rdrand = []()
+    {
+        unsigned registers[4];
+
+        return QueryCPUID(1, registers) && ((registers[2] & RDRAND_Bit) != 0);
+    }();
+
+    return rdrand;
+#else
+    return false;
+#endif
+}
+
+/*
+ *  CPUSource::Read()
+ *
+ *  Description:
+ *      Read random octets produced by RDRAND.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *  Returns:
+ *      A count of the number of octets placed into the buffer.  This is
+ *      zero if RDRAND is not supported and may be smaller than the size of
+ *      the span if the instruction repeatedly fails.
+ *
+ *  Comments:
+ *      This may be called concurrently from multiple threads.
+ */
+std::size_t CPUSource::Read(std::span<std::uint8_t> buffer) noexcept
+{
+    std::size_t octets_sourced = 0;
+
+#ifdef TERRA_RANDOM_CPU_SOURCE
+    if (!HaveRDRAND()) return 0;
+
+    while (octets_sourced < buffer.size())
+    {
+        std::uint64_t value;
+
+        if (!RandomValue(value)) break;
+
+        std::size_t length = std::min(sizeof(value),
+                                      buffer.size() - octets_sourced);
+        std::memcpy(buffer.data() + octets_sourced, &value, length);
+        octets_sourced += length;
+    }
+#else
+    static_cast<void>(buffer);
+#endif
+
+    return octets_sourced;
+}
+
+} // namespace Terra::Random
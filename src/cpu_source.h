@@ -0,0 +1,57 @@
+/*
+ *  cpu_source.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines the CPUSource object, which provides
+ *      random values from the processor's RDRAND instruction without making
+ *      a system call.
+ *
+ *      Support for the instruction is detected at runtime with CPUID.  The
+ *      instruction reports failure (e.g., when the hardware's entropy is
+ *      temporarily exhausted) by clearing the carry flag, so each value is
+ *      retried a bounded number of times before the source gives up.  A
+ *      value with all bits set is also treated as a failure, since some
+ *      processors with defective firmware return it without clearing the
+ *      carry flag.
+ *
+ *      RDSEED is not used: it fails most attempts when the hardware's
+ *      entropy is drawn upon continuously and is several times slower than
+ *      RDRAND, whose output is reseeded from the same hardware source.
+ *
+ *      Values from this source are always mixed with values from another
+ *      source and are never used alone.
+ *
+ *  Portability Issues:
+ *      Only available on x86-64 processors.  Elsewhere, no values are
+ *      produced.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace Terra::Random
+{
+
+class CPUSource
+{
+    public:
+        // Attempts per value, following Intel's guidance for RDRAND
+        static constexpr unsigned Retry_Limit = 10;
+
+        CPUSource() = delete;
+
+        static bool HaveRDRAND() noexcept;
+        static std::size_t Read(std::span<std::uint8_t> buffer) noexcept;
+};
+
+} // namespace Terra::Random
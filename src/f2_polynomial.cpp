@@ -0,0 +1,571 @@
+/*
+ *  f2_polynomial.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation of polynomial arithmetic over GF(2) used for jumping
+ *      F2-linear engines ahead.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <bit>
+#include <utility>
+#include "f2_polynomial.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+/*
+ *  SpreadOctet()
+ *
+ *  Description:
+ *      Spread the bits of an octet such that bit i moves to bit 2i.  This
+ *      is the square of the polynomial represented by the octet.
+ *
+ *  Parameters:
+ *      octet [in]
+ *          The octet to spread.
+ *
+ *  Returns:
+ *      The 16-bit spread value.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::uint16_t SpreadOctet(std::uint8_t octet) noexcept
+{
+    std::uint16_t result = 0;
+
+    for (unsigned i = 0; i < 8; i++)
+    {
+        if (octet & (1U << i))
+        {
+            result |= static_cast<std::uint16_t>(1U << 2 * i);
+        }
+    }
+
+    return result;
+}
+
+// Table of spread octets used when squaring polynomials
+constexpr auto Spread_Table = []()
+{
+    std::array<std::uint16_t, 256> table{};
+    for (unsigned i = 0; i < 256; i++)
+    {
+        table[i] = SpreadOctet(static_cast<std::uint8_t>(i));
+    }
+    return table;
+}();
+
+/*
+ *  SpreadWord()
+ *
+ *  Description:
+ *      Spread the lower (or upper) 32 bits of a word such that bit i moves
+ *      to bit 2i.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The 32-bit value to spread.
+ *
+ *  Returns:
+ *      The 64-bit spread value.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::uint64_t SpreadWord(std::uint32_t value) noexcept
+{
+    return static_cast<std::uint64_t>(Spread_Table[value & 0xff]) |
+           static_cast<std::uint64_t>(Spread_Table[(value >> 8) & 0xff])
+               << 16 |
+           static_cast<std::uint64_t>(Spread_Table[(value >> 16) & 0xff])
+               << 32 |
+           static_cast<std::uint64_t>(Spread_Table[(value >> 24) & 0xff])
+               << 48;
+}
+
+/*
+ *  ShiftedWord()
+ *
+ *  Description:
+ *      Extract 64 bits from the given word array starting at an arbitrary
+ *      bit offset.  Bits beyond the end of the array read as zero.
+ *
+ *  Parameters:
+ *      words [in]
+ *          The word array.
+ *
+ *      offset [in]
+ *          The bit offset of the first bit to extract.
+ *
+ *  Returns:
+ *      The 64 bits starting at the given offset.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint64_t ShiftedWord(const std::vector<std::uint64_t> &words,
+                          std::size_t offset) noexcept
+{
+    std::size_t index = offset / 64;
+    std::size_t shift = offset % 64;
+    std::uint64_t result = 0;
+
+    if (index < words.size()) result = words[index] >> shift;
+    if ((shift != 0) && (index + 1 < words.size()))
+    {
+        result |= words[index + 1] << (64 - shift);
+    }
+
+    return result;
+}
+
+} // namespace
+
+/*
+ *  F2Polynomial::F2Polynomial()
+ *
+ *  Description:
+ *      Constructor for the F2Polynomial object that creates a zero polynomial
+ *      with storage for the given number of coefficients.
+ *
+ *  Parameters:
+ *      bits [in]
+ *          The number of coefficients for which to allocate storage.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+F2Polynomial::F2Polynomial(std::size_t bits) : words((bits + 63) / 64, 0)
+{
+}
+
+/*
+ *  F2Polynomial::Monomial()
+ *
+ *  Description:
+ *      Create the polynomial x^exponent.
+ *
+ *  Parameters:
+ *      exponent [in]
+ *          The exponent of the monomial.
+ *
+ *  Returns:
+ *      The monomial.
+ *
+ *  Comments:
+ *      None.
+ */
+F2Polynomial F2Polynomial::Monomial(std::size_t exponent)
+{
+    F2Polynomial polynomial(exponent + 1);
+
+    polynomial.SetCoefficient(exponent);
+
+    return polynomial;
+}
+
+/*
+ *  F2Polynomial::Degree()
+ *
+ *  Description:
+ *      Return the degree of the polynomial.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The degree of the polynomial or -1 if the polynomial is zero.
+ *
+ *  Comments:
+ *      None.
+ */
+std::ptrdiff_t F2Polynomial::Degree() const noexcept
+{
+    for (std::size_t i = words.size(); i > 0; i--)
+    {
+        if (words[i - 1] != 0)
+        {
+            return static_cast<std::ptrdiff_t>((i - 1) * 64 +
+                                               std::bit_width(words[i - 1])) -
+                   1;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ *  F2Polynomial::Coefficient()
+ *
+ *  Description:
+ *      Return the coefficient of x^exponent.
+ *
+ *  Parameters:
+ *      exponent [in]
+ *          The exponent of the term.
+ *
+ *  Returns:
+ *      True if the coefficient is one, false if it is zero.
+ *
+ *  Comments:
+ *      None.
+ */
+bool F2Polynomial::Coefficient(std::size_t exponent) const noexcept
+{
+    if (exponent / 64 >= words.size()) return false;
+
+    return ((words[exponent / 64] >> (exponent % 64)) & 1) != 0;
+}
+
+/*
+ *  F2Polynomial::SetCoefficient()
+ *
+ *  Description:
+ *      Set the coefficient of x^exponent to one, growing storage if needed.
+ *
+ *  Parameters:
+ *      exponent [in]
+ *          The exponent of the term.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void F2Polynomial::SetCoefficient(std::size_t exponent)
+{
+    if (exponent / 64 >= words.size()) words.resize(exponent / 64 + 1, 0);
+
+    words[exponent / 64] |= std::uint64_t(1) << (exponent % 64);
+}
+
+/*
+ *  F2Modulus::F2Modulus()
+ *
+ *  Description:
+ *      Constructor for the F2Modulus object.
+ *
+ *  Parameters:
+ *      modulus [in]
+ *          The modulus polynomial, which must have a degree of at least one.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Shifted copies of the modulus are computed for each of the 64 bit
+ *      offsets so that reduction only requires word-aligned operations.
+ */
+F2Modulus::F2Modulus(const F2Polynomial &modulus) :
+    degree{static_cast<std::size_t>(modulus.Degree())},
+    word_count{(degree + 63) / 64}
+{
+    for (std::size_t shift = 0; shift < 64; shift++)
+    {
+        auto &words = shifted[shift];
+        words.assign(degree / 64 + 2, 0);
+        for (std::size_t i = 0; i < words.size(); i++)
+        {
+            if (shift == 0)
+            {
+                if (i < modulus.words.size()) words[i] = modulus.words[i];
+            }
+            else
+            {
+                words[i] = ShiftedWord(modulus.words, i * 64) << shift;
+                if (i > 0)
+                {
+                    words[i] |= ShiftedWord(modulus.words, (i - 1) * 64) >>
+                                (64 - shift);
+                }
+            }
+        }
+    }
+}
+
+/*
+ *  F2Modulus::PowerOfX()
+ *
+ *  Description:
+ *      Compute x^exponent mod the modulus.
+ *
+ *  Parameters:
+ *      exponent [in]
+ *          The exponent as an array of 64-bit words, least significant word
+ *          first.
+ *
+ *  Returns:
+ *      The remainder polynomial, which has a degree less than the modulus.
+ *
+ *  Comments:
+ *      None.
+ */
+F2Polynomial F2Modulus::PowerOfX(std::span<const std::uint64_t> exponent) const
+{
+    F2Polynomial result(degree);
+    bool started = false;
+
+    result.words[0] = 1;
+
+    // Left-to-right binary exponentiation
+    for (std::size_t i = exponent.size(); i > 0; i--)
+    {
+        for (unsigned bit = 64; bit > 0; bit--)
+        {
+            bool set = ((exponent[i - 1] >> (bit - 1)) & 1) != 0;
+            if (!started && !set) continue;
+            if (started) Square(result);
+            if (set) MultiplyByX(result);
+            started = true;
+        }
+    }
+
+    return result;
+}
+
+/*
+ *  F2Modulus::PowerOfX()
+ *
+ *  Description:
+ *      Compute x^exponent mod the modulus.
+ *
+ *  Parameters:
+ *      exponent [in]
+ *          The exponent.
+ *
+ *  Returns:
+ *      The remainder polynomial, which has a degree less than the modulus.
+ *
+ *  Comments:
+ *      None.
+ */
+F2Polynomial F2Modulus::PowerOfX(std::uint64_t exponent) const
+{
+    return PowerOfX(std::span<const std::uint64_t>(&exponent, 1));
+}
+
+/*
+ *  F2Modulus::Square()
+ *
+ *  Description:
+ *      Square the given polynomial mod the modulus.
+ *
+ *  Parameters:
+ *      polynomial [in/out]
+ *          The polynomial to square, which must be reduced.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Squaring over GF(2) simply spreads the bits apart.
+ */
+void F2Modulus::Square(F2Polynomial &polynomial) const
+{
+    std::vector<std::uint64_t> product(2 * word_count, 0);
+
+    for (std::size_t i = 0; i < word_count; i++)
+    {
+        std::uint64_t word = polynomial.words[i];
+        product[2 * i] = SpreadWord(static_cast<std::uint32_t>(word));
+        product[2 * i + 1] = SpreadWord(static_cast<std::uint32_t>(word >> 32));
+    }
+
+    Reduce(product);
+
+    product.resize(word_count);
+    polynomial.words = std::move(product);
+}
+
+/*
+ *  F2Modulus::MultiplyByX()
+ *
+ *  Description:
+ *      Multiply the given polynomial by x mod the modulus.
+ *
+ *  Parameters:
+ *      polynomial [in/out]
+ *          The polynomial to multiply, which must be reduced.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void F2Modulus::MultiplyByX(F2Polynomial &polynomial) const
+{
+    auto &words = polynomial.words;
+    std::uint64_t carry = 0;
+
+    words.resize(word_count + 1, 0);
+
+    for (auto &word : words)
+    {
+        std::uint64_t next_carry = word >> 63;
+        word = (word << 1) | carry;
+        carry = next_carry;
+    }
+
+    // If the degree reached that of the modulus, subtract the modulus
+    if (((words[degree / 64] >> (degree % 64)) & 1) != 0)
+    {
+        for (std::size_t i = 0; i < words.size(); i++)
+        {
+            words[i] ^= shifted[0][i];
+        }
+    }
+
+    words.resize(word_count);
+}
+
+/*
+ *  F2Modulus::Reduce()
+ *
+ *  Description:
+ *      Reduce the given polynomial mod the modulus.
+ *
+ *  Parameters:
+ *      words [in/out]
+ *          The words of the polynomial to reduce.  Upon return, all bits at
+ *          or above the degree of the modulus will be zero.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void F2Modulus::Reduce(std::vector<std::uint64_t> &words) const
+{
+    for (std::size_t bit = words.size() * 64; bit > degree; bit--)
+    {
+        std::size_t exponent = bit - 1;
+        if (((words[exponent / 64] >> (exponent % 64)) & 1) == 0) continue;
+
+        // Subtract the modulus multiplied by x^(exponent - degree)
+        std::size_t shift = exponent - degree;
+        const auto &modulus = shifted[shift % 64];
+        std::size_t limit = std::min(modulus.size(), words.size() - shift / 64);
+        for (std::size_t i = 0; i < limit; i++)
+        {
+            words[shift / 64 + i] ^= modulus[i];
+        }
+    }
+}
+
+/*
+ *  MinimalPolynomial()
+ *
+ *  Description:
+ *      Find the minimal polynomial of the given bit sequence using the
+ *      Berlekamp-Massey algorithm.
+ *
+ *  Parameters:
+ *      sequence [in]
+ *          The bit sequence, which should be at least twice as long as the
+ *          linear complexity of the generator that produced it.
+ *
+ *  Returns:
+ *      The minimal polynomial p(x) such that p(A) annihilates the sequence.
+ *
+ *  Comments:
+ *      The algorithm yields the connection polynomial C(x), and the minimal
+ *      polynomial is its reciprocal x^L * C(1/x).  The sequence is stored in
+ *      reverse so that each discrepancy is a word-wise inner product.
+ */
+F2Polynomial MinimalPolynomial(const std::vector<bool> &sequence)
+{
+    const std::size_t length = sequence.size();
+    F2Polynomial reversed(length);
+    F2Polynomial connection = F2Polynomial::Monomial(0);
+    F2Polynomial previous = F2Polynomial::Monomial(0);
+    std::size_t complexity = 0;
+    std::size_t gap = 1;
+
+    // Reverse the sequence such that s[n - i] is bit (length - 1 - n + i)
+    for (std::size_t i = 0; i < length; i++)
+    {
+        if (sequence[i]) reversed.SetCoefficient(length - 1 - i);
+    }
+    connection.words.resize(reversed.words.size() + 1, 0);
+    previous.words.resize(reversed.words.size() + 1, 0);
+
+    for (std::size_t n = 0; n < length; n++)
+    {
+        // Compute the discrepancy as the parity of C(x) & s[n - i]
+        std::size_t offset = length - 1 - n;
+        std::uint64_t parity = 0;
+        for (std::size_t i = 0; i <= complexity / 64; i++)
+        {
+            std::uint64_t window = ShiftedWord(reversed.words, offset + i * 64);
+            if (i == complexity / 64)
+            {
+                window &= (complexity % 64 == 63) ?
+                              ~std::uint64_t(0) :
+                              (std::uint64_t(1) << (complexity % 64 + 1)) - 1;
+            }
+            parity ^= connection.words[i] & window;
+        }
+
+        if ((std::popcount(parity) & 1) == 0)
+        {
+            gap++;
+            continue;
+        }
+
+        // Compute C(x) ^= B(x) * x^gap, saving the prior C(x) if needed
+        F2Polynomial prior;
+        bool lengthen = (2 * complexity <= n);
+        if (lengthen) prior = connection;
+        for (std::size_t i = 0; i + gap / 64 < connection.words.size(); i++)
+        {
+            std::uint64_t word = previous.words[i] << (gap % 64);
+            if ((gap % 64 != 0) && (i > 0))
+            {
+                word |= previous.words[i - 1] >> (64 - gap % 64);
+            }
+            connection.words[i + gap / 64] ^= word;
+        }
+
+        if (lengthen)
+        {
+            complexity = n + 1 - complexity;
+            previous = std::move(prior);
+            gap = 1;
+        }
+        else
+        {
+            gap++;
+        }
+    }
+
+    // The minimal polynomial is the reciprocal of the connection polynomial
+    F2Polynomial minimal(complexity + 1);
+    for (std::size_t i = 0; i <= complexity; i++)
+    {
+        if (connection.Coefficient(i)) minimal.SetCoefficient(complexity - i);
+    }
+
+    return minimal;
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,129 @@
+/*
+ *  f2_polynomial.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines polynomial arithmetic over GF(2).  This
+ *      is used to advance F2-linear engines (e.g., Mersenne Twister and the
+ *      xoshiro family) by an arbitrary number of steps in logarithmic time.
+ *
+ *      The approach is that of Haramoto, et al., "Efficient Jump Ahead for
+ *      F2-Linear Random Number Generators".  The characteristic polynomial
+ *      of the engine is found with the Berlekamp-Massey algorithm, the jump
+ *      polynomial x^n mod p(x) is computed by repeated squaring, and the
+ *      jump polynomial is then evaluated at the engine's transition matrix
+ *      using Horner's method (see F2Evaluate()).
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <span>
+
+namespace Terra::Random
+{
+
+// Polynomial over GF(2); bit i of the word array is the coefficient of x^i
+class F2Polynomial
+{
+    public:
+        F2Polynomial() = default;
+        explicit F2Polynomial(std::size_t bits);
+        static F2Polynomial Monomial(std::size_t exponent);
+
+        std::ptrdiff_t Degree() const noexcept;
+        bool Coefficient(std::size_t exponent) const noexcept;
+        void SetCoefficient(std::size_t exponent);
+
+        std::vector<std::uint64_t> words;
+};
+
+// Modulus that holds pre-shifted copies of the polynomial to speed reduction
+class F2Modulus
+{
+    public:
+        F2Modulus(const F2Polynomial &modulus);
+
+        std::size_t Degree() const noexcept { return degree; }
+        F2Polynomial PowerOfX(std::span<const std::uint64_t> exponent) const;
+        F2Polynomial PowerOfX(std::uint64_t exponent) const;
+
+    protected:
+        void Square(F2Polynomial &polynomial) const;
+        void MultiplyByX(F2Polynomial &polynomial) const;
+        void Reduce(std::vector<std::uint64_t> &words) const;
+
+        std::size_t degree;
+        std::size_t word_count;
+        std::array<std::vector<std::uint64_t>, 64> shifted;
+};
+
+// Find the minimal polynomial of a bit sequence (Berlekamp-Massey); the
+// sequence should be at least twice as long as the expected degree
+F2Polynomial MinimalPolynomial(const std::vector<bool> &sequence);
+
+/*
+ *  F2Evaluate()
+ *
+ *  Description:
+ *      Evaluate the polynomial p(A) applied to the given state, where A is
+ *      the transition matrix of the engine as realized by the step function.
+ *      Horner's method is used, so the work is one step per coefficient and
+ *      one state addition for each non-zero coefficient.
+ *
+ *  Parameters:
+ *      polynomial [in]
+ *          The jump polynomial to evaluate.
+ *
+ *      state [in/out]
+ *          The state to which p(A) is applied.  The result is placed here.
+ *
+ *      zero [in]
+ *          The zero state (i.e., the additive identity).
+ *
+ *      step [in]
+ *          Function that advances a given state by one step.
+ *
+ *      add [in]
+ *          Function that adds (XORs) the second state into the first.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename State, typename Step, typename Add>
+void F2Evaluate(const F2Polynomial &polynomial,
+                State &state,
+                const State &zero,
+                Step step,
+                Add add)
+{
+    State result = zero;
+
+    for (auto i = polynomial.Degree(); i >= 0; i--)
+    {
+        step(result);
+        if (polynomial.Coefficient(static_cast<std::size_t>(i)))
+        {
+            add(result, state);
+        }
+    }
+
+    state = result;
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,71 @@
+/*
+ *  file_descriptor.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines the FileDescriptor object, which owns a
+ *      POSIX file descriptor and closes it when destroyed.  The object may
+ *      be moved, but not copied, so a descriptor is never closed twice.
+ *
+ *  Portability Issues:
+ *      Only defined on POSIX systems.
+ */
+
+#pragma once
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+
+#include <unistd.h>
+
+namespace Terra::Random
+{
+
+class FileDescriptor
+{
+    public:
+        FileDescriptor() noexcept : fd{-1} {}
+        explicit FileDescriptor(int fd) noexcept : fd{fd} {}
+        FileDescriptor(const FileDescriptor &) = delete;
+        FileDescriptor(FileDescriptor &&other) noexcept : fd{other.Release()}
+        {
+        }
+        ~FileDescriptor() { Reset(); }
+
+        FileDescriptor &operator=(const FileDescriptor &) = delete;
+        FileDescriptor &operator=(FileDescriptor &&other) noexcept
+        {
+            if (this != &other) Reset(other.Release());
+            return *this;
+        }
+
+        int Get() const noexcept { return fd; }
+        bool IsValid() const noexcept { return fd >= 0; }
+
+        // Relinquish ownership of the descriptor without closing it
+        int Release() noexcept
+        {
+            int released = fd;
+            fd = -1;
+            return released;
+        }
+
+        // Close the descriptor (if any) and take ownership of another
+        void Reset(int new_fd = -1) noexcept
+        {
+            if (fd >= 0) close(fd);
+            fd = new_fd;
+        }
+
+    protected:
+        int fd;
+};
+
+} // namespace Terra::Random
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ *  generator_state.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the GeneratorStateView object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <array>
+#include <algorithm>
+#include <terra/random/generator_state.h>
+#include "little_endian.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Magic value at the start of the saved state
+constexpr std::array<std::uint8_t, 4> Magic = {'T', 'R', 'N', 'G'};
+
+} // namespace
+
+/*
+ *  GeneratorStateView::GeneratorStateView()
+ *
+ *  Description:
+ *      Constructor for the GeneratorStateView object.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The saved state.  This may be longer than the saved state, in
+ *          which case the extra octets are ignored.  The octets are not
+ *          copied, so they must remain valid for the lifetime of the view.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The view is valid if the header is well-formed, the version is
+ *      supported, and the engine state is entirely present.
+ */
+GeneratorStateView::GeneratorStateView(
+                            std::span<const std::uint8_t> octets) noexcept :
+    octets{octets},
+    valid{false}
+{
+    if (octets.size() < Header_Size) return;
+    if (!std::equal(Magic.begin(), Magic.end(), octets.begin())) return;
+    if (GetVersion() != Version) return;
+    if (octets.size() - Header_Size <
+        LoadLittleEndian<std::uint32_t>(octets.data() + 12))
+    {
+        return;
+    }
+
+    valid = true;
+}
+
+/*
+ *  GeneratorStateView::GetVersion()
+ *
+ *  Description:
+ *      Return the format version of the saved state.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The format version.
+ *
+ *  Comments:
+ *      This and the other accessors require at least a full header.
+ */
+std::uint16_t GeneratorStateView::GetVersion() const noexcept
+{
+    return LoadLittleEndian<std::uint16_t>(octets.data() + 4);
+}
+
+/*
+ *  GeneratorStateView::GetEngineId()
+ *
+ *  Description:
+ *      Return the identifier of the engine whose state was saved.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The engine identifier.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint16_t GeneratorStateView::GetEngineId() const noexcept
+{
+    return LoadLittleEndian<std::uint16_t>(octets.data() + 6);
+}
+
+/*
+ *  GeneratorStateView::GetFlags()
+ *
+ *  Description:
+ *      Return the flags of the saved state.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The flags.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint32_t GeneratorStateView::GetFlags() const noexcept
+{
+    return LoadLittleEndian<std::uint32_t>(octets.data() + 8);
+}
+
+/*
+ *  GeneratorStateView::GetDistributionMin()
+ *
+ *  Description:
+ *      Return the minimum value of the saved distribution.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The minimum value.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint64_t GeneratorStateView::GetDistributionMin() const noexcept
+{
+    return LoadLittleEndian<std::uint64_t>(octets.data() + 16);
+}
+
+/*
+ *  GeneratorStateView::GetDistributionMax()
+ *
+ *  Description:
+ *      Return the maximum value of the saved distribution.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The maximum value.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint64_t GeneratorStateView::GetDistributionMax() const noexcept
+{
+    return LoadLittleEndian<std::uint64_t>(octets.data() + 24);
+}
+
+/*
+ *  GeneratorStateView::GetEngineState()
+ *
+ *  Description:
+ *      Return the saved engine state.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A span referring to the engine state within the saved state.
+ *
+ *  Comments:
+ *      None.
+ */
+std::span<const std::uint8_t> GeneratorStateView::GetEngineState()
+                                                                const noexcept
+{
+    return octets.subspan(Header_Size,
+                          LoadLittleEndian<std::uint32_t>(octets.data() + 12));
+}
+
+/*
+ *  GeneratorStateView::Size()
+ *
+ *  Description:
+ *      Return the total size of the saved state.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The size of the header plus the engine state.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t GeneratorStateView::Size() const noexcept
+{
+    return Header_Size + LoadLittleEndian<std::uint32_t>(octets.data() + 12);
+}
+
+/*
+ *  GeneratorStateView::WriteHeader()
+ *
+ *  Description:
+ *      Write the header of the saved state.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The buffer into which the header is written, which must be at
+ *          least Header_Size octets in length.
+ *
+ *      engine_id [in]
+ *          The engine identifier.
+ *
+ *      flags [in]
+ *          The flags.
+ *
+ *      engine_state_size [in]
+ *          The size of the engine state that follows the header.
+ *
+ *      distribution_min [in]
+ *          The minimum value of the distribution.
+ *
+ *      distribution_max [in]
+ *          The maximum value of the distribution.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void GeneratorStateView::WriteHeader(std::span<std::uint8_t> octets,
+                                     std::uint16_t engine_id,
+                                     std::uint32_t flags,
+                                     std::uint32_t engine_state_size,
+                                     std::uint64_t distribution_min,
+                                     std::uint64_t distribution_max) noexcept
+{
+    std::copy(Magic.begin(), Magic.end(), octets.begin());
+    StoreLittleEndian(octets.data() + 4, Version);
+    StoreLittleEndian(octets.data() + 6, engine_id);
+    StoreLittleEndian(octets.data() + 8, flags);
+    StoreLittleEndian(octets.data() + 12, engine_state_size);
+    StoreLittleEndian(octets.data() + 16, distribution_min);
+    StoreLittleEndian(octets.data() + 24, distribution_max);
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,912 @@
+/*
+ *  health_test.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the HealthTest object.
+ *
+ *      A run of RCT_Cutoff (6) identical octets always contains two
+ *      adjacent 16-bit pairs (aligned to the start of the octets tested)
+ *      that are equal, which is otherwise true of only 1 in 65536 pairs.
+ *      The SIMD code looks for equal adjacent pairs and, only if it finds
+ *      any, the octets are examined one at a time to confirm the run.
+ *
+ *  Portability Issues:
+ *      The SIMD implementations are used only on x86 processors.  AVX2 is
+ *      detected at runtime when using GCC or Clang.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__))
+#include <immintrin.h>
+#define TERRA_RANDOM_HEALTH_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#define TERRA_RANDOM_HEALTH_AVX2
+#endif
+#endif
+#include <algorithm>
+#include <terra/random/health_test.h>
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Number of octets at the start of a span that may extend a prior run
+constexpr std::size_t RCT_Span = HealthTest::RCT_Cutoff - 1;
+
+static_assert(HealthTest::RCT_Cutoff == 6);
+
+/*
+ *  HasRun()
+ *
+ *  Description:
+ *      Determine whether RCT_Cutoff consecutive octets are identical by
+ *      examining each octet in turn.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine.
+ *
+ *  Returns:
+ *      True if RCT_Cutoff consecutive octets are identical.
+ *
+ *  Comments:
+ *      This is used for short spans and to confirm what the SIMD code
+ *      finds.
+ */
+bool HasRun(std::span<const std::uint8_t> octets) noexcept
+{
+    unsigned run = 1;
+
+    for (std::size_t i = 1; i < octets.size(); i++)
+    {
+        run = (octets[i] == octets[i - 1]) ? run + 1 : 1;
+        if (run >= HealthTest::RCT_Cutoff) return true;
+    }
+
+    return false;
+}
+
+/*
+ *  CountOctetScalar()
+ *
+ *  Description:
+ *      Count the occurrences of an octet value one octet at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine.
+ *
+ *      value [in]
+ *          The value to count.
+ *
+ *  Returns:
+ *      The number of octets equal to the value.
+ *
+ *  Comments:
+ *      None.
+ */
+unsigned CountOctetScalar(std::span<const std::uint8_t> octets,
+                          std::uint8_t value) noexcept
+{
+    unsigned count = 0;
+
+    for (auto octet : octets) count += (octet == value) ? 1 : 0;
+
+    return count;
+}
+
+#ifndef TERRA_RANDOM_HEALTH_SSE2
+/*
+ *  ScanWindowsScalar()
+ *
+ *  Description:
+ *      Apply the Adaptive Proportion Test to complete windows one octet at
+ *      a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine, which are a multiple of APT_Window in
+ *          length and start at the start of a window.
+ *
+ *      pairs [out]
+ *          Set to true, since adjacent pairs are not examined.
+ *
+ *  Returns:
+ *      True if the test passes for every window, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ScanWindowsScalar(std::span<const std::uint8_t> octets,
+                       bool &pairs) noexcept
+{
+    pairs = true;
+
+    for (std::size_t window = 0;
+         window < octets.size();
+         window += HealthTest::APT_Window)
+    {
+        if (CountOctetScalar(octets.subspan(window, HealthTest::APT_Window),
+                             octets[window]) >= HealthTest::APT_Cutoff)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif // TERRA_RANDOM_HEALTH_SSE2
+
+#ifdef TERRA_RANDOM_HEALTH_SSE2
+/*
+ *  SumLanesSSE2()
+ *
+ *  Description:
+ *      Sum the 8-bit lanes of a vector.
+ *
+ *  Parameters:
+ *      lanes [in]
+ *          The vector to sum.
+ *
+ *  Returns:
+ *      The sum of the lanes.
+ *
+ *  Comments:
+ *      None.
+ */
+unsigned SumLanesSSE2(__m128i lanes) noexcept
+{
+    const __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+
+    return static_cast<unsigned>(_mm_cvtsi128_si32(sums) +
+                                 _mm_extract_epi16(sums, 4));
+}
+
+/*
+ *  FirstPairSSE2()
+ *
+ *  Description:
+ *      Produce a vector whose last 16-bit pair differs from the first pair
+ *      of the octets.
+ *
+ *  Parameters:
+ *      data [in]
+ *          The octets, of which there are at least two.
+ *
+ *  Returns:
+ *      The vector, which serves as the "previous" vector for the first
+ *      comparison of adjacent pairs.
+ *
+ *  Comments:
+ *      None.
+ */
+__m128i FirstPairSSE2(const std::uint8_t *data) noexcept
+{
+    return _mm_set1_epi16(static_cast<short>(~(data[0] | (data[1] << 8))));
+}
+
+/*
+ *  HasRepetitionSSE2()
+ *
+ *  Description:
+ *      Determine whether RCT_Cutoff consecutive octets are identical,
+ *      examining 16 octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine.
+ *
+ *  Returns:
+ *      True if RCT_Cutoff consecutive octets are identical.
+ *
+ *  Comments:
+ *      None.
+ */
+bool HasRepetitionSSE2(std::span<const std::uint8_t> octets) noexcept
+{
+    const std::uint8_t *data = octets.data();
+    std::size_t i = 0;
+
+    if (octets.size() < 16) return HasRun(octets);
+
+    __m128i previous = FirstPairSSE2(data);
+    __m128i pairs = _mm_setzero_si128();
+
+    for (; i + 16 <= octets.size(); i += 16)
+    {
+        const __m128i current =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i shifted = _mm_or_si128(_mm_slli_si128(current, 2),
+                                             _mm_srli_si128(previous, 14));
+
+        pairs = _mm_or_si128(pairs, _mm_cmpeq_epi16(current, shifted));
+        previous = current;
+    }
+
+    if (_mm_movemask_epi8(pairs) != 0) return HasRun(octets);
+
+    // Examine runs that do not contain two of the pairs compared
+    return HasRun(octets.subspan(i - 3));
+}
+
+/*
+ *  CountOctetSSE2()
+ *
+ *  Description:
+ *      Count the occurrences of an octet value, 16 octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine, of which there are at most
+ *          HealthTest::APT_Window.
+ *
+ *      value [in]
+ *          The value to count.
+ *
+ *  Returns:
+ *      The number of octets equal to the value.
+ *
+ *  Comments:
+ *      The window size bounds each lane's count, so the per-lane counts
+ *      cannot overflow.
+ */
+unsigned CountOctetSSE2(std::span<const std::uint8_t> octets,
+                        std::uint8_t value) noexcept
+{
+    static_assert(HealthTest::APT_Window / 16 < 256);
+
+    const __m128i target = _mm_set1_epi8(static_cast<char>(value));
+    __m128i lanes = _mm_setzero_si128();
+    std::size_t i = 0;
+
+    for (; i + 16 <= octets.size(); i += 16)
+    {
+        const __m128i current = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(octets.data() + i));
+
+        // Equal lanes are -1, so subtracting increments the lane's count
+        lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(current, target));
+    }
+
+    return SumLanesSSE2(lanes) + CountOctetScalar(octets.subspan(i), value);
+}
+
+/*
+ *  ScanWindowsSSE2()
+ *
+ *  Description:
+ *      Apply the Adaptive Proportion Test to complete windows and look for
+ *      equal adjacent pairs, 16 octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine, which are a multiple of APT_Window in
+ *          length and start at the start of a window.
+ *
+ *      pairs [out]
+ *          Set to true if equal adjacent pairs were found.
+ *
+ *  Returns:
+ *      True if the test passes for every window, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ScanWindowsSSE2(std::span<const std::uint8_t> octets,
+                     bool &pairs) noexcept
+{
+    const std::uint8_t *data = octets.data();
+    __m128i previous = FirstPairSSE2(data);
+    __m128i equal = _mm_setzero_si128();
+
+    for (std::size_t window = 0;
+         window < octets.size();
+         window += HealthTest::APT_Window)
+    {
+        const __m128i target = _mm_set1_epi8(static_cast<char>(data[window]));
+        __m128i lanes = _mm_setzero_si128();
+
+        for (std::size_t i = window; i < window + HealthTest::APT_Window;
+             i += 16)
+        {
+            const __m128i current =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const __m128i shifted =
+                _mm_or_si128(_mm_slli_si128(current, 2),
+                             _mm_srli_si128(previous, 14));
+
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi16(current, shifted));
+            lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(current, target));
+            previous = current;
+        }
+
+        if (SumLanesSSE2(lanes) >= HealthTest::APT_Cutoff) return false;
+    }
+
+    pairs = (_mm_movemask_epi8(equal) != 0);
+
+    return true;
+}
+#endif // TERRA_RANDOM_HEALTH_SSE2
+
+#ifdef TERRA_RANDOM_HEALTH_AVX2
+/*
+ *  SumLanesAVX2()
+ *
+ *  Description:
+ *      Sum the 8-bit lanes of a vector.
+ *
+ *  Parameters:
+ *      lanes [in]
+ *          The vector to sum.
+ *
+ *  Returns:
+ *      The sum of the lanes.
+ *
+ *  Comments:
+ *      None.
+ */
+__attribute__((target("avx2")))
+unsigned SumLanesAVX2(__m256i lanes) noexcept
+{
+    const __m256i sums = _mm256_sad_epu8(lanes, _mm256_setzero_si256());
+    const __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums),
+                                         _mm256_extracti128_si256(sums, 1));
+
+    return static_cast<unsigned>(_mm_cvtsi128_si32(halves) +
+                                 _mm_extract_epi16(halves, 4));
+}
+
+/*
+ *  ShiftPairAVX2()
+ *
+ *  Description:
+ *      Shift a vector by one 16-bit pair, bringing in the last pair of the
+ *      previous vector.
+ *
+ *  Parameters:
+ *      current [in]
+ *          The vector to shift.
+ *
+ *      previous [in]
+ *          The previous vector.
+ *
+ *  Returns:
+ *      The shifted vector.
+ *
+ *  Comments:
+ *      None.
+ */
+__attribute__((target("avx2")))
+__m256i ShiftPairAVX2(__m256i current, __m256i previous) noexcept
+{
+    return _mm256_alignr_epi8(
+        current,
+        _mm256_permute2x128_si256(previous, current, 0x21),
+        14);
+}
+
+/*
+ *  HasRepetitionAVX2()
+ *
+ *  Description:
+ *      Determine whether RCT_Cutoff consecutive octets are identical,
+ *      examining 32 octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine.
+ *
+ *  Returns:
+ *      True if RCT_Cutoff consecutive octets are identical.
+ *
+ *  Comments:
+ *      None.
+ */
+__attribute__((target("avx2")))
+bool HasRepetitionAVX2(std::span<const std::uint8_t> octets) noexcept
+{
+    const std::uint8_t *data = octets.data();
+    std::size_t i = 0;
+
+    if (octets.size() < 32) return HasRun(octets);
+
+    __m256i previous = _mm256_set1_epi16(
+        static_cast<short>(~(data[0] | (data[1] << 8))));
+    __m256i pairs = _mm256_setzero_si256();
+
+    for (; i + 32 <= octets.size(); i += 32)
+    {
+        const __m256i current =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+
+        pairs = _mm256_or_si256(
+            pairs,
+            _mm256_cmpeq_epi16(current, ShiftPairAVX2(current, previous)));
+        previous = current;
+    }
+
+    const bool found = !_mm256_testz_si256(pairs, pairs);
+
+    // Examine runs that do not contain two of the pairs compared
+    return HasRun(found ? octets : octets.subspan(i - 3));
+}
+
+/*
+ *  CountOctetAVX2()
+ *
+ *  Description:
+ *      Count the occurrences of an octet value, 32 octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine, of which there are at most
+ *          HealthTest::APT_Window.
+ *
+ *      value [in]
+ *          The value to count.
+ *
+ *  Returns:
+ *      The number of octets equal to the value.
+ *
+ *  Comments:
+ *      The window size bounds each lane's count, so the per-lane counts
+ *      cannot overflow.
+ */
+__attribute__((target("avx2")))
+unsigned CountOctetAVX2(std::span<const std::uint8_t> octets,
+                        std::uint8_t value) noexcept
+{
+    const __m256i target = _mm256_set1_epi8(static_cast<char>(value));
+    __m256i lanes = _mm256_setzero_si256();
+    std::size_t i = 0;
+
+    for (; i + 32 <= octets.size(); i += 32)
+    {
+        const __m256i current = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(octets.data() + i));
+
+        // Equal lanes are -1, so subtracting increments the lane's count
+        lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(current, target));
+    }
+
+    return SumLanesAVX2(lanes) +
+           CountOctetScalar(octets.subspan(i), value);
+}
+
+/*
+ *  ScanWindowsAVX2()
+ *
+ *  Description:
+ *      Apply the Adaptive Proportion Test to complete windows and look for
+ *      equal adjacent pairs, 32 octets at a time.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine, which are a multiple of APT_Window in
+ *          length and start at the start of a window.
+ *
+ *      pairs [out]
+ *          Set to true if equal adjacent pairs were found.
+ *
+ *  Returns:
+ *      True if the test passes for every window, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+__attribute__((target("avx2")))
+bool ScanWindowsAVX2(std::span<const std::uint8_t> octets,
+                     bool &pairs) noexcept
+{
+    const std::uint8_t *data = octets.data();
+    __m256i previous = _mm256_set1_epi16(
+        static_cast<short>(~(data[0] | (data[1] << 8))));
+    __m256i equal = _mm256_setzero_si256();
+
+    for (std::size_t window = 0;
+         window < octets.size();
+         window += HealthTest::APT_Window)
+    {
+        const __m256i target =
+            _mm256_set1_epi8(static_cast<char>(data[window]));
+        __m256i lanes = _mm256_setzero_si256();
+
+        // Two vectors are examined per iteration to reduce loop overhead
+        for (std::size_t i = window; i < window + HealthTest::APT_Window;
+             i += 64)
+        {
+            const __m256i first = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(data + i));
+            const __m256i second = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(data + i + 32));
+
+            equal = _mm256_or_si256(
+                equal,
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi16(first, ShiftPairAVX2(first, previous)),
+                    _mm256_cmpeq_epi16(second,
+                                       ShiftPairAVX2(second, first))));
+            lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(first, target));
+            lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(second, target));
+            previous = second;
+        }
+
+        if (SumLanesAVX2(lanes) >= HealthTest::APT_Cutoff) return false;
+    }
+
+    pairs = !_mm256_testz_si256(equal, equal);
+
+    return true;
+}
+
+/*
+ *  HaveAVX2()
+ *
+ *  Description:
+ *      Determine whether the processor supports AVX2.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if AVX2 is supported, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool HaveAVX2() noexcept
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    return avx2;
+}
+#endif // TERRA_RANDOM_HEALTH_AVX2
+
+/*
+ *  HasRepetition()
+ *
+ *  Description:
+ *      Determine whether RCT_Cutoff consecutive octets are identical.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine.
+ *
+ *  Returns:
+ *      True if RCT_Cutoff consecutive octets are identical.
+ *
+ *  Comments:
+ *      Runs that begin before these octets are found by the caller.
+ */
+bool HasRepetition(std::span<const std::uint8_t> octets) noexcept
+{
+#ifdef TERRA_RANDOM_HEALTH_AVX2
+    if (HaveAVX2()) return HasRepetitionAVX2(octets);
+#endif
+
+#ifdef TERRA_RANDOM_HEALTH_SSE2
+    return HasRepetitionSSE2(octets);
+#else
+    return HasRun(octets);
+#endif
+}
+
+/*
+ *  CountOctet()
+ *
+ *  Description:
+ *      Count the occurrences of an octet value.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine, of which there are at most
+ *          HealthTest::APT_Window.
+ *
+ *      value [in]
+ *          The value to count.
+ *
+ *  Returns:
+ *      The number of octets equal to the value.
+ *
+ *  Comments:
+ *      None.
+ */
+unsigned CountOctet(std::span<const std::uint8_t> octets,
+                    std::uint8_t value) noexcept
+{
+#ifdef TERRA_RANDOM_HEALTH_AVX2
+    if (HaveAVX2()) return CountOctetAVX2(octets, value);
+#endif
+
+#ifdef TERRA_RANDOM_HEALTH_SSE2
+    return CountOctetSSE2(octets, value);
+#else
+    return CountOctetScalar(octets, value);
+#endif
+}
+
+/*
+ *  ScanWindows()
+ *
+ *  Description:
+ *      Apply the Adaptive Proportion Test to complete windows and look for
+ *      equal adjacent pairs in a single pass.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to examine, which are a multiple of APT_Window in
+ *          length and start at the start of a window.
+ *
+ *      pairs [out]
+ *          Set to true if equal adjacent pairs were found (or might have
+ *          been), in which case the octets must be examined by HasRun().
+ *
+ *  Returns:
+ *      True if the test passes for every window, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ScanWindows(std::span<const std::uint8_t> octets, bool &pairs) noexcept
+{
+#ifdef TERRA_RANDOM_HEALTH_AVX2
+    if (HaveAVX2()) return ScanWindowsAVX2(octets, pairs);
+#endif
+
+#ifdef TERRA_RANDOM_HEALTH_SSE2
+    return ScanWindowsSSE2(octets, pairs);
+#else
+    return ScanWindowsScalar(octets, pairs);
+#endif
+}
+
+} // namespace
+
+/*
+ *  HealthTest::Test()
+ *
+ *  Description:
+ *      Apply the health tests to the next octets of the stream.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to test.
+ *
+ *  Returns:
+ *      True if the tests pass, false if either test fails.
+ *
+ *  Comments:
+ *      The current APT window is completed first, so that any complete
+ *      windows that follow can be tested in a single pass.  After a
+ *      failure, the tests continue from their state at the time of the
+ *      failure, so the caller should discard the octets and call Reset()
+ *      before the stream is tested again.
+ */
+bool HealthTest::Test(std::span<const std::uint8_t> octets) noexcept
+{
+    if (apt_position != 0)
+    {
+        const auto length =
+            std::min(octets.size(), APT_Window - apt_position);
+
+        if (!TestRepetition(octets.first(length)) ||
+            !TestProportion(octets.first(length)))
+        {
+            return false;
+        }
+
+        octets = octets.subspan(length);
+    }
+
+    const std::size_t length = octets.size() - octets.size() % APT_Window;
+
+    if (length > 0)
+    {
+        if (!TestWindows(octets.first(length))) return false;
+
+        octets = octets.subspan(length);
+    }
+
+    if (octets.empty()) return true;
+
+    return TestRepetition(octets) && TestProportion(octets);
+}
+
+/*
+ *  HealthTest::Reset()
+ *
+ *  Description:
+ *      Reset the state of the tests, as for a new stream of octets.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void HealthTest::Reset() noexcept
+{
+    *this = HealthTest();
+}
+
+/*
+ *  HealthTest::TestWindows()
+ *
+ *  Description:
+ *      Apply both tests to complete APT windows.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to test, which are a non-zero multiple of APT_Window
+ *          in length and start at the start of a window.
+ *
+ *  Returns:
+ *      True if the tests pass, false if either test fails.
+ *
+ *  Comments:
+ *      The octets are examined one at a time for runs only if the single
+ *      pass finds equal adjacent pairs.
+ */
+bool HealthTest::TestWindows(std::span<const std::uint8_t> octets) noexcept
+{
+    bool pairs = false;
+
+    if (!ContinueRun(octets)) return false;
+
+    if (!ScanWindows(octets, pairs)) return false;
+
+    if (pairs && HasRun(octets)) return false;
+
+    SaveRun(octets);
+
+    return true;
+}
+
+/*
+ *  HealthTest::TestRepetition()
+ *
+ *  Description:
+ *      Apply the Repetition Count Test.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to test, of which there is at least one.
+ *
+ *  Returns:
+ *      True if the test passes, false if it fails.
+ *
+ *  Comments:
+ *      Runs within these octets are found by HasRepetition().
+ */
+bool HealthTest::TestRepetition(std::span<const std::uint8_t> octets) noexcept
+{
+    if (!ContinueRun(octets)) return false;
+
+    if (octets.size() <= RCT_Span) return true;
+
+    if (HasRepetition(octets)) return false;
+
+    SaveRun(octets);
+
+    return true;
+}
+
+/*
+ *  HealthTest::TestProportion()
+ *
+ *  Description:
+ *      Apply the Adaptive Proportion Test.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to test.
+ *
+ *  Returns:
+ *      True if the test passes, false if it fails.
+ *
+ *  Comments:
+ *      The first octet of each window is counted as one occurrence, and
+ *      the rest of the window is counted with CountOctet().
+ */
+bool HealthTest::TestProportion(std::span<const std::uint8_t> octets) noexcept
+{
+    while (!octets.empty())
+    {
+        if (apt_position == 0)
+        {
+            apt_octet = octets.front();
+            apt_count = 1;
+            apt_position = 1;
+            octets = octets.subspan(1);
+            continue;
+        }
+
+        const std::size_t length =
+            std::min(octets.size(), APT_Window - apt_position);
+
+        apt_count += CountOctet(octets.first(length), apt_octet);
+        if (apt_count >= APT_Cutoff) return false;
+
+        apt_position = (apt_position + length) % APT_Window;
+        octets = octets.subspan(length);
+    }
+
+    return true;
+}
+
+/*
+ *  HealthTest::ContinueRun()
+ *
+ *  Description:
+ *      Count the octets at the start of the span that continue the run at
+ *      the end of the prior octets.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to test.
+ *
+ *  Returns:
+ *      True if the run remains shorter than RCT_Cutoff, false if not.
+ *
+ *  Comments:
+ *      Only the first RCT_Span octets can complete a prior run.
+ */
+bool HealthTest::ContinueRun(std::span<const std::uint8_t> octets) noexcept
+{
+    const std::size_t prefix = std::min(octets.size(), RCT_Span);
+
+    for (std::size_t i = 0; i < prefix; i++)
+    {
+        rct_count = (rct_count > 0) && (octets[i] == rct_octet) ?
+                        rct_count + 1 :
+                        1;
+        rct_octet = octets[i];
+        if (rct_count >= RCT_Cutoff) return false;
+    }
+
+    return true;
+}
+
+/*
+ *  HealthTest::SaveRun()
+ *
+ *  Description:
+ *      Count the run at the end of the octets for the next call.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets tested, of which there are more than RCT_Span and
+ *          which do not contain a run of RCT_Cutoff identical octets.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The run is shorter than the octets, so it does not continue a prior
+ *      run.
+ */
+void HealthTest::SaveRun(std::span<const std::uint8_t> octets) noexcept
+{
+    rct_octet = octets.back();
+    rct_count = 1;
+    while ((rct_count < octets.size()) &&
+           (octets[octets.size() - 1 - rct_count] == rct_octet))
+    {
+        rct_count++;
+    }
+}
+
+} // namespace Terra::Random
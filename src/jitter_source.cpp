@@ -0,0 +1,301 @@
+/*
+ *  jitter_source.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the JitterSource object.
+ *
+ *  Portability Issues:
+ *      The processor's time stamp counter is used on x86 processors.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define TERRA_RANDOM_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define TERRA_RANDOM_TSC
+#else
+#include <chrono>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <terra/random/jitter_source.h>
+#include "siphash.h"
+#include "little_endian.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Samples hashed to produce each 64 bits of output
+constexpr std::size_t Samples_Per_Output = JitterSource::Oversampling * 64;
+
+// Number of times the timer may run backward during the startup test
+constexpr unsigned Backward_Limit = 3;
+
+/*
+ *  Timestamp()
+ *
+ *  Description:
+ *      Read the highest-resolution timer available.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The current time in timer-specific units.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint64_t Timestamp() noexcept
+{
+#ifdef TERRA_RANDOM_TSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+} // namespace
+
+/*
+ *  JitterSource::JitterSource()
+ *
+ *  Description:
+ *      Constructor for the JitterSource object, which performs the startup
+ *      health test.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The result of the startup health test is given by IsHealthy().
+ */
+JitterSource::JitterSource() : JitterSource(Timestamp)
+{
+}
+
+/*
+ *  JitterSource::JitterSource()
+ *
+ *  Description:
+ *      Constructor for the JitterSource object that reads the given timer,
+ *      which performs the startup health test.
+ *
+ *  Parameters:
+ *      timer [in]
+ *          The function used to read the timer.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The source is unhealthy if the repetition count test fails during
+ *      the startup samples, even if the other startup tests pass.
+ */
+JitterSource::JitterSource(Timer timer) :
+    timer{timer},
+    memory(Memory_Size),
+    memory_position{0},
+    last_time{timer()},
+    last_delta{0},
+    last_delta2{0},
+    stuck_count{0},
+    key{0x6a69'7474'6572'0000, Memory_Size},
+    healthy{true}
+{
+    unsigned stuck = 0;
+    unsigned backward = 0;
+    bool advanced = false;
+
+    for (unsigned i = 0; i < Startup_Samples; i++)
+    {
+        std::uint64_t delta = Sample();
+
+        // A delta with the top bit set means the timer ran backward
+        if (delta >> 63)
+        {
+            backward++;
+        }
+        else if (delta != 0)
+        {
+            advanced = true;
+        }
+
+        if (IsStuck(delta)) stuck++;
+    }
+
+    healthy = healthy && advanced && (backward <= Backward_Limit) &&
+              (stuck < Startup_Samples * 9 / 10);
+    stuck_count = 0;
+}
+
+/*
+ *  JitterSource::Read()
+ *
+ *  Description:
+ *      Read random octets produced from timing jitter.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *  Returns:
+ *      A count of the number of octets placed into the buffer.  This may be
+ *      smaller than the size of the span if a health test fails.
+ *
+ *  Comments:
+ *      Each 8 octets require Oversampling * 64 samples, so this is slow.
+ */
+std::size_t JitterSource::Read(std::span<std::uint8_t> buffer) noexcept
+{
+    std::size_t octets_sourced = 0;
+
+    while (octets_sourced < buffer.size())
+    {
+        std::uint64_t value;
+        std::array<std::uint8_t, 8> octets;
+
+        if (!Generate(value)) break;
+
+        StoreLittleEndian(octets.data(), value);
+        std::size_t length = std::min(octets.size(),
+                                      buffer.size() - octets_sourced);
+        std::memcpy(buffer.data() + octets_sourced, octets.data(), length);
+        octets_sourced += length;
+    }
+
+    return octets_sourced;
+}
+
+/*
+ *  JitterSource::Sample()
+ *
+ *  Description:
+ *      Take one sample, which is the time taken to perform a loop of memory
+ *      accesses (plus the time since the prior sample was taken).
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The time elapsed since the prior sample was taken.
+ *
+ *  Comments:
+ *      The number of accesses varies with the low-order bits of the timer
+ *      and each access touches a different cache line, which increases the
+ *      variation in timing.
+ */
+std::uint64_t JitterSource::Sample() noexcept
+{
+    const unsigned accesses = Memory_Accesses +
+                              static_cast<unsigned>(last_time & 0x1f);
+
+    for (unsigned i = 0; i < accesses; i++)
+    {
+        memory[memory_position]++;
+        memory_position = (memory_position + Memory_Stride) % Memory_Size;
+    }
+
+    const std::uint64_t now = timer();
+    const std::uint64_t delta = now - last_time;
+    last_time = now;
+
+    return delta;
+}
+
+/*
+ *  JitterSource::IsStuck()
+ *
+ *  Description:
+ *      Determine whether a sample is stuck, updating the repetition count
+ *      health test.
+ *
+ *  Parameters:
+ *      delta [in]
+ *          The sample.
+ *
+ *  Returns:
+ *      True if the sample or its first or second difference is zero.
+ *
+ *  Comments:
+ *      The source becomes unhealthy if Stuck_Cutoff consecutive samples
+ *      are stuck.
+ */
+bool JitterSource::IsStuck(std::uint64_t delta) noexcept
+{
+    const std::uint64_t delta2 = delta - last_delta;
+    const std::uint64_t delta3 = delta2 - last_delta2;
+
+    last_delta = delta;
+    last_delta2 = delta2;
+
+    if ((delta == 0) || (delta2 == 0) || (delta3 == 0))
+    {
+        if (++stuck_count >= Stuck_Cutoff) healthy = false;
+        return true;
+    }
+
+    stuck_count = 0;
+
+    return false;
+}
+
+/*
+ *  JitterSource::Generate()
+ *
+ *  Description:
+ *      Produce 64 bits of output.
+ *
+ *  Parameters:
+ *      value [out]
+ *          The output value.
+ *
+ *  Returns:
+ *      True if the value was produced, false if the source is unhealthy.
+ *
+ *  Comments:
+ *      Samples that are not stuck are hashed with SipHash, keyed with the
+ *      half of the prior hash that was not output, so that any entropy in
+ *      excess of 64 bits carries forward to the next value.
+ */
+bool JitterSource::Generate(std::uint64_t &value) noexcept
+{
+    std::array<std::uint8_t, Samples_Per_Output * 8> samples;
+    std::size_t count = 0;
+
+    while (healthy && (count < Samples_Per_Output))
+    {
+        std::uint64_t delta = Sample();
+
+        if (IsStuck(delta)) continue;
+
+        StoreLittleEndian(samples.data() + 8 * count++, delta);
+    }
+
+    if (!healthy) return false;
+
+    auto hash = SipHash128(key, samples);
+
+    value = hash[0];
+    key = {hash[1], key[0]};
+
+    return true;
+}
+
+} // namespace Terra::Random
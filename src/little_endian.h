@@ -0,0 +1,51 @@
+/*
+ *  little_endian.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines functions to store and load integers
+ *      in little-endian order, which is the order used for saved state.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Terra::Random
+{
+
+// Store a value in little-endian order
+template<typename T>
+constexpr void StoreLittleEndian(std::uint8_t *octets, T value) noexcept
+{
+    for (std::size_t i = 0; i < sizeof(T); i++)
+    {
+        octets[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+// Load a value stored in little-endian order
+template<typename T>
+constexpr T LoadLittleEndian(const std::uint8_t *octets) noexcept
+{
+    T value = 0;
+
+    for (std::size_t i = 0; i < sizeof(T); i++)
+    {
+        value |= static_cast<T>(static_cast<T>(octets[i]) << (8 * i));
+    }
+
+    return value;
+}
+
+} // namespace Terra::Random
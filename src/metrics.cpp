@@ -0,0 +1,423 @@
+/*
+ *  metrics.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the per-thread metrics, the LatencyHistogram
+ *      object, and the functions that report the metrics.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <memory>
+#include <new>
+#include "metrics.h"
+
+namespace Terra::Random
+{
+
+std::atomic<bool> metrics_timing{false};
+
+namespace
+{
+
+struct Registration;
+
+// The metrics of all running threads and the totals of exited threads
+struct MetricsRegistry
+{
+    MetricsRegistry() { retired.histograms = &retired_histograms; }
+
+    std::mutex mutex;
+    Registration *threads = nullptr;
+    ThreadMetrics retired;
+    ThreadHistograms retired_histograms;
+};
+
+/*
+ *  GetRegistry()
+ *
+ *  Description:
+ *      Return the process-wide metrics registry.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the registry.
+ *
+ *  Comments:
+ *      The registry is never destroyed, since threads may exit (and so
+ *      unregister) after static objects are destroyed.
+ */
+MetricsRegistry &GetRegistry()
+{
+    static MetricsRegistry *registry = new MetricsRegistry;
+
+    return *registry;
+}
+
+/*
+ *  AddMetrics()
+ *
+ *  Description:
+ *      Add one set of metrics to another.
+ *
+ *  Parameters:
+ *      total [in/out]
+ *          The metrics to which the others are added.  It is not updated
+ *          concurrently.
+ *
+ *      metrics [in]
+ *          The metrics to add.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The registry mutex must be held.
+ */
+void AddMetrics(ThreadMetrics &total, const ThreadMetrics &metrics) noexcept
+{
+    auto add = [](std::atomic<std::uint64_t> &to,
+                  const std::atomic<std::uint64_t> &from)
+    {
+        to.store(to.load(std::memory_order_relaxed) +
+                     from.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+    };
+
+    for (std::size_t i = 0; i < total.counters.size(); i++)
+    {
+        add(total.counters[i], metrics.counters[i]);
+    }
+
+    if (metrics.histograms == nullptr) return;
+
+    for (std::size_t i = 0; i < total.histograms->size(); i++)
+    {
+        ThreadHistogram &to = (*total.histograms)[i];
+        const ThreadHistogram &from = (*metrics.histograms)[i];
+
+        for (std::size_t j = 0; j < to.buckets.size(); j++)
+        {
+            add(to.buckets[j], from.buckets[j]);
+        }
+        add(to.sum, from.sum);
+        to.maximum.store(
+            std::max(to.maximum.load(std::memory_order_relaxed),
+                     from.maximum.load(std::memory_order_relaxed)),
+            std::memory_order_relaxed);
+    }
+}
+
+// Links a thread's metrics into the registry for the life of the thread;
+// if the histograms cannot be allocated, only the counters are kept
+struct Registration
+{
+    Registration() noexcept :
+        histograms{new (std::nothrow) ThreadHistograms}
+    {
+        MetricsRegistry &registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        next = registry.threads;
+        if (next != nullptr) next->previous = this;
+        registry.threads = this;
+        thread_metrics.histograms = histograms.get();
+        thread_metrics.registered = true;
+    }
+
+    ~Registration()
+    {
+        MetricsRegistry &registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        AddMetrics(registry.retired, *metrics);
+
+        if (previous != nullptr)
+        {
+            previous->next = next;
+        }
+        else
+        {
+            registry.threads = next;
+        }
+        if (next != nullptr) next->previous = previous;
+
+        thread_metrics.histograms = nullptr;
+    }
+
+    ThreadMetrics *metrics = &thread_metrics;
+    std::unique_ptr<ThreadHistograms> histograms;
+    Registration *previous = nullptr;
+    Registration *next = nullptr;
+};
+
+} // namespace
+
+/*
+ *  RegisterThreadMetrics()
+ *
+ *  Description:
+ *      Register the calling thread's metrics so that they are included in
+ *      GetGeneratorMetrics().
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      When the thread exits, its metrics are added to the retired totals.
+ *      Anything counted by the thread after that (e.g., by the destructors
+ *      of other thread-local objects) is not reported.
+ */
+void RegisterThreadMetrics() noexcept
+{
+    thread_local Registration registration;
+}
+
+/*
+ *  LatencyHistogram::Record()
+ *
+ *  Description:
+ *      Record a latency.
+ *
+ *  Parameters:
+ *      nanoseconds [in]
+ *          The latency in nanoseconds.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void LatencyHistogram::Record(std::uint64_t nanoseconds) noexcept
+{
+    buckets[GetBucket(nanoseconds)]++;
+    sum += nanoseconds;
+    maximum = std::max(maximum, nanoseconds);
+}
+
+/*
+ *  LatencyHistogram::Merge()
+ *
+ *  Description:
+ *      Add the latencies recorded in another histogram to this one.
+ *
+ *  Parameters:
+ *      other [in]
+ *          The histogram to merge into this one.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This combines histograms recorded by different threads (or
+ *      processes) exactly, as all histograms have the same buckets.
+ */
+void LatencyHistogram::Merge(const LatencyHistogram &other) noexcept
+{
+    for (std::size_t i = 0; i < Bucket_Count; i++)
+    {
+        buckets[i] += other.buckets[i];
+    }
+    sum += other.sum;
+    maximum = std::max(maximum, other.maximum);
+}
+
+/*
+ *  LatencyHistogram::GetCount()
+ *
+ *  Description:
+ *      Return the number of latencies recorded.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The number of latencies recorded.
+ *
+ *  Comments:
+ *      None.
+ */
+std::uint64_t LatencyHistogram::GetCount() const noexcept
+{
+    std::uint64_t count = 0;
+
+    for (auto bucket : buckets) count += bucket;
+
+    return count;
+}
+
+/*
+ *  LatencyHistogram::GetPercentile()
+ *
+ *  Description:
+ *      Return the latency at or below which the given percentage of the
+ *      recorded latencies fall.
+ *
+ *  Parameters:
+ *      percentile [in]
+ *          The percentile, from 0 to 100 (e.g., 99.9).
+ *
+ *  Returns:
+ *      The limit of the bucket holding the percentile, but no more than the
+ *      maximum recorded latency, or 0 if no latencies were recorded.
+ *
+ *  Comments:
+ *      The result is no more than 1/Sub_Bucket_Count above the true value.
+ */
+std::uint64_t LatencyHistogram::GetPercentile(
+                                        double percentile) const noexcept
+{
+    const std::uint64_t count = GetCount();
+
+    if (count == 0) return 0;
+
+    // The rank of the latency, counting from 1
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(count)));
+    rank = std::clamp<std::uint64_t>(rank, 1, count);
+
+    std::uint64_t cumulative = 0;
+
+    for (std::size_t i = 0; i < Bucket_Count; i++)
+    {
+        cumulative += buckets[i];
+        if (cumulative >= rank) return std::min(GetBucketLimit(i), maximum);
+    }
+
+    return maximum;
+}
+
+/*
+ *  GetGeneratorMetrics()
+ *
+ *  Description:
+ *      Return the counters and latency histograms summed over all threads.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The metrics of all running threads plus those of exited threads.
+ *
+ *  Comments:
+ *      Threads continue to update their metrics while they are summed, so
+ *      the counters and histograms are not necessarily consistent with each
+ *      other.  No memory is allocated.
+ */
+GeneratorMetrics GetGeneratorMetrics()
+{
+    ThreadHistograms histograms;
+    ThreadMetrics total;
+    MetricsRegistry &registry = GetRegistry();
+
+    total.histograms = &histograms;
+
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        AddMetrics(total, registry.retired);
+        for (const Registration *thread = registry.threads;
+             thread != nullptr;
+             thread = thread->next)
+        {
+            AddMetrics(total, *thread->metrics);
+        }
+    }
+
+    GeneratorMetrics metrics{};
+    auto counter = [&total](Counter counter)
+    {
+        return total.counters[static_cast<std::size_t>(counter)].load(
+            std::memory_order_relaxed);
+    };
+    auto convert = [&histograms](Latency latency, LatencyHistogram &to)
+    {
+        const ThreadHistogram &from =
+            histograms[static_cast<std::size_t>(latency)];
+
+        for (std::size_t i = 0; i < LatencyHistogram::Bucket_Count; i++)
+        {
+            to.buckets[i] = from.buckets[i].load(std::memory_order_relaxed);
+        }
+        to.sum = from.sum.load(std::memory_order_relaxed);
+        to.maximum = from.maximum.load(std::memory_order_relaxed);
+    };
+
+    convert(Latency::Source, metrics.source_latency);
+    convert(Latency::Refill, metrics.refill_latency);
+
+    metrics.counters = {counter(Counter::OctetsServed),
+                        counter(Counter::SourceOctets),
+                        counter(Counter::SystemCalls),
+                        counter(Counter::ShortReads),
+                        counter(Counter::Fallbacks),
+                        counter(Counter::Reseeds),
+                        counter(Counter::PoolRefills),
+                        counter(Counter::HealthFailures),
+                        counter(Counter::SourcesDisabled),
+                        metrics.source_latency.GetSum()};
+
+    return metrics;
+}
+
+/*
+ *  GetGeneratorCounters()
+ *
+ *  Description:
+ *      Return the counters summed over all threads.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The counters of all running threads plus those of exited threads.
+ *
+ *  Comments:
+ *      See GetGeneratorMetrics().
+ */
+GeneratorCounters GetGeneratorCounters()
+{
+    return GetGeneratorMetrics().counters;
+}
+
+/*
+ *  SetGeneratorTiming()
+ *
+ *  Description:
+ *      Enable or disable measuring the time spent reading random sources.
+ *
+ *  Parameters:
+ *      enabled [in]
+ *          True to measure the time, false to stop measuring it.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Timing is disabled by default, since reading the clock twice costs
+ *      about as much as a small request served without a system call.
+ */
+void SetGeneratorTiming(bool enabled) noexcept
+{
+    metrics_timing.store(enabled, std::memory_order_relaxed);
+}
+
+} // namespace Terra::Random
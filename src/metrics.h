@@ -0,0 +1,211 @@
+/*
+ *  metrics.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines the per-thread metrics updated by the
+ *      generators and random sources (see generator_metrics.h).
+ *
+ *      The counters are held in a thread-local object, while the larger
+ *      latency histograms are allocated when a thread first records a
+ *      metric, so threads that never use a generator need little memory.
+ *
+ *      Each thread's metrics are written only by that thread, so a counter
+ *      is incremented with a relaxed load and store rather than an atomic
+ *      read-modify-write, which avoids a locked instruction.  Other threads
+ *      only read the counters.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <terra/random/generator_metrics.h>
+
+namespace Terra::Random
+{
+
+// The counters maintained for each thread
+enum class Counter : std::size_t
+{
+    OctetsServed,
+    SourceOctets,
+    SystemCalls,
+    ShortReads,
+    Fallbacks,
+    Reseeds,
+    PoolRefills,
+    HealthFailures,
+    SourcesDisabled,
+    Count
+};
+
+// The latencies recorded for each thread
+enum class Latency : std::size_t
+{
+    Source,
+    Refill,
+    Count
+};
+
+struct ThreadHistogram
+{
+    std::array<std::atomic<std::uint64_t>, LatencyHistogram::Bucket_Count>
+        buckets{};
+    std::atomic<std::uint64_t> sum{};
+    std::atomic<std::uint64_t> maximum{};
+};
+
+using ThreadHistograms =
+    std::array<ThreadHistogram, static_cast<std::size_t>(Latency::Count)>;
+
+struct ThreadMetrics
+{
+    std::array<std::atomic<std::uint64_t>,
+               static_cast<std::size_t>(Counter::Count)> counters{};
+    ThreadHistograms *histograms = nullptr;
+    bool registered = false;
+};
+
+// The calling thread's metrics, which need no dynamic initialization so that
+// accessing them requires no initialization check by the compiler
+inline constinit thread_local ThreadMetrics thread_metrics{};
+
+void RegisterThreadMetrics() noexcept;
+
+// Whether the time spent reading random sources is measured
+extern std::atomic<bool> metrics_timing;
+
+/*
+ *  CountMetric()
+ *
+ *  Description:
+ *      Add to one of the calling thread's counters.
+ *
+ *  Parameters:
+ *      counter [in]
+ *          The counter to update.
+ *
+ *      value [in]
+ *          The value to add.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Only the owning thread writes the counter, so no atomic
+ *      read-modify-write is required.  The thread's metrics are registered
+ *      when first updated.
+ */
+inline void CountMetric(Counter counter, std::uint64_t value = 1) noexcept
+{
+    if (!thread_metrics.registered) RegisterThreadMetrics();
+
+    auto &element = thread_metrics.counters[static_cast<std::size_t>(counter)];
+
+    element.store(element.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+}
+
+/*
+ *  RecordLatency()
+ *
+ *  Description:
+ *      Record a latency in one of the calling thread's histograms.
+ *
+ *  Parameters:
+ *      latency [in]
+ *          The histogram to update.
+ *
+ *      nanoseconds [in]
+ *          The latency in nanoseconds.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Nothing is recorded if the histograms could not be allocated.
+ */
+inline void RecordLatency(Latency latency, std::uint64_t nanoseconds) noexcept
+{
+    if (!thread_metrics.registered) RegisterThreadMetrics();
+    if (thread_metrics.histograms == nullptr) return;
+
+    ThreadHistogram &histogram =
+        (*thread_metrics.histograms)[static_cast<std::size_t>(latency)];
+    auto &bucket = histogram.buckets[LatencyHistogram::GetBucket(nanoseconds)];
+
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    histogram.sum.store(
+        histogram.sum.load(std::memory_order_relaxed) + nanoseconds,
+        std::memory_order_relaxed);
+    if (nanoseconds > histogram.maximum.load(std::memory_order_relaxed))
+    {
+        histogram.maximum.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+/*
+ *  IsMetricsTiming()
+ *
+ *  Description:
+ *      Determine whether the time spent reading random sources is measured.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if timing is enabled, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+inline bool IsMetricsTiming() noexcept
+{
+    return metrics_timing.load(std::memory_order_relaxed);
+}
+
+// Records the time until destroyed in a latency histogram, if timing
+class LatencyTimer
+{
+    public:
+        explicit LatencyTimer(Latency latency,
+                              bool timing = IsMetricsTiming()) noexcept :
+            latency{latency},
+            timing{timing}
+        {
+            if (timing) start = std::chrono::steady_clock::now();
+        }
+        LatencyTimer(const LatencyTimer &) = delete;
+        ~LatencyTimer()
+        {
+            if (!timing) return;
+
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            RecordLatency(latency,
+                          static_cast<std::uint64_t>(
+                              std::chrono::duration_cast<
+                                  std::chrono::nanoseconds>(elapsed).count()));
+        }
+        LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+    protected:
+        const Latency latency;
+        const bool timing;
+        std::chrono::steady_clock::time_point start;
+};
+
+} // namespace Terra::Random
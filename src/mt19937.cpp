@@ -0,0 +1,423 @@
+/*
+ *  mt19937.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the MT19937 object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <vector>
+#include <terra/random/mt19937.h>
+#include "f2_polynomial.h"
+#include "little_endian.h"
+#include "seed_sequence.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Below this many steps, it is faster to step than to use a polynomial jump
+constexpr std::uint64_t Jump_Threshold = std::uint64_t(1) << 22;
+
+// State of the engine as used to evaluate the jump polynomial
+struct CircularState
+{
+    std::array<std::uint32_t, MT19937::State_Size> state;
+    std::size_t index;
+};
+
+/*
+ *  GetModulus()
+ *
+ *  Description:
+ *      Return the characteristic polynomial of MT19937, which is computed
+ *      once from the engine's output when first needed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The characteristic polynomial of degree 19937.
+ *
+ *  Comments:
+ *      None.
+ */
+const F2Modulus &GetModulus()
+{
+    static const F2Modulus modulus = []()
+    {
+        constexpr std::size_t Degree = 19937;
+        MT19937 engine;
+        std::vector<bool> sequence(2 * Degree);
+
+        for (std::size_t i = 0; i < sequence.size(); i++)
+        {
+            sequence[i] = (engine() & 1) != 0;
+        }
+
+        return F2Modulus(MinimalPolynomial(sequence));
+    }();
+
+    return modulus;
+}
+
+/*
+ *  Step()
+ *
+ *  Description:
+ *      Advance the given state by one step (i.e., one output word).
+ *
+ *  Parameters:
+ *      circular [in/out]
+ *          The state to advance.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is the same recurrence as MT19937::operator()(), without the
+ *      tempering that is not needed to advance the state.
+ */
+void Step(CircularState &circular) noexcept
+{
+    constexpr std::size_t N = MT19937::State_Size;
+    auto &state = circular.state;
+    std::size_t index = circular.index;
+    std::size_t next = (index + 1 == N) ? 0 : index + 1;
+    std::size_t middle = (index + 397 >= N) ? index + 397 - N : index + 397;
+
+    std::uint32_t y = (state[index] & 0x8000'0000) |
+                      (state[next] & 0x7fff'ffff);
+    state[index] = state[middle] ^ (y >> 1) ^ ((y & 1) ? 0x9908'b0df : 0);
+    circular.index = next;
+}
+
+/*
+ *  Add()
+ *
+ *  Description:
+ *      Add (XOR) one state into another, aligning the oldest words.
+ *
+ *  Parameters:
+ *      result [in/out]
+ *          The state into which the other state is added.
+ *
+ *      other [in]
+ *          The state to add.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Add(CircularState &result, const CircularState &other) noexcept
+{
+    constexpr std::size_t N = MT19937::State_Size;
+    std::size_t i = result.index;
+    std::size_t j = other.index;
+
+    for (std::size_t k = 0; k < N; k++)
+    {
+        result.state[i] ^= other.state[j];
+        if (++i == N) i = 0;
+        if (++j == N) j = 0;
+    }
+}
+
+/*
+ *  ApplyJump()
+ *
+ *  Description:
+ *      Advance the given engine state using a polynomial jump.
+ *
+ *  Parameters:
+ *      state [in/out]
+ *          The engine state words.
+ *
+ *      index [in/out]
+ *          The index of the oldest word in the engine state.
+ *
+ *      polynomial [in]
+ *          The jump polynomial x^(n - 1) mod p(x) to advance n steps.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The lower 31 bits of the oldest state word are never used again, so
+ *      the transition matrix is singular.  Its image, however, is invariant
+ *      and annihilated by the characteristic polynomial.  So, the state is
+ *      stepped once and then advanced by the remaining n - 1 steps, which is
+ *      why the polynomial is for n - 1 steps.
+ */
+void ApplyJump(std::array<std::uint32_t, MT19937::State_Size> &state,
+               std::size_t &index,
+               const F2Polynomial &polynomial)
+{
+    CircularState circular{state, index};
+    CircularState zero{};
+
+    // Step once to move the state into the invariant subspace
+    Step(circular);
+    zero.index = circular.index;
+
+    F2Evaluate(polynomial, circular, zero, Step, Add);
+
+    state = circular.state;
+    index = circular.index;
+}
+
+} // namespace
+
+/*
+ *  MT19937::MT19937()
+ *
+ *  Description:
+ *      Constructor for the MT19937 object.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value with which to seed the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+MT19937::MT19937(result_type seed) noexcept
+{
+    Seed(seed);
+}
+
+/*
+ *  MT19937::MT19937()
+ *
+ *  Description:
+ *      Constructor for the MT19937 object.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data used to initialize the full state of the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+MT19937::MT19937(std::span<const std::uint32_t> seed_data)
+{
+    Seed(seed_data);
+}
+
+/*
+ *  MT19937::Seed()
+ *
+ *  Description:
+ *      Seed the engine using a single value.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value with which to seed the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is the same initialization as std::mt19937::seed().
+ */
+void MT19937::Seed(result_type seed) noexcept
+{
+    state[0] = seed;
+    for (std::size_t i = 1; i < State_Size; i++)
+    {
+        state[i] = 1'812'433'253U * (state[i - 1] ^ (state[i - 1] >> 30)) +
+                   static_cast<std::uint32_t>(i);
+    }
+    index = 0;
+}
+
+/*
+ *  MT19937::Seed()
+ *
+ *  Description:
+ *      Seed the full state of the engine from the given seed data.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data that is expanded as by std::seed_seq.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is the same initialization as std::mt19937::seed(std::seed_seq),
+ *      including the guard against an all-zero state.
+ */
+void MT19937::Seed(std::span<const std::uint32_t> seed_data)
+{
+    GenerateSeedSequence(seed_data, state);
+
+    bool zero = (state[0] & 0x8000'0000) == 0;
+    for (std::size_t i = 1; zero && (i < State_Size); i++)
+    {
+        zero = (state[i] == 0);
+    }
+    if (zero) state[0] = 0x8000'0000;
+
+    index = 0;
+}
+
+/*
+ *  MT19937::Discard()
+ *
+ *  Description:
+ *      Advance the engine as if the given number of values were produced.
+ *
+ *  Parameters:
+ *      count [in]
+ *          The number of values to discard.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Small counts are stepped; larger counts use a polynomial jump, whose
+ *      cost is logarithmic in the count.
+ */
+void MT19937::Discard(std::uint64_t count)
+{
+    if (count < Jump_Threshold)
+    {
+        while (count-- > 0) (*this)();
+        return;
+    }
+
+    ApplyJump(state, index, GetModulus().PowerOfX(count - 1));
+}
+
+/*
+ *  MT19937::Jump()
+ *
+ *  Description:
+ *      Advance the engine by 2^128 steps.  This may be used to produce
+ *      non-overlapping sub-sequences for parallel computations.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The jump polynomial is computed once and cached.
+ */
+void MT19937::Jump()
+{
+    static const F2Polynomial polynomial = GetModulus().PowerOfX(
+        std::array<std::uint64_t, 2>{~std::uint64_t(0), ~std::uint64_t(0)});
+
+    ApplyJump(state, index, polynomial);
+}
+
+/*
+ *  MT19937::LongJump()
+ *
+ *  Description:
+ *      Advance the engine by 2^192 steps.  This may be used to produce
+ *      non-overlapping groups of sub-sequences, each of which may then be
+ *      split using Jump().
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The jump polynomial is computed once and cached.
+ */
+void MT19937::LongJump()
+{
+    static const F2Polynomial polynomial = GetModulus().PowerOfX(
+        std::array<std::uint64_t, 3>{
+            ~std::uint64_t(0), ~std::uint64_t(0), ~std::uint64_t(0)});
+
+    ApplyJump(state, index, polynomial);
+}
+
+/*
+ *  MT19937::SaveState()
+ *
+ *  Description:
+ *      Save the state of the engine.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The array into which the state is saved.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The state words are followed by the index of the oldest word.
+ */
+void MT19937::SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept
+{
+    for (std::size_t i = 0; i < State_Size; i++)
+    {
+        StoreLittleEndian(octets.data() + 4 * i, state[i]);
+    }
+    StoreLittleEndian(octets.data() + 4 * State_Size,
+                      static_cast<std::uint32_t>(index));
+}
+
+/*
+ *  MT19937::LoadState()
+ *
+ *  Description:
+ *      Load the state of the engine previously saved with SaveState().
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The array from which the state is loaded.
+ *
+ *  Returns:
+ *      True if the state was loaded, false if it is invalid, in which case
+ *      the engine is unchanged.
+ *
+ *  Comments:
+ *      The index must be in range.
+ */
+bool MT19937::LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept
+{
+    auto saved_index = LoadLittleEndian<std::uint32_t>(octets.data() +
+                                                       4 * State_Size);
+
+    if (saved_index >= State_Size) return false;
+
+    for (std::size_t i = 0; i < State_Size; i++)
+    {
+        state[i] = LoadLittleEndian<std::uint32_t>(octets.data() + 4 * i);
+    }
+    index = saved_index;
+
+    return true;
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,136 @@
+/*
+ *  octet_ring.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines the OctetRing object, which is a
+ *      lock-free single-producer, single-consumer ring buffer of octets.
+ *
+ *      The producer and consumer positions increase monotonically and are
+ *      reduced modulo the (power of two) capacity only when indexing the
+ *      buffer.  Each side keeps a cached copy of the other side's position
+ *      so that the shared positions are only read when the cached value
+ *      indicates the ring is full (or empty), which keeps the cache lines
+ *      holding the positions from bouncing between cores on every call.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <bit>
+#include <span>
+
+namespace Terra::Random
+{
+
+class OctetRing
+{
+    public:
+        // Capacity is rounded up to a power of two
+        explicit OctetRing(std::size_t capacity) :
+            capacity{std::bit_ceil(std::max<std::size_t>(capacity, 64))},
+            buffer{std::make_unique<std::uint8_t[]>(this->capacity)},
+            head{0},
+            cached_tail{0},
+            tail{0},
+            cached_head{0}
+        {
+        }
+
+        // Producer: append as many octets as fit, returning the number written
+        std::size_t Write(std::span<const std::uint8_t> octets) noexcept
+        {
+            std::uint64_t position = head.load(std::memory_order_relaxed);
+
+            if (capacity - (position - cached_tail) < octets.size())
+            {
+                cached_tail = tail.load(std::memory_order_acquire);
+            }
+
+            std::size_t length = std::min<std::size_t>(
+                octets.size(),
+                capacity - static_cast<std::size_t>(position - cached_tail));
+            if (length == 0) return 0;
+
+            std::size_t offset = position & (capacity - 1);
+            if (length <= capacity - offset)
+            {
+                std::memcpy(buffer.get() + offset, octets.data(), length);
+            }
+            else
+            {
+                std::size_t first = capacity - offset;
+                std::memcpy(buffer.get() + offset, octets.data(), first);
+                std::memcpy(buffer.get(),
+                            octets.data() + first,
+                            length - first);
+            }
+
+            head.store(position + length, std::memory_order_release);
+
+            return length;
+        }
+
+        // Consumer: return the contiguous octets available to be read, which
+        // may be fewer than all available octets if the data wraps
+        std::span<const std::uint8_t> Peek() noexcept
+        {
+            std::uint64_t position = tail.load(std::memory_order_relaxed);
+
+            if (cached_head == position)
+            {
+                cached_head = head.load(std::memory_order_acquire);
+            }
+
+            std::size_t offset = position & (capacity - 1);
+            std::size_t length = std::min<std::size_t>(
+                static_cast<std::size_t>(cached_head - position),
+                capacity - offset);
+
+            return {buffer.get() + offset, length};
+        }
+
+        // Consumer: release octets previously returned by Peek()
+        void Consume(std::size_t length) noexcept
+        {
+            tail.store(tail.load(std::memory_order_relaxed) + length,
+                       std::memory_order_release);
+        }
+
+        // Either side: true if all written octets have been consumed
+        bool Empty() const noexcept
+        {
+            return tail.load(std::memory_order_acquire) ==
+                   head.load(std::memory_order_acquire);
+        }
+
+    protected:
+        static constexpr std::size_t Cache_Line_Size = 64;
+
+        const std::size_t capacity;
+        const std::unique_ptr<std::uint8_t[]> buffer;
+
+        // Producer-owned data
+        alignas(Cache_Line_Size) std::atomic<std::uint64_t> head;
+        std::uint64_t cached_tail;
+
+        // Consumer-owned data
+        alignas(Cache_Line_Size) std::atomic<std::uint64_t> tail;
+        std::uint64_t cached_head;
+};
+
+} // namespace Terra::Random
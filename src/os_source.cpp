@@ -0,0 +1,1106 @@
+/*
+ *  os_source.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the OSSource object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__linux__) || defined(__FreeBSD__)
+#include <sys/random.h>
+#define TERRA_RANDOM_GETRANDOM
+#endif
+#elif defined(_WIN32)
+#include <ntstatus.h>
+// The following define is required as ntstatus.h would have already defined
+// various status definitions and, without it, there are redefinition errors
+#define WIN32_NO_STATUS
+#include <Windows.h>
+#include <bcrypt.h>
+#undef WIN32_NO_STATUS
+#endif
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <terra/random/health_test.h>
+#include "os_source.h"
+#include "cpu_source.h"
+#include "vdso_getrandom.h"
+#include "metrics.h"
+#include "probes.h"
+#include "siphash.h"
+#include "little_endian.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Mutex guarding the seed pool (there is only one OSSource per process)
+std::mutex pool_mutex;
+
+// Number of 32-bit words of seed data taken from timing jitter
+constexpr std::size_t Jitter_Words = 8;
+
+// Incremented in the child process after each fork()
+std::atomic<std::uint64_t> fork_generation{0};
+
+// Number of RandomSource values
+constexpr std::size_t Source_Count =
+    static_cast<std::size_t>(RandomSource::Jitter) + 1;
+
+// Response to a health test failure
+std::atomic<HealthTestResponse> health_response{
+    HealthTestResponse::SwitchSource};
+
+// Consecutive reads from a source that failed the health tests before the
+// source is disabled; a false positive occurs with a probability of about
+// 2^-40, so a source failing this many reads in a row is not working
+constexpr std::uint32_t Disable_Failures = 3;
+
+// Time for which a disabled source is not used before it is tried again
+constexpr std::chrono::seconds Disable_Period{60};
+
+// Consecutive health test failures of each source (across all threads)
+std::array<std::atomic<std::uint32_t>, Source_Count> source_failures{};
+
+// Time (steady_clock ticks) until which each source is disabled, or zero
+std::array<std::atomic<std::int64_t>, Source_Count> disabled_until{};
+
+// Health test state for each source, per thread since each thread reads
+// its own stream of octets from each source
+constinit thread_local std::array<HealthTest, Source_Count> health_tests{};
+
+// Function applied to the result of each read, if set (for testing)
+std::atomic<SourceReadHook> read_hook{nullptr};
+
+/*
+ *  IsFailed()
+ *
+ *  Description:
+ *      Determine whether a source is not to be used because it failed the
+ *      health tests.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The random source.
+ *
+ *  Returns:
+ *      True if the source is disabled, false if not.
+ *
+ *  Comments:
+ *      The clock is read only while the source is disabled.  Once
+ *      Disable_Period has passed, the source is used again; should it
+ *      still be failing, it is disabled again after Disable_Failures reads.
+ */
+bool IsFailed(RandomSource source) noexcept
+{
+    const auto index = static_cast<std::size_t>(source);
+    std::int64_t until = disabled_until[index].load(std::memory_order_relaxed);
+
+    if (until == 0) return false;
+
+    if (std::chrono::steady_clock::now().time_since_epoch().count() < until)
+    {
+        return true;
+    }
+
+    if (disabled_until[index].compare_exchange_strong(
+            until,
+            0,
+            std::memory_order_relaxed))
+    {
+        source_failures[index].store(0, std::memory_order_relaxed);
+    }
+
+    return false;
+}
+
+/*
+ *  RecordHealth()
+ *
+ *  Description:
+ *      Record whether a read from a source passed the health tests,
+ *      disabling the source after Disable_Failures consecutive failures.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The random source.
+ *
+ *      passed [in]
+ *          True if the read passed the health tests.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      A passing read writes the shared count only if it is not zero, so
+ *      that reads from a healthy source by many threads do not contend.
+ */
+void RecordHealth(RandomSource source, bool passed) noexcept
+{
+    auto &failures = source_failures[static_cast<std::size_t>(source)];
+
+    if (passed)
+    {
+        if (failures.load(std::memory_order_relaxed) != 0)
+        {
+            failures.store(0, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (failures.fetch_add(1, std::memory_order_relaxed) + 1 !=
+        Disable_Failures)
+    {
+        return;
+    }
+
+    const auto until = std::chrono::steady_clock::now() + Disable_Period;
+
+    disabled_until[static_cast<std::size_t>(source)].store(
+        until.time_since_epoch().count(),
+        std::memory_order_relaxed);
+
+    CountMetric(Counter::SourcesDisabled);
+    TERRA_RANDOM_PROBE1(source_disabled, static_cast<unsigned>(source));
+}
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+/*
+ *  RegisterForkHandlers()
+ *
+ *  Description:
+ *      Register handlers with pthread_atfork() so that the seed pool is not
+ *      shared by the parent and child processes and the pool mutex is not
+ *      held in the child by a thread that does not exist there.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is called once per process.
+ */
+void RegisterForkHandlers()
+{
+    pthread_atfork(
+        []() { pool_mutex.lock(); },
+        []() { pool_mutex.unlock(); },
+        []()
+        {
+            fork_generation.fetch_add(1, std::memory_order_relaxed);
+            pool_mutex.unlock();
+        });
+}
+#endif
+
+// The chain of sources probed once per process
+struct SourceChain
+{
+    std::array<RandomSource, 6> sources;
+    std::size_t count;
+};
+
+/*
+ *  ProbeSources()
+ *
+ *  Description:
+ *      Determine which random sources are available on this system.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The available sources, in the order in which they are used.
+ *
+ *  Comments:
+ *      Each source is probed by reading from it, so a source that exists
+ *      but is blocked (e.g., by a seccomp filter) is excluded.  A source
+ *      that is not yet initialized (i.e., that fails with EAGAIN) is
+ *      included, since it will become usable.
+ */
+SourceChain ProbeSources()
+{
+    SourceChain chain{};
+    [[maybe_unused]] std::array<std::uint8_t, 8> octets;
+    auto add = [&chain](RandomSource source)
+    {
+        chain.sources[chain.count++] = source;
+    };
+
+#ifdef TERRA_RANDOM_GETRANDOM
+    if (HaveVDSOGetRandom())
+    {
+        auto result = VDSOGetRandom(octets, GRND_NONBLOCK);
+        if ((result > 0) || (result == -EAGAIN))
+        {
+            add(RandomSource::VDSOGetRandom);
+        }
+    }
+
+    if ((getrandom(octets.data(), octets.size(), GRND_NONBLOCK) > 0) ||
+        (errno == EAGAIN))
+    {
+        add(RandomSource::GetRandom);
+    }
+#endif
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+    if (FileDescriptor(open("/dev/urandom", O_RDONLY | O_CLOEXEC)).IsValid())
+    {
+        add(RandomSource::DevURandom);
+    }
+#elif defined(_WIN32)
+    if (BCryptGenRandom(NULL,
+                        reinterpret_cast<PUCHAR>(octets.data()),
+                        static_cast<ULONG>(octets.size()),
+                        BCRYPT_USE_SYSTEM_PREFERRED_RNG) == STATUS_SUCCESS)
+    {
+        add(RandomSource::BCrypt);
+    }
+#endif
+
+    const bool have_os_source = (chain.count > 0);
+
+    if (CPUSource::Read(octets) == octets.size()) add(RandomSource::RDRAND);
+
+    // Jitter is slow to probe, so it is probed only if it may be needed
+    if (!have_os_source)
+    {
+        try
+        {
+            if (JitterSource().IsHealthy()) add(RandomSource::Jitter);
+        }
+        catch (...)
+        {
+            // The source could not be constructed
+        }
+    }
+
+    return chain;
+}
+
+/*
+ *  GetSourceChain()
+ *
+ *  Description:
+ *      Return the chain of random sources, probing the sources once per
+ *      process.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The chain of random sources.
+ *
+ *  Comments:
+ *      None.
+ */
+const SourceChain &GetSourceChain()
+{
+    static const SourceChain chain = ProbeSources();
+
+    return chain;
+}
+
+} // namespace
+
+/*
+ *  GetRandomSources()
+ *
+ *  Description:
+ *      Return the random sources available on this system.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The available sources, in the order in which they are used.
+ *
+ *  Comments:
+ *      The sources are probed when this is first called or when the first
+ *      generator is constructed.
+ */
+std::span<const RandomSource> GetRandomSources()
+{
+    const SourceChain &chain = GetSourceChain();
+
+    return {chain.sources.data(), chain.count};
+}
+
+/*
+ *  GetRandomSourceName()
+ *
+ *  Description:
+ *      Return the name of a random source.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The random source.
+ *
+ *  Returns:
+ *      The name of the source (e.g., "getrandom").
+ *
+ *  Comments:
+ *      None.
+ */
+const char *GetRandomSourceName(RandomSource source) noexcept
+{
+    switch (source)
+    {
+        case RandomSource::None: return "none";
+        case RandomSource::VDSOGetRandom: return "vdso-getrandom";
+        case RandomSource::GetRandom: return "getrandom";
+        case RandomSource::DevURandom: return "/dev/urandom";
+        case RandomSource::BCrypt: return "bcrypt";
+        case RandomSource::RDRAND: return "rdrand";
+        case RandomSource::Jitter: return "jitter";
+    }
+
+    return "unknown";
+}
+
+/*
+ *  SetHealthTestResponse()
+ *
+ *  Description:
+ *      Set the response taken when octets from a random source fail the
+ *      health tests.
+ *
+ *  Parameters:
+ *      response [in]
+ *          The response to take.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The response applies to all generators in the process.
+ */
+void SetHealthTestResponse(HealthTestResponse response) noexcept
+{
+    health_response.store(response, std::memory_order_relaxed);
+}
+
+/*
+ *  GetHealthTestResponse()
+ *
+ *  Description:
+ *      Return the response taken when octets from a random source fail the
+ *      health tests.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The response to take.
+ *
+ *  Comments:
+ *      None.
+ */
+HealthTestResponse GetHealthTestResponse() noexcept
+{
+    return health_response.load(std::memory_order_relaxed);
+}
+
+/*
+ *  ReadRandomSource()
+ *
+ *  Description:
+ *      Read random octets from one random source in the chain, as a
+ *      generator does.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source from which to read.
+ *
+ *      octets [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *      error [out]
+ *          The error that occurred, if any.  This is
+ *          std::errc::not_supported if the source is not in the chain or is
+ *          used only for seeding, and std::errc::bad_message if the octets
+ *          failed the health tests.
+ *
+ *  Returns:
+ *      A count of the number of octets placed into the buffer, which may
+ *      be smaller than the size of the span.
+ *
+ *  Comments:
+ *      The read is counted in the calling thread's metrics and subject to
+ *      the health test response, as for a generator.
+ */
+std::size_t ReadRandomSource(RandomSource source,
+                             std::span<std::uint8_t> octets,
+                             std::error_code &error)
+{
+    const OSSource &os_source = OSSource::Acquire();
+    const auto sources = GetRandomSources();
+
+    error.clear();
+
+    if ((source == RandomSource::Jitter) ||
+        (std::find(sources.begin(), sources.end(), source) == sources.end()))
+    {
+        error = std::make_error_code(std::errc::not_supported);
+        return 0;
+    }
+
+    const std::ptrdiff_t result = os_source.ReadFrom(source, octets);
+
+    if (result < 0)
+    {
+        error = std::error_code(static_cast<int>(-result),
+                                std::generic_category());
+        return 0;
+    }
+
+    return static_cast<std::size_t>(result);
+}
+
+/*
+ *  SetSourceReadHook()
+ *
+ *  Description:
+ *      Set the function applied to the result of each read from a random
+ *      source, which allows tests to simulate failing sources.
+ *
+ *  Parameters:
+ *      hook [in]
+ *          The function, or nullptr to remove it.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The hook is applied before the health tests.  When no hook is set,
+ *      the cost to each read is one relaxed atomic load.
+ */
+void SetSourceReadHook(SourceReadHook hook) noexcept
+{
+    read_hook.store(hook, std::memory_order_relaxed);
+}
+
+/*
+ *  ResetSourceHealth()
+ *
+ *  Description:
+ *      Clear the health test failures of all sources, enabling any that
+ *      were disabled, and reset the calling thread's health tests.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is intended for tests.
+ */
+void ResetSourceHealth() noexcept
+{
+    for (std::size_t i = 0; i < Source_Count; i++)
+    {
+        source_failures[i].store(0, std::memory_order_relaxed);
+        disabled_until[i].store(0, std::memory_order_relaxed);
+        health_tests[i].Reset();
+    }
+}
+
+/*
+ *  OSSource::Acquire()
+ *
+ *  Description:
+ *      Return the process-wide OSSource, creating it if it does not exist.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A reference to the OSSource.
+ *
+ *  Comments:
+ *      The OSSource is retained until the process exits (it is never
+ *      destroyed), so that its open files and seed pool are not recreated
+ *      each time a generator is constructed after all others were
+ *      destroyed, and so generators may hold a plain pointer to it without
+ *      reference counting.  After fork(), the child discards the seed pool
+ *      but continues to use the OSSource.
+ */
+OSSource &OSSource::Acquire()
+{
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+    static std::once_flag fork_handlers;
+    std::call_once(fork_handlers, RegisterForkHandlers);
+#endif
+
+    static OSSource *const instance = new OSSource();
+
+    return *instance;
+}
+
+/*
+ *  OSSource::OSSource()
+ *
+ *  Description:
+ *      Constructor for the OSSource object, which opens the random sources
+ *      in the chain of probed sources that require it.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The seed pool is filled when first used.
+ */
+OSSource::OSSource() :
+    sources{GetRandomSources()},
+    pool{},
+    pool_position{Pool_Size},
+    pool_generation{0}
+{
+    for (auto source : sources)
+    {
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+        if (source == RandomSource::DevURandom)
+        {
+            urandom_fd.Reset(
+                open("/dev/urandom", O_NONBLOCK | O_RDONLY | O_CLOEXEC));
+        }
+#endif
+
+        if (source == RandomSource::Jitter)
+        {
+            jitter = std::make_unique<JitterSource>();
+        }
+    }
+}
+
+/*
+ *  OSSource::Read()
+ *
+ *  Description:
+ *      Read random octets from the chain of random sources.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *      source [out]
+ *          The source that produced the last of the octets, or
+ *          RandomSource::None if no octets were produced.
+ *
+ *      unhealthy [out]
+ *          Set to true if octets read from a source failed the health
+ *          tests, false if not.
+ *
+ *      use_cpu [in]
+ *          True if the processor's RDRAND instruction may be used, false
+ *          if only the operating system's sources may be used.
+ *
+ *  Returns:
+ *      A count of the number of octets placed into the buffer.  This count
+ *      may be smaller than the size of the span.
+ *
+ *  Comments:
+ *      This may be called concurrently from multiple threads.  Each source
+ *      is used only if the prior sources do not fill the buffer.  If
+ *      use_cpu is true, the caller must mix the octets with those of
+ *      another source, as RDRAND is never to be used alone.
+ */
+std::size_t OSSource::Read(std::span<std::uint8_t> buffer,
+                           RandomSource &source,
+                           bool &unhealthy,
+                           bool use_cpu) const noexcept
+{
+    std::size_t octets_sourced = 0;
+    RandomSource prior = RandomSource::None;
+    bool fell_back = false;
+
+    source = RandomSource::None;
+    unhealthy = false;
+
+    for (auto candidate : sources)
+    {
+        if (octets_sourced == buffer.size()) break;
+        if (!use_cpu && (candidate == RandomSource::RDRAND)) continue;
+        if (IsFailed(candidate)) continue;
+
+        // Count once each request that must use a source beyond the first
+        if (!fell_back && (candidate != sources.front()))
+        {
+            CountMetric(Counter::Fallbacks);
+            fell_back = true;
+        }
+        if (prior != RandomSource::None)
+        {
+            TERRA_RANDOM_PROBE2(fallback,
+                                static_cast<unsigned>(prior),
+                                static_cast<unsigned>(candidate));
+        }
+        prior = candidate;
+
+        auto result = ReadFrom(candidate, buffer.subspan(octets_sourced));
+        if (result > 0)
+        {
+            octets_sourced += static_cast<std::size_t>(result);
+            source = candidate;
+        }
+        else if (result == -EBADMSG)
+        {
+            unhealthy = true;
+            if (GetHealthTestResponse() == HealthTestResponse::Error) break;
+        }
+    }
+
+    return octets_sourced;
+}
+
+/*
+ *  OSSource::ReadAll()
+ *
+ *  Description:
+ *      Fill the buffer from the chain of random sources, retrying each
+ *      source that is interrupted, temporarily unavailable, or returns
+ *      fewer octets than requested before moving on to the next source.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *      budget [in]
+ *          The time allowed for retries.  Once exhausted, each remaining
+ *          source is tried only once.
+ *
+ *      source [out]
+ *          The source that produced the last of the octets, or
+ *          RandomSource::None if no octets were produced.
+ *
+ *      unhealthy [out]
+ *          Set to true if octets read from a source failed the health
+ *          tests, false if not.
+ *
+ *  Returns:
+ *      An empty error code if the buffer was filled.  Otherwise, the error
+ *      returned by the last source tried, or std::errc::timed_out if the
+ *      budget was exhausted.  If the health test response is Error, a
+ *      failure is reported immediately as std::errc::bad_message.
+ *
+ *  Comments:
+ *      The clock is read only if a read fails, so this costs no more than
+ *      Read() when the first source fills the buffer.
+ */
+std::error_code OSSource::ReadAll(std::span<std::uint8_t> buffer,
+                                  std::chrono::microseconds budget,
+                                  RandomSource &source,
+                                  bool &unhealthy) const noexcept
+{
+    std::size_t octets_sourced = 0;
+    std::chrono::steady_clock::time_point deadline{};
+    bool timing = false;
+    bool expired = false;
+    RandomSource prior = RandomSource::None;
+    bool fell_back = false;
+    int error = ENODEV;
+
+    source = RandomSource::None;
+    unhealthy = false;
+
+    for (auto candidate : sources)
+    {
+        if (IsFailed(candidate)) continue;
+
+        // Count once each request that must use a source beyond the first
+        if (!fell_back && (candidate != sources.front()))
+        {
+            CountMetric(Counter::Fallbacks);
+            fell_back = true;
+        }
+        if (prior != RandomSource::None)
+        {
+            TERRA_RANDOM_PROBE2(fallback,
+                                static_cast<unsigned>(prior),
+                                static_cast<unsigned>(candidate));
+        }
+        prior = candidate;
+
+        while (octets_sourced < buffer.size())
+        {
+            auto result = ReadFrom(candidate, buffer.subspan(octets_sourced));
+            if (result > 0)
+            {
+                octets_sourced += static_cast<std::size_t>(result);
+                source = candidate;
+                continue;
+            }
+
+            // A source producing nothing without an error is exhausted
+            error = (result < 0) ? static_cast<int>(-result) : EIO;
+            if (error == EBADMSG)
+            {
+                unhealthy = true;
+                if (GetHealthTestResponse() == HealthTestResponse::Error)
+                {
+                    return {error, std::generic_category()};
+                }
+            }
+            if ((error != EINTR) && (error != EAGAIN)) break;
+
+            auto now = std::chrono::steady_clock::now();
+            if (!timing)
+            {
+                deadline = now + budget;
+                timing = true;
+            }
+            else if (now >= deadline)
+            {
+                expired = true;
+                break;
+            }
+
+            if (error == EAGAIN) std::this_thread::yield();
+        }
+
+        if (octets_sourced == buffer.size()) return {};
+    }
+
+    if (expired) error = static_cast<int>(std::errc::timed_out);
+
+    return {error, std::generic_category()};
+}
+
+/*
+ *  OSSource::ReadFrom()
+ *
+ *  Description:
+ *      Read random octets from one random source.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source from which to read.
+ *
+ *      buffer [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *  Returns:
+ *      A count of the number of octets placed into the buffer, which may
+ *      be smaller than the size of the span, or the negated error number
+ *      if the read failed (-EBADMSG if the octets failed the health tests).
+ *
+ *  Comments:
+ *      Timing jitter produces no octets here, as it is used only for
+ *      seeding.  The read is counted in the calling thread's metrics.
+ */
+std::ptrdiff_t OSSource::ReadFrom(RandomSource source,
+                               std::span<std::uint8_t> buffer) const noexcept
+{
+    std::ptrdiff_t result = 0;
+
+    switch (source)
+    {
+#ifdef TERRA_RANDOM_GETRANDOM
+        case RandomSource::VDSOGetRandom:
+            result = VDSOGetRandom(buffer, GRND_NONBLOCK);
+            break;
+
+        case RandomSource::GetRandom:
+            CountMetric(Counter::SystemCalls);
+            result = getrandom(buffer.data(), buffer.size(), GRND_NONBLOCK);
+            if (result < 0) result = -errno;
+            break;
+#endif
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+        case RandomSource::DevURandom:
+            CountMetric(Counter::SystemCalls);
+            result = read(urandom_fd.Get(), buffer.data(), buffer.size());
+            if (result < 0) result = -errno;
+            break;
+#elif defined(_WIN32)
+        case RandomSource::BCrypt:
+            // Source random octets from Windows' NIST SP800-90 compliant
+            // RNG, or prior to Vista SP1, a FIPS 186-2 compliant RNG
+            CountMetric(Counter::SystemCalls);
+            if (BCryptGenRandom(NULL,
+                                reinterpret_cast<PUCHAR>(buffer.data()),
+                                static_cast<ULONG>(buffer.size()),
+                                BCRYPT_USE_SYSTEM_PREFERRED_RNG) ==
+                STATUS_SUCCESS)
+            {
+                result = static_cast<std::ptrdiff_t>(buffer.size());
+            }
+            else
+            {
+                result = -EIO;
+            }
+            break;
+#endif
+
+        case RandomSource::RDRAND:
+            result = static_cast<std::ptrdiff_t>(CPUSource::Read(buffer));
+            break;
+
+        default:
+            // Timing jitter is not read here, so nothing is counted
+            return 0;
+    }
+
+    if (auto hook = read_hook.load(std::memory_order_relaxed); hook)
+    {
+        result = hook(source, buffer, result);
+    }
+
+    if (result > 0)
+    {
+        CountMetric(Counter::SourceOctets, static_cast<std::uint64_t>(result));
+    }
+
+    if (result < static_cast<std::ptrdiff_t>(buffer.size()))
+    {
+        CountMetric(Counter::ShortReads);
+    }
+
+    if ((result > 0) &&
+        !TestHealth(source, buffer.first(static_cast<std::size_t>(result))))
+    {
+        result = -EBADMSG;
+    }
+
+    return result;
+}
+
+/*
+ *  OSSource::TestHealth()
+ *
+ *  Description:
+ *      Apply the health tests to octets read from a source, taking the
+ *      configured response on failure.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source from which the octets were read.
+ *
+ *      octets [in/out]
+ *          The octets read, which are cleared if they fail.
+ *
+ *  Returns:
+ *      True if the octets pass, false if they fail.
+ *
+ *  Comments:
+ *      The calling thread's test state for the source is reset after a
+ *      failure.  If the response is SwitchSource, the source is disabled
+ *      for all threads once it has failed Disable_Failures consecutive
+ *      reads (see RecordHealth()).
+ */
+bool OSSource::TestHealth(RandomSource source,
+                          std::span<std::uint8_t> octets) const noexcept
+{
+    HealthTest &test = health_tests[static_cast<std::size_t>(source)];
+    const bool respond =
+        (GetHealthTestResponse() == HealthTestResponse::SwitchSource);
+
+    if (test.Test(octets))
+    {
+        if (respond) RecordHealth(source, true);
+        return true;
+    }
+
+    test.Reset();
+    std::fill(octets.begin(), octets.end(), 0);
+
+    CountMetric(Counter::HealthFailures);
+    TERRA_RANDOM_PROBE1(health_failure, static_cast<unsigned>(source));
+
+    if (respond) RecordHealth(source, false);
+
+    return false;
+}
+
+/*
+ *  OSSource::GetSeedOctets()
+ *
+ *  Description:
+ *      Get random octets for seeding a pseudo-random engine from the seed
+ *      pool, refilling the pool if needed.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          A span of octets into which the seed octets are placed.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Octets taken from the pool are never returned again, so each caller
+ *      receives a distinct seed.  Only one in every Pool_Size octets taken
+ *      requires a system call.
+ */
+void OSSource::GetSeedOctets(std::span<std::uint8_t> octets) noexcept
+{
+    std::lock_guard<std::mutex> lock(pool_mutex);
+
+    while (!octets.empty())
+    {
+        const std::uint64_t generation =
+            fork_generation.load(std::memory_order_relaxed);
+
+        if (pool_generation != generation)
+        {
+            TERRA_RANDOM_PROBE1(fork_detected, generation);
+            RefillPool();
+        }
+        else if (pool_position == Pool_Size)
+        {
+            RefillPool();
+        }
+
+        std::size_t length = std::min(octets.size(), Pool_Size - pool_position);
+        std::copy(pool.begin() + pool_position,
+                  pool.begin() + pool_position + length,
+                  octets.begin());
+
+        // Erase octets once used
+        std::fill(pool.begin() + pool_position,
+                  pool.begin() + pool_position + length,
+                  0);
+
+        pool_position += length;
+        octets = octets.subspan(length);
+    }
+}
+
+/*
+ *  OSSource::RefillPool()
+ *
+ *  Description:
+ *      Refill the seed pool from the operating system.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The pool mutex must be held.  The time taken is always recorded, as
+ *      refills are infrequent.  Any octets the operating system sources
+ *      do not provide are produced by SipHash in counter mode, keyed with
+ *      a hash of timing jitter (see JitterSource) and the current time,
+ *      which neither allocates nor truncates the clock values.
+ *      std::random_device is not used, as it may read
+ *      the processor's random source rather than the operating system.
+ *      Since engines are seeded directly from the pool, RDRAND is not read
+ *      into the pool as a source; its output is only XORed over the octets
+ *      seeded from timing jitter, so it is never used alone.
+ */
+void OSSource::RefillPool() noexcept
+{
+    RandomSource source;
+    LatencyTimer timer(Latency::Refill, true);
+
+    CountMetric(Counter::PoolRefills);
+    TERRA_RANDOM_PROBE0(refill_entry);
+
+    bool unhealthy;
+    std::size_t octets_sourced = Read(pool, source, unhealthy, false);
+    const std::size_t os_octets = octets_sourced;
+
+    TERRA_RANDOM_PROBE2(refill_return,
+                        octets_sourced,
+                        static_cast<unsigned>(source));
+
+    if (octets_sourced < Pool_Size)
+    {
+        // Seed the remainder from timing jitter and the current time
+        std::array<std::uint8_t, Jitter_Words * 4 + 24> material{};
+        std::span<std::uint8_t> jitter_octets =
+            std::span(material).first(Jitter_Words * 4);
+
+        try
+        {
+            if (!jitter) jitter = std::make_unique<JitterSource>();
+        }
+        catch (...)
+        {
+            // Proceed with only the current time
+        }
+
+        if (jitter && (jitter->Read(jitter_octets) != jitter_octets.size()))
+        {
+            std::fill(jitter_octets.begin(), jitter_octets.end(), 0);
+        }
+
+        StoreLittleEndian(material.data() + Jitter_Words * 4,
+                          static_cast<std::uint64_t>(
+                              std::chrono::system_clock::now()
+                                  .time_since_epoch()
+                                  .count()));
+        StoreLittleEndian(material.data() + Jitter_Words * 4 + 8,
+                          static_cast<std::uint64_t>(
+                              std::chrono::steady_clock::now()
+                                  .time_since_epoch()
+                                  .count()));
+        StoreLittleEndian(material.data() + Jitter_Words * 4 + 16,
+                          static_cast<std::uint64_t>(octets_sourced));
+
+        // Condense the material into a key and expand it in counter mode
+        const std::array<std::uint64_t, 2> key =
+            SipHash128({0x7365'6564'706f'6f6c, Pool_Size}, material);
+        std::array<std::uint8_t, 8> counter;
+
+        for (std::uint64_t block = 0; octets_sourced < Pool_Size; block++)
+        {
+            StoreLittleEndian(counter.data(), block);
+            const auto words = SipHash128(key, counter);
+
+            for (std::size_t i = 0; (i < 16) && (octets_sourced < Pool_Size);
+                 i++)
+            {
+                pool[octets_sourced++] =
+                    static_cast<std::uint8_t>(words[i / 8] >> (8 * (i % 8)));
+            }
+        }
+
+        // Erase the key material
+        material.fill(0);
+
+        // RDRAND output is only ever XORed over the octets from jitter
+        std::array<std::uint8_t, Pool_Size> hardware;
+        const std::size_t count = CPUSource::Read(
+            std::span(hardware).first(Pool_Size - os_octets));
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            pool[os_octets + i] ^= hardware[i];
+        }
+    }
+
+    pool_position = 0;
+    pool_generation = fork_generation.load(std::memory_order_relaxed);
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,112 @@
+/*
+ *  os_source.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines the OSSource object, which provides
+ *      random octets from the chain of random sources probed once per
+ *      process (see random_source.h).
+ *
+ *      A single OSSource is shared by all generators in the process.  It is
+ *      created when first acquired and retained until the process exits,
+ *      so constructing a generator after the first requires no system calls
+ *      and does not refill the seed pool until it is exhausted.
+ *
+ *      The OSSource also holds a pool of random octets read from the
+ *      operating system in one call, from which generators take their
+ *      seeds.  The pool is discarded in the child after fork() so that
+ *      parent and child never share seeds.
+ *
+ *      Octets read from each source are checked with the SP 800-90B health
+ *      tests.  A read that fails is reported to ReadFrom()'s caller as the
+ *      error EBADMSG, and the caller takes the configured response (see
+ *      random_source.h).
+ *
+ *      Should the operating system's sources fail to produce enough octets
+ *      for a generator, the processor's random source (see CPUSource) is
+ *      used for the remainder, which the generator mixes with other data.
+ *      Any part of the seed pool the operating system does not provide is
+ *      seeded from timing jitter (see JitterSource) and the current time,
+ *      over which the output of the processor's random source, if any, is
+ *      XORed.  The processor's random source is never used alone.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <terra/random/random_source.h>
+#include <terra/random/jitter_source.h>
+#include "file_descriptor.h"
+
+namespace Terra::Random
+{
+
+class OSSource
+{
+    public:
+        static constexpr std::size_t Pool_Size = 4096;
+
+        static OSSource &Acquire();
+
+        OSSource(const OSSource &) = delete;
+        OSSource &operator=(const OSSource &) = delete;
+
+        std::size_t Read(std::span<std::uint8_t> buffer,
+                         RandomSource &source,
+                         bool &unhealthy,
+                         bool use_cpu = true) const noexcept;
+        std::error_code ReadAll(std::span<std::uint8_t> buffer,
+                                std::chrono::microseconds budget,
+                                RandomSource &source,
+                                bool &unhealthy) const noexcept;
+        void GetSeedOctets(std::span<std::uint8_t> octets) noexcept;
+
+    protected:
+        friend std::size_t ReadRandomSource(RandomSource source,
+                                            std::span<std::uint8_t> octets,
+                                            std::error_code &error);
+
+        OSSource();
+        std::ptrdiff_t ReadFrom(RandomSource source,
+                                std::span<std::uint8_t> buffer) const noexcept;
+        bool TestHealth(RandomSource source,
+                        std::span<std::uint8_t> octets) const noexcept;
+        void RefillPool() noexcept;
+
+        const std::span<const RandomSource> sources;
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+        FileDescriptor urandom_fd;
+#endif
+        std::unique_ptr<JitterSource> jitter;
+
+        // Guarded by the process-wide pool mutex
+        std::array<std::uint8_t, Pool_Size> pool;
+        std::size_t pool_position;
+        std::uint64_t pool_generation;
+};
+
+// Function applied to the result of each read from a source, which may
+// alter the octets or the result (for testing the response to failures)
+using SourceReadHook = std::ptrdiff_t (*)(RandomSource source,
+                                          std::span<std::uint8_t> buffer,
+                                          std::ptrdiff_t result) noexcept;
+
+void SetSourceReadHook(SourceReadHook hook) noexcept;
+void ResetSourceHealth() noexcept;
+
+} // namespace Terra::Random
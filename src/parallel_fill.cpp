@@ -0,0 +1,270 @@
+/*
+ *  parallel_fill.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation of the ParallelFill() function.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <terra/random/parallel_fill.h>
+#include <terra/random/philox.h>
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Size of each unit of work; a multiple of the Philox block size
+constexpr std::size_t Chunk_Size = 256 * 1024;
+
+// A worker's range of chunks [begin, end) packed into a single atomic value
+// so that the owner and thieves may update it without a lock
+class ChunkRange
+{
+    public:
+        static constexpr std::uint64_t Pack(std::uint32_t begin,
+                                            std::uint32_t end) noexcept
+        {
+            return (static_cast<std::uint64_t>(begin) << 32) | end;
+        }
+        static constexpr std::uint32_t Begin(std::uint64_t range) noexcept
+        {
+            return static_cast<std::uint32_t>(range >> 32);
+        }
+        static constexpr std::uint32_t End(std::uint64_t range) noexcept
+        {
+            return static_cast<std::uint32_t>(range);
+        }
+
+        // Take the next chunk from the front of the range
+        bool Pop(std::uint32_t &chunk) noexcept
+        {
+            std::uint64_t current = range.load(std::memory_order_relaxed);
+            while (Begin(current) < End(current))
+            {
+                if (range.compare_exchange_weak(
+                        current,
+                        Pack(Begin(current) + 1, End(current)),
+                        std::memory_order_relaxed))
+                {
+                    chunk = Begin(current);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Steal the back half of the range
+        bool Steal(std::uint32_t &begin, std::uint32_t &end) noexcept
+        {
+            std::uint64_t current = range.load(std::memory_order_relaxed);
+            while (Begin(current) < End(current))
+            {
+                std::uint32_t remaining = End(current) - Begin(current);
+                std::uint32_t split = End(current) - (remaining + 1) / 2;
+                if (range.compare_exchange_weak(
+                        current,
+                        Pack(Begin(current), split),
+                        std::memory_order_relaxed))
+                {
+                    begin = split;
+                    end = End(current);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void Assign(std::uint32_t begin, std::uint32_t end) noexcept
+        {
+            range.store(Pack(begin, end), std::memory_order_relaxed);
+        }
+
+    protected:
+        alignas(64) std::atomic<std::uint64_t> range{0};
+};
+
+/*
+ *  FillChunks()
+ *
+ *  Description:
+ *      Worker function that produces chunks from its own range and then
+ *      steals from other workers until no work remains.
+ *
+ *  Parameters:
+ *      ranges [in/out]
+ *          The chunk ranges for all workers.
+ *
+ *      worker [in]
+ *          The index of this worker.
+ *
+ *      key [in]
+ *          The Philox key.
+ *
+ *      first_block [in]
+ *          The Philox counter of the first block in the buffer.
+ *
+ *      octets [out]
+ *          The buffer being filled.
+ *
+ *      chunk_size [in]
+ *          The size of each chunk, which is a multiple of the block size.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void FillChunks(std::vector<ChunkRange> &ranges,
+                std::size_t worker,
+                const Philox4x32::Key &key,
+                std::uint64_t first_block,
+                std::span<std::uint8_t> octets,
+                std::size_t chunk_size) noexcept
+{
+    std::uint32_t chunk;
+
+    while (true)
+    {
+        // Produce all of the chunks in this worker's range
+        while (ranges[worker].Pop(chunk))
+        {
+            std::size_t offset = static_cast<std::size_t>(chunk) * chunk_size;
+            Philox4x32::FillRange(
+                key,
+                first_block + offset / Philox4x32::Block_Size,
+                octets.subspan(offset,
+                               std::min(chunk_size, octets.size() - offset)));
+        }
+
+        // Steal from another worker, starting with the next one
+        bool stolen = false;
+        for (std::size_t i = 1; i < ranges.size() && !stolen; i++)
+        {
+            std::uint32_t begin, end;
+            if (ranges[(worker + i) % ranges.size()].Steal(begin, end))
+            {
+                ranges[worker].Assign(begin, end);
+                stolen = true;
+            }
+        }
+        if (!stolen) break;
+    }
+}
+
+} // namespace
+
+/*
+ *  ParallelFill()
+ *
+ *  Description:
+ *      Fill the given buffer with pseudo-random octets using multiple
+ *      threads.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The buffer to fill.
+ *
+ *      threads [in]
+ *          The number of threads to use.  If zero, the number of hardware
+ *          threads is used.  The calling thread is one of the threads.
+ *
+ *      seed [in]
+ *          The seed, which determines the content of the buffer.
+ *
+ *      first_block [in]
+ *          The Philox counter of the first block in the buffer.  This is
+ *          the octet offset of the buffer within the full sequence divided
+ *          by the block size (16), so a long sequence may be produced in
+ *          segments whose sizes are multiples of the block size.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The content of the buffer does not depend on the number of threads
+ *      or the chunk size, so the chunk size is increased for extremely large
+ *      buffers such that chunk indices fit in 32 bits.  If a thread cannot
+ *      be created, the buffer is filled by the threads already started and
+ *      the calling thread.
+ */
+void ParallelFill(std::span<std::uint8_t> octets,
+                  unsigned threads,
+                  std::uint64_t seed,
+                  std::uint64_t first_block)
+{
+    constexpr std::size_t Max_Chunks = 0xffff'ffff;
+    const Philox4x32::Key key = {static_cast<std::uint32_t>(seed),
+                                 static_cast<std::uint32_t>(seed >> 32)};
+    std::size_t chunk_size = Chunk_Size;
+
+    if (threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    while (octets.size() / chunk_size >= Max_Chunks) chunk_size *= 2;
+
+    const std::size_t chunks = (octets.size() + chunk_size - 1) / chunk_size;
+
+    // If there is too little work to share, just fill the buffer
+    if ((threads == 1) || (chunks <= 1))
+    {
+        Philox4x32::FillRange(key, first_block, octets);
+        return;
+    }
+
+    const std::size_t workers = std::min<std::size_t>(threads, chunks);
+    std::vector<ChunkRange> ranges(workers);
+    std::vector<std::thread> pool;
+
+    // Divide the chunks evenly among the workers to start
+    for (std::size_t i = 0; i < workers; i++)
+    {
+        ranges[i].Assign(static_cast<std::uint32_t>(chunks * i / workers),
+                         static_cast<std::uint32_t>(chunks * (i + 1) /
+                                                    workers));
+    }
+
+    // The calling thread is worker zero
+    pool.reserve(workers - 1);
+    try
+    {
+        for (std::size_t i = 1; i < workers; i++)
+        {
+            pool.emplace_back(FillChunks,
+                              std::ref(ranges),
+                              i,
+                              std::cref(key),
+                              first_block,
+                              octets,
+                              chunk_size);
+        }
+    }
+    catch (const std::system_error &)
+    {
+        // Chunks of workers that could not be started are stolen by the
+        // others, so proceed with the threads that were started
+    }
+    FillChunks(ranges, 0, key, first_block, octets, chunk_size);
+    for (auto &thread : pool) thread.join();
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,264 @@
+/*
+ *  pcg32.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the PCG32 object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <array>
+#include <terra/random/pcg32.h>
+#include "little_endian.h"
+#include "seed_sequence.h"
+
+namespace Terra::Random
+{
+
+/*
+ *  PCG32::PCG32()
+ *
+ *  Description:
+ *      Constructor for the PCG32 object.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The initial state of the engine.
+ *
+ *      stream [in]
+ *          The stream selector, which determines the increment of the
+ *          underlying linear congruential generator.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+PCG32::PCG32(std::uint64_t seed, std::uint64_t stream) noexcept
+{
+    Seed(seed, stream);
+}
+
+/*
+ *  PCG32::PCG32()
+ *
+ *  Description:
+ *      Constructor for the PCG32 object.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data used to initialize the full state of the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+PCG32::PCG32(std::span<const std::uint32_t> seed_data)
+{
+    Seed(seed_data);
+}
+
+/*
+ *  PCG32::Seed()
+ *
+ *  Description:
+ *      Seed the engine.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The initial state of the engine.
+ *
+ *      stream [in]
+ *          The stream selector, which determines the increment of the
+ *          underlying linear congruential generator.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This is the same initialization as the reference pcg32_srandom_r().
+ */
+void PCG32::Seed(std::uint64_t seed, std::uint64_t stream) noexcept
+{
+    state = 0;
+    increment = (stream << 1) | 1;
+    (*this)();
+    state += seed;
+    (*this)();
+}
+
+/*
+ *  PCG32::Seed()
+ *
+ *  Description:
+ *      Seed the full state of the engine from the given seed data.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data that is expanded as by std::seed_seq.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void PCG32::Seed(std::span<const std::uint32_t> seed_data)
+{
+    std::array<std::uint32_t, 4> words;
+
+    GenerateSeedSequence(seed_data, words);
+
+    Seed((static_cast<std::uint64_t>(words[0]) << 32) | words[1],
+         (static_cast<std::uint64_t>(words[2]) << 32) | words[3]);
+}
+
+/*
+ *  PCG32::Discard()
+ *
+ *  Description:
+ *      Advance the engine as if the given number of values were produced.
+ *
+ *  Parameters:
+ *      count [in]
+ *          The number of values to discard.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This uses the algorithm from F. Brown, "Random Number Generation with
+ *      Arbitrary Stride", which composes the LCG with itself by squaring,
+ *      so the cost is logarithmic in the count.
+ */
+void PCG32::Discard(std::uint64_t count) noexcept
+{
+    std::uint64_t accumulated_multiplier = 1;
+    std::uint64_t accumulated_increment = 0;
+    std::uint64_t current_multiplier = Multiplier;
+    std::uint64_t current_increment = increment;
+
+    while (count > 0)
+    {
+        if (count & 1)
+        {
+            accumulated_multiplier *= current_multiplier;
+            accumulated_increment = accumulated_increment * current_multiplier +
+                                    current_increment;
+        }
+        current_increment = (current_multiplier + 1) * current_increment;
+        current_multiplier *= current_multiplier;
+        count >>= 1;
+    }
+
+    state = accumulated_multiplier * state + accumulated_increment;
+}
+
+/*
+ *  PCG32::Jump()
+ *
+ *  Description:
+ *      Advance the engine by 2^48 steps.  This may be used to produce 2^16
+ *      non-overlapping sub-sequences for parallel computations.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void PCG32::Jump() noexcept
+{
+    Discard(std::uint64_t(1) << 48);
+}
+
+/*
+ *  PCG32::LongJump()
+ *
+ *  Description:
+ *      Advance the engine by 2^56 steps.  This may be used to produce 2^8
+ *      starting points, from each of which Jump() will produce 2^8
+ *      non-overlapping sub-sequences.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void PCG32::LongJump() noexcept
+{
+    Discard(std::uint64_t(1) << 56);
+}
+
+/*
+ *  PCG32::SaveState()
+ *
+ *  Description:
+ *      Save the state of the engine.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The array into which the state is saved.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void PCG32::SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept
+{
+    StoreLittleEndian(octets.data(), state);
+    StoreLittleEndian(octets.data() + 8, increment);
+}
+
+/*
+ *  PCG32::LoadState()
+ *
+ *  Description:
+ *      Load the state of the engine previously saved with SaveState().
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The array from which the state is loaded.
+ *
+ *  Returns:
+ *      True if the state was loaded, false if it is invalid, in which case
+ *      the engine is unchanged.
+ *
+ *  Comments:
+ *      The increment must be odd.
+ */
+bool PCG32::LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept
+{
+    auto saved_increment = LoadLittleEndian<std::uint64_t>(octets.data() + 8);
+
+    if ((saved_increment & 1) == 0) return false;
+
+    state = LoadLittleEndian<std::uint64_t>(octets.data());
+    increment = saved_increment;
+
+    return true;
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,812 @@
+/*
+ *  philox.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the Philox4x32 object.
+ *
+ *  Portability Issues:
+ *      The SIMD implementations of FillRange() are used only on x86
+ *      processors.  AVX2 is detected at runtime when using GCC or Clang.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__))
+#include <immintrin.h>
+#define TERRA_RANDOM_PHILOX_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#define TERRA_RANDOM_PHILOX_AVX2
+#endif
+#endif
+#include <cstring>
+#include <algorithm>
+#include <terra/random/philox.h>
+#include "little_endian.h"
+#include "seed_sequence.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Constants defined by Philox4x32-10
+constexpr std::uint32_t Multiplier_0 = 0xd251'1f53;
+constexpr std::uint32_t Multiplier_1 = 0xcd9e'8d57;
+constexpr std::uint32_t Weyl_0 = 0x9e37'79b9;
+constexpr std::uint32_t Weyl_1 = 0xbb67'ae85;
+constexpr std::size_t Rounds = 10;
+
+// Round keys for all rounds
+using RoundKeys = std::array<Philox4x32::Key, Rounds>;
+
+/*
+ *  ScheduleKeys()
+ *
+ *  Description:
+ *      Compute the key used in each round.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The Philox key.
+ *
+ *  Returns:
+ *      The round keys.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr RoundKeys ScheduleKeys(const Philox4x32::Key &key) noexcept
+{
+    RoundKeys round_keys{};
+
+    round_keys[0] = key;
+    for (std::size_t i = 1; i < Rounds; i++)
+    {
+        round_keys[i][0] = round_keys[i - 1][0] + Weyl_0;
+        round_keys[i][1] = round_keys[i - 1][1] + Weyl_1;
+    }
+
+    return round_keys;
+}
+
+/*
+ *  Bijection()
+ *
+ *  Description:
+ *      Compute the Philox4x32-10 bijection for one counter value.
+ *
+ *  Parameters:
+ *      round_keys [in]
+ *          The round keys.
+ *
+ *      counter [in]
+ *          The counter value.
+ *
+ *  Returns:
+ *      The block of random values.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr Philox4x32::Block Bijection(const RoundKeys &round_keys,
+                                      Philox4x32::Counter counter) noexcept
+{
+    for (const auto &round_key : round_keys)
+    {
+        std::uint64_t product_0 =
+            static_cast<std::uint64_t>(Multiplier_0) * counter[0];
+        std::uint64_t product_1 =
+            static_cast<std::uint64_t>(Multiplier_1) * counter[2];
+
+        counter = {static_cast<std::uint32_t>(product_1 >> 32) ^ counter[1] ^
+                       round_key[0],
+                   static_cast<std::uint32_t>(product_1),
+                   static_cast<std::uint32_t>(product_0 >> 32) ^ counter[3] ^
+                       round_key[1],
+                   static_cast<std::uint32_t>(product_0)};
+    }
+
+    return counter;
+}
+
+/*
+ *  StoreBlock()
+ *
+ *  Description:
+ *      Store a block of random values as little-endian octets.
+ *
+ *  Parameters:
+ *      block [in]
+ *          The block to store.
+ *
+ *      octets [out]
+ *          The location to store the block, which must have space for
+ *          count octets.
+ *
+ *      count [in]
+ *          The number of octets to store (at most 16).
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void StoreBlock(const Philox4x32::Block &block,
+                std::uint8_t *octets,
+                std::size_t count) noexcept
+{
+    std::array<std::uint8_t, Philox4x32::Block_Size> buffer;
+
+    for (std::size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = static_cast<std::uint8_t>(block[i / 4] >> (8 * (i % 4)));
+    }
+
+    std::memcpy(octets, buffer.data(), count);
+}
+
+#ifdef TERRA_RANDOM_PHILOX_SSE2
+
+/*
+ *  MultiplySSE2()
+ *
+ *  Description:
+ *      Multiply four 32-bit lanes by a constant producing the high and low
+ *      32 bits of each 64-bit product.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The four 32-bit lanes.
+ *
+ *      multiplier [in]
+ *          The multiplier broadcast to all lanes.
+ *
+ *      high [out]
+ *          The high 32 bits of the products.
+ *
+ *      low [out]
+ *          The low 32 bits of the products.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+inline void MultiplySSE2(__m128i value,
+                         __m128i multiplier,
+                         __m128i &high,
+                         __m128i &low) noexcept
+{
+    __m128i even = _mm_mul_epu32(value, multiplier);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(value, 32), multiplier);
+
+    even = _mm_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 2, 0));
+    odd = _mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 2, 0));
+    low = _mm_unpacklo_epi32(even, odd);
+    high = _mm_unpackhi_epi32(even, odd);
+}
+
+/*
+ *  FillSSE2()
+ *
+ *  Description:
+ *      Produce blocks four at a time using SSE2 instructions.
+ *
+ *  Parameters:
+ *      round_keys [in]
+ *          The round keys.
+ *
+ *      counter [in]
+ *          The counter of the first block.
+ *
+ *      octets [out]
+ *          The location to store the blocks.
+ *
+ *      groups [in]
+ *          The number of groups of four blocks to produce.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Each vector holds the same word of four consecutive blocks, so the
+ *      results are transposed before being stored.
+ */
+void FillSSE2(const RoundKeys &round_keys,
+              std::uint64_t counter,
+              std::uint8_t *octets,
+              std::size_t groups) noexcept
+{
+    const __m128i multiplier_0 = _mm_set1_epi32(
+        static_cast<int>(Multiplier_0));
+    const __m128i multiplier_1 = _mm_set1_epi32(
+        static_cast<int>(Multiplier_1));
+
+    for (std::size_t group = 0; group < groups; group++, counter += 4)
+    {
+        alignas(16) std::array<std::uint32_t, 4> low_words;
+        alignas(16) std::array<std::uint32_t, 4> high_words;
+        for (std::size_t i = 0; i < 4; i++)
+        {
+            low_words[i] = static_cast<std::uint32_t>(counter + i);
+            high_words[i] = static_cast<std::uint32_t>((counter + i) >> 32);
+        }
+
+        __m128i c0 = _mm_load_si128(
+            reinterpret_cast<const __m128i *>(low_words.data()));
+        __m128i c1 = _mm_load_si128(
+            reinterpret_cast<const __m128i *>(high_words.data()));
+        __m128i c2 = _mm_setzero_si128();
+        __m128i c3 = _mm_setzero_si128();
+
+        for (const auto &round_key : round_keys)
+        {
+            __m128i high_0, low_0, high_1, low_1;
+            MultiplySSE2(c0, multiplier_0, high_0, low_0);
+            MultiplySSE2(c2, multiplier_1, high_1, low_1);
+            c0 = _mm_xor_si128(
+                _mm_xor_si128(high_1, c1),
+                _mm_set1_epi32(static_cast<int>(round_key[0])));
+            c1 = low_1;
+            c2 = _mm_xor_si128(
+                _mm_xor_si128(high_0, c3),
+                _mm_set1_epi32(static_cast<int>(round_key[1])));
+            c3 = low_0;
+        }
+
+        // Transpose such that each vector holds one block
+        __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+        __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+        __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+        __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+
+        auto output = reinterpret_cast<__m128i *>(octets + group * 64);
+        _mm_storeu_si128(output + 0, _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128(output + 1, _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128(output + 2, _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128(output + 3, _mm_unpackhi_epi64(t2, t3));
+    }
+}
+
+#endif // TERRA_RANDOM_PHILOX_SSE2
+
+#ifdef TERRA_RANDOM_PHILOX_AVX2
+
+/*
+ *  MultiplyAVX2()
+ *
+ *  Description:
+ *      Multiply eight 32-bit lanes by a constant producing the high and low
+ *      32 bits of each 64-bit product.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The eight 32-bit lanes.
+ *
+ *      multiplier [in]
+ *          The multiplier broadcast to all lanes.
+ *
+ *      high [out]
+ *          The high 32 bits of the products.
+ *
+ *      low [out]
+ *          The low 32 bits of the products.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+__attribute__((target("avx2")))
+inline void MultiplyAVX2(__m256i value,
+                         __m256i multiplier,
+                         __m256i &high,
+                         __m256i &low) noexcept
+{
+    __m256i even = _mm256_mul_epu32(value, multiplier);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), multiplier);
+
+    even = _mm256_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 2, 0));
+    odd = _mm256_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 2, 0));
+    low = _mm256_unpacklo_epi32(even, odd);
+    high = _mm256_unpackhi_epi32(even, odd);
+}
+
+/*
+ *  FillAVX2()
+ *
+ *  Description:
+ *      Produce blocks eight at a time using AVX2 instructions.
+ *
+ *  Parameters:
+ *      round_keys [in]
+ *          The round keys.
+ *
+ *      counter [in]
+ *          The counter of the first block.
+ *
+ *      octets [out]
+ *          The location to store the blocks.
+ *
+ *      groups [in]
+ *          The number of groups of eight blocks to produce.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Each vector holds the same word of eight consecutive blocks, so the
+ *      results are transposed before being stored.
+ */
+__attribute__((target("avx2")))
+void FillAVX2(const RoundKeys &round_keys,
+              std::uint64_t counter,
+              std::uint8_t *octets,
+              std::size_t groups) noexcept
+{
+    const __m256i multiplier_0 = _mm256_set1_epi32(
+        static_cast<int>(Multiplier_0));
+    const __m256i multiplier_1 = _mm256_set1_epi32(
+        static_cast<int>(Multiplier_1));
+
+    for (std::size_t group = 0; group < groups; group++, counter += 8)
+    {
+        alignas(32) std::array<std::uint32_t, 8> low_words;
+        alignas(32) std::array<std::uint32_t, 8> high_words;
+        for (std::size_t i = 0; i < 8; i++)
+        {
+            low_words[i] = static_cast<std::uint32_t>(counter + i);
+            high_words[i] = static_cast<std::uint32_t>((counter + i) >> 32);
+        }
+
+        __m256i c0 = _mm256_load_si256(
+            reinterpret_cast<const __m256i *>(low_words.data()));
+        __m256i c1 = _mm256_load_si256(
+            reinterpret_cast<const __m256i *>(high_words.data()));
+        __m256i c2 = _mm256_setzero_si256();
+        __m256i c3 = _mm256_setzero_si256();
+
+        for (const auto &round_key : round_keys)
+        {
+            __m256i high_0, low_0, high_1, low_1;
+            MultiplyAVX2(c0, multiplier_0, high_0, low_0);
+            MultiplyAVX2(c2, multiplier_1, high_1, low_1);
+            c0 = _mm256_xor_si256(
+                _mm256_xor_si256(high_1, c1),
+                _mm256_set1_epi32(static_cast<int>(round_key[0])));
+            c1 = low_1;
+            c2 = _mm256_xor_si256(
+                _mm256_xor_si256(high_0, c3),
+                _mm256_set1_epi32(static_cast<int>(round_key[1])));
+            c3 = low_0;
+        }
+
+        // Transpose within each 128-bit lane (blocks i and i + 4), then
+        // gather the blocks in order
+        __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+        __m256i t1 = _mm256_unpacklo_epi32(c2, c3);
+        __m256i t2 = _mm256_unpackhi_epi32(c0, c1);
+        __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+        __m256i r0 = _mm256_unpacklo_epi64(t0, t1);
+        __m256i r1 = _mm256_unpackhi_epi64(t0, t1);
+        __m256i r2 = _mm256_unpacklo_epi64(t2, t3);
+        __m256i r3 = _mm256_unpackhi_epi64(t2, t3);
+
+        auto output = reinterpret_cast<__m256i *>(octets + group * 128);
+        _mm256_storeu_si256(output + 0,
+                            _mm256_permute2x128_si256(r0, r1, 0x20));
+        _mm256_storeu_si256(output + 1,
+                            _mm256_permute2x128_si256(r2, r3, 0x20));
+        _mm256_storeu_si256(output + 2,
+                            _mm256_permute2x128_si256(r0, r1, 0x31));
+        _mm256_storeu_si256(output + 3,
+                            _mm256_permute2x128_si256(r2, r3, 0x31));
+    }
+}
+
+/*
+ *  HaveAVX2()
+ *
+ *  Description:
+ *      Determine whether the processor supports AVX2.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if AVX2 is supported, false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool HaveAVX2() noexcept
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    return avx2;
+}
+
+#endif // TERRA_RANDOM_PHILOX_AVX2
+
+} // namespace
+
+/*
+ *  Philox4x32::Philox4x32()
+ *
+ *  Description:
+ *      Constructor for the Philox4x32 object.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value used as the key.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+Philox4x32::Philox4x32(std::uint64_t seed) noexcept
+{
+    Seed(seed);
+}
+
+/*
+ *  Philox4x32::Philox4x32()
+ *
+ *  Description:
+ *      Constructor for the Philox4x32 object.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data used to produce the key.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+Philox4x32::Philox4x32(std::span<const std::uint32_t> seed_data)
+{
+    Seed(seed_data);
+}
+
+/*
+ *  Philox4x32::Seed()
+ *
+ *  Description:
+ *      Seed the engine using the given value as the key and reset the
+ *      counter to zero.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value used as the key.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Philox4x32::Seed(std::uint64_t seed) noexcept
+{
+    key = {static_cast<std::uint32_t>(seed),
+           static_cast<std::uint32_t>(seed >> 32)};
+    counter = {};
+    block = {};
+    position = block.size();
+}
+
+/*
+ *  Philox4x32::Seed()
+ *
+ *  Description:
+ *      Seed the engine using a key derived from the given seed data and
+ *      reset the counter to zero.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data that is expanded as by std::seed_seq.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Philox4x32::Seed(std::span<const std::uint32_t> seed_data)
+{
+    std::array<std::uint32_t, 2> words;
+
+    GenerateSeedSequence(seed_data, words);
+
+    Seed((static_cast<std::uint64_t>(words[1]) << 32) | words[0]);
+}
+
+/*
+ *  Philox4x32::Discard()
+ *
+ *  Description:
+ *      Advance the engine as if the given number of values were produced.
+ *
+ *  Parameters:
+ *      count [in]
+ *          The number of values to discard.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This takes constant time.
+ */
+void Philox4x32::Discard(std::uint64_t count) noexcept
+{
+    std::size_t remaining = block.size() - position;
+
+    // Consume values from the current block
+    if (count < remaining)
+    {
+        position += static_cast<std::size_t>(count);
+        return;
+    }
+    count -= remaining;
+
+    // Skip whole blocks, then produce a partial block if needed
+    Increment(counter, count / block.size());
+    position = block.size();
+    if ((count % block.size()) != 0)
+    {
+        block = At(key, counter);
+        Increment(counter, 1);
+        position = static_cast<std::size_t>(count % block.size());
+    }
+}
+
+/*
+ *  Philox4x32::Jump()
+ *
+ *  Description:
+ *      Advance the engine by 2^64 blocks (2^66 values).  This may be used
+ *      to produce 2^32 non-overlapping sub-sequences.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Philox4x32::Jump() noexcept
+{
+    if (++counter[2] == 0) counter[3]++;
+}
+
+/*
+ *  Philox4x32::LongJump()
+ *
+ *  Description:
+ *      Advance the engine by 2^96 blocks (2^98 values).  This may be used
+ *      to produce 2^32 starting points, from each of which Jump() will
+ *      produce 2^32 non-overlapping sub-sequences.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Philox4x32::LongJump() noexcept
+{
+    counter[3]++;
+}
+
+/*
+ *  Philox4x32::At()
+ *
+ *  Description:
+ *      Return the block of random values for the given key and counter.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key.
+ *
+ *      counter [in]
+ *          The counter.
+ *
+ *  Returns:
+ *      The block of four random values.
+ *
+ *  Comments:
+ *      None.
+ */
+Philox4x32::Block Philox4x32::At(const Key &key,
+                                 const Counter &counter) noexcept
+{
+    return Bijection(ScheduleKeys(key), counter);
+}
+
+/*
+ *  Philox4x32::FillRange()
+ *
+ *  Description:
+ *      Fill the given span with the sequence of octets starting at the
+ *      given block counter.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The key.
+ *
+ *      first_counter [in]
+ *          The counter of the first block.  This is the lower 64 bits of the
+ *          128-bit counter; the upper 64 bits are zero.
+ *
+ *      octets [out]
+ *          The span to fill with random octets.  If the length is not a
+ *          multiple of the block size, the final block is truncated.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Philox4x32::FillRange(const Key &key,
+                           std::uint64_t first_counter,
+                           std::span<std::uint8_t> octets) noexcept
+{
+    const RoundKeys round_keys = ScheduleKeys(key);
+    std::size_t blocks = octets.size() / Block_Size;
+    std::size_t done = 0;
+
+#ifdef TERRA_RANDOM_PHILOX_AVX2
+    if (HaveAVX2())
+    {
+        std::size_t groups = blocks / 8;
+        FillAVX2(round_keys, first_counter, octets.data(), groups);
+        done = groups * 8;
+    }
+#endif
+
+#ifdef TERRA_RANDOM_PHILOX_SSE2
+    {
+        std::size_t groups = (blocks - done) / 4;
+        FillSSE2(round_keys,
+                 first_counter + done,
+                 octets.data() + done * Block_Size,
+                 groups);
+        done += groups * 4;
+    }
+#endif
+
+    // Produce the remaining blocks, including any partial block
+    for (; done * Block_Size < octets.size(); done++)
+    {
+        const std::uint64_t value = first_counter + done;
+        Block result = Bijection(round_keys,
+                                 {static_cast<std::uint32_t>(value),
+                                  static_cast<std::uint32_t>(value >> 32),
+                                  0,
+                                  0});
+        StoreBlock(result,
+                   octets.data() + done * Block_Size,
+                   std::min(Block_Size, octets.size() - done * Block_Size));
+    }
+}
+
+/*
+ *  Philox4x32::Increment()
+ *
+ *  Description:
+ *      Add the given count to a 128-bit counter.
+ *
+ *  Parameters:
+ *      value [in/out]
+ *          The counter to increment.
+ *
+ *      count [in]
+ *          The amount to add.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Philox4x32::Increment(Counter &value, std::uint64_t count) noexcept
+{
+    std::uint64_t carry = count;
+
+    for (auto &word : value)
+    {
+        std::uint64_t sum = static_cast<std::uint64_t>(word) +
+                            static_cast<std::uint32_t>(carry);
+        word = static_cast<std::uint32_t>(sum);
+        carry = (carry >> 32) + (sum >> 32);
+        if (carry == 0) break;
+    }
+}
+
+/*
+ *  Philox4x32::SaveState()
+ *
+ *  Description:
+ *      Save the state of the engine.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The array into which the state is saved.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The key, counter, and buffered block are saved, followed by the
+ *      position within the block.
+ */
+void Philox4x32::SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept
+{
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        if (i < key.size()) StoreLittleEndian(octets.data() + 4 * i, key[i]);
+        StoreLittleEndian(octets.data() + 8 + 4 * i, counter[i]);
+        StoreLittleEndian(octets.data() + 24 + 4 * i, block[i]);
+    }
+    StoreLittleEndian(octets.data() + 40, static_cast<std::uint32_t>(position));
+}
+
+/*
+ *  Philox4x32::LoadState()
+ *
+ *  Description:
+ *      Load the state of the engine previously saved with SaveState().
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The array from which the state is loaded.
+ *
+ *  Returns:
+ *      True if the state was loaded, false if it is invalid, in which case
+ *      the engine is unchanged.
+ *
+ *  Comments:
+ *      The position must be in range.
+ */
+bool Philox4x32::LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept
+{
+    auto saved_position = LoadLittleEndian<std::uint32_t>(octets.data() + 40);
+
+    if (saved_position > block.size()) return false;
+
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        if (i < key.size())
+        {
+            key[i] = LoadLittleEndian<std::uint32_t>(octets.data() + 4 * i);
+        }
+        counter[i] = LoadLittleEndian<std::uint32_t>(octets.data() + 8 + 4 * i);
+        block[i] = LoadLittleEndian<std::uint32_t>(octets.data() + 24 + 4 * i);
+    }
+    position = saved_position;
+
+    return true;
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,74 @@
+/*
+ *  probes.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines macros for the library's USDT (user
+ *      statically-defined tracing) probes, which may be attached with
+ *      bpftrace, perf, or SystemTap (e.g., "usdt:./app:terra_random:
+ *      source_return").  Each probe compiles to a single no-op instruction
+ *      plus an ELF note describing its location and arguments, so a probe
+ *      costs nothing unless a tracer is attached.
+ *
+ *      The probes, all in the "terra_random" provider, are:
+ *
+ *          source_entry(size)
+ *              A generator is about to read size octets from the sources.
+ *          source_return(size, octets, source)
+ *              The read produced octets of size octets, the last of them
+ *              from source (a RandomSource value, 0 if none).  A strict
+ *              read (FillRandomOctets()) that fails reports 0 octets.
+ *          fallback(from, to)
+ *              A request is continuing from source "from" to source "to".
+ *          refill_entry()
+ *              The seed pool is about to be refilled.
+ *          refill_return(octets, source)
+ *              The refill read octets from source before any fallback to
+ *              timing jitter.
+ *          reseed(hardware)
+ *              A generator was reseeded from the seed pool, with RDRAND
+ *              output mixed in if hardware is 1.
+ *          health_failure(source)
+ *              Octets read from source failed the health tests.
+ *          source_disabled(source)
+ *              The source failed the health tests repeatedly and will not
+ *              be used for a time.
+ *          fork_detected(generation)
+ *              The seed pool was found to have been inherited across
+ *              fork(); generation counts the forks seen by this process.
+ *
+ *  Portability Issues:
+ *      The probes are compiled in only where <sys/sdt.h> (provided by
+ *      SystemTap, e.g., in the systemtap-sdt-dev package) is available and
+ *      TERRA_RANDOM_NO_PROBES is not defined.  Otherwise, the macros expand
+ *      to nothing.
+ */
+
+#pragma once
+
+#if defined(__has_include) && !defined(TERRA_RANDOM_NO_PROBES)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define TERRA_RANDOM_PROBES
+#endif
+#endif
+
+#ifdef TERRA_RANDOM_PROBES
+#define TERRA_RANDOM_PROBE0(name) DTRACE_PROBE(terra_random, name)
+#define TERRA_RANDOM_PROBE1(name, a) DTRACE_PROBE1(terra_random, name, a)
+#define TERRA_RANDOM_PROBE2(name, a, b) \
+    DTRACE_PROBE2(terra_random, name, a, b)
+#define TERRA_RANDOM_PROBE3(name, a, b, c) \
+    DTRACE_PROBE3(terra_random, name, a, b, c)
+#else
+#define TERRA_RANDOM_PROBE0(name)
+#define TERRA_RANDOM_PROBE1(name, a)
+#define TERRA_RANDOM_PROBE2(name, a, b)
+#define TERRA_RANDOM_PROBE3(name, a, b, c)
+#endif
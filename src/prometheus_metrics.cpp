@@ -0,0 +1,345 @@
+/*
+ *  prometheus_metrics.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for WritePrometheusMetrics(), which renders the
+ *      generator metrics in the Prometheus text exposition format.
+ *
+ *      Latencies are exported in seconds, with histogram buckets at powers
+ *      of two nanoseconds from Min_Bucket_Exponent to Max_Bucket_Exponent
+ *      (about 32 ns to 67 ms).  All numbers are formatted from integers, so
+ *      the output is exact and identical on every platform.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <terra/random/generator_metrics.h>
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Range of exported histogram buckets, as powers of two nanoseconds
+constexpr std::size_t Min_Bucket_Exponent = 5;
+constexpr std::size_t Max_Bucket_Exponent = 26;
+
+// Writes text into a buffer, counting the length even when it does not fit
+class TextWriter
+{
+    public:
+        explicit TextWriter(std::span<char> buffer) noexcept :
+            buffer{buffer},
+            length{0}
+        {
+        }
+
+        void Write(std::string_view text) noexcept;
+        void Write(std::uint64_t value) noexcept;
+        void WriteSeconds(std::uint64_t nanoseconds) noexcept;
+        std::size_t GetLength() const noexcept { return length; }
+
+    protected:
+        std::span<char> buffer;
+        std::size_t length;
+};
+
+/*
+ *  TextWriter::Write()
+ *
+ *  Description:
+ *      Write text into the buffer.
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Text that does not fit is counted but not written.
+ */
+void TextWriter::Write(std::string_view text) noexcept
+{
+    if (length < buffer.size())
+    {
+        std::size_t fits = std::min(text.size(), buffer.size() - length);
+        std::copy_n(text.data(), fits, buffer.data() + length);
+    }
+
+    length += text.size();
+}
+
+/*
+ *  TextWriter::Write()
+ *
+ *  Description:
+ *      Write an integer in decimal into the buffer.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The value to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void TextWriter::Write(std::uint64_t value) noexcept
+{
+    char digits[20];
+    auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+
+    Write(std::string_view(digits, result.ptr));
+}
+
+/*
+ *  TextWriter::WriteSeconds()
+ *
+ *  Description:
+ *      Write a number of nanoseconds into the buffer as decimal seconds.
+ *
+ *  Parameters:
+ *      nanoseconds [in]
+ *          The time to write.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Trailing zeros in the fraction are omitted (e.g., 1500000000 is
+ *      written as "1.5").
+ */
+void TextWriter::WriteSeconds(std::uint64_t nanoseconds) noexcept
+{
+    std::uint64_t fraction = nanoseconds % 1'000'000'000;
+    char digits[10] = {'.'};
+    std::size_t digits_length = 10;
+
+    Write(nanoseconds / 1'000'000'000);
+
+    if (fraction == 0) return;
+
+    for (std::size_t i = 9; i > 0; i--)
+    {
+        digits[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    while (digits[digits_length - 1] == '0') digits_length--;
+
+    Write(std::string_view(digits, digits_length));
+}
+
+/*
+ *  WriteCounter()
+ *
+ *  Description:
+ *      Write a counter metric.
+ *
+ *  Parameters:
+ *      writer [in/out]
+ *          The writer to which the metric is written.
+ *
+ *      name [in]
+ *          The name of the metric, excluding the "_total" suffix.
+ *
+ *      help [in]
+ *          The description of the metric.
+ *
+ *      value [in]
+ *          The value of the counter.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void WriteCounter(TextWriter &writer,
+                  std::string_view name,
+                  std::string_view help,
+                  std::uint64_t value) noexcept
+{
+    writer.Write("# HELP ");
+    writer.Write(name);
+    writer.Write("_total ");
+    writer.Write(help);
+    writer.Write("\n# TYPE ");
+    writer.Write(name);
+    writer.Write("_total counter\n");
+    writer.Write(name);
+    writer.Write("_total ");
+    writer.Write(value);
+    writer.Write("\n");
+}
+
+/*
+ *  WriteHistogram()
+ *
+ *  Description:
+ *      Write a histogram metric.
+ *
+ *  Parameters:
+ *      writer [in/out]
+ *          The writer to which the metric is written.
+ *
+ *      name [in]
+ *          The name of the metric.
+ *
+ *      help [in]
+ *          The description of the metric.
+ *
+ *      histogram [in]
+ *          The latency histogram.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The exported buckets are cumulative, as Prometheus requires.
+ */
+void WriteHistogram(TextWriter &writer,
+                    std::string_view name,
+                    std::string_view help,
+                    const LatencyHistogram &histogram) noexcept
+{
+    std::uint64_t cumulative = 0;
+    std::size_t bucket = 0;
+
+    writer.Write("# HELP ");
+    writer.Write(name);
+    writer.Write(" ");
+    writer.Write(help);
+    writer.Write("\n# TYPE ");
+    writer.Write(name);
+    writer.Write(" histogram\n");
+
+    for (std::size_t exponent = Min_Bucket_Exponent;
+         exponent <= Max_Bucket_Exponent;
+         exponent++)
+    {
+        const std::uint64_t limit = std::uint64_t{1} << exponent;
+
+        while ((bucket < LatencyHistogram::Bucket_Count) &&
+               (LatencyHistogram::GetBucketLimit(bucket) <= limit))
+        {
+            cumulative += histogram.GetBucketCount(bucket++);
+        }
+
+        writer.Write(name);
+        writer.Write("_bucket{le=\"");
+        writer.WriteSeconds(limit);
+        writer.Write("\"} ");
+        writer.Write(cumulative);
+        writer.Write("\n");
+    }
+
+    writer.Write(name);
+    writer.Write("_bucket{le=\"+Inf\"} ");
+    writer.Write(histogram.GetCount());
+    writer.Write("\n");
+    writer.Write(name);
+    writer.Write("_sum ");
+    writer.WriteSeconds(histogram.GetSum());
+    writer.Write("\n");
+    writer.Write(name);
+    writer.Write("_count ");
+    writer.Write(histogram.GetCount());
+    writer.Write("\n");
+}
+
+} // namespace
+
+/*
+ *  WritePrometheusMetrics()
+ *
+ *  Description:
+ *      Render the generator metrics in the Prometheus text exposition
+ *      format (version 0.0.4).
+ *
+ *  Parameters:
+ *      metrics [in]
+ *          The metrics to render (e.g., from GetGeneratorMetrics()).
+ *
+ *      buffer [out]
+ *          The buffer into which the text is written.
+ *
+ *  Returns:
+ *      The length of the complete text.  If this is greater than the size
+ *      of the buffer, only the part that fits was written and the call
+ *      should be repeated with a larger buffer.
+ *
+ *  Comments:
+ *      No memory is allocated and the text is not terminated with a null
+ *      character.  Rendering from a single snapshot ensures every value in
+ *      the text comes from the same call to GetGeneratorMetrics().
+ */
+std::size_t WritePrometheusMetrics(const GeneratorMetrics &metrics,
+                                   std::span<char> buffer) noexcept
+{
+    TextWriter writer(buffer);
+    const GeneratorCounters &counters = metrics.counters;
+
+    WriteCounter(writer,
+                 "terra_random_octets_served",
+                 "Octets returned by random generators.",
+                 counters.octets_served);
+    WriteCounter(writer,
+                 "terra_random_source_octets",
+                 "Octets read from random sources.",
+                 counters.source_octets);
+    WriteCounter(writer,
+                 "terra_random_system_calls",
+                 "System calls made to read random sources.",
+                 counters.system_calls);
+    WriteCounter(writer,
+                 "terra_random_short_reads",
+                 "Reads from random sources producing too few octets.",
+                 counters.short_reads);
+    WriteCounter(writer,
+                 "terra_random_fallbacks",
+                 "Requests that required a fallback random source.",
+                 counters.fallbacks);
+    WriteCounter(writer,
+                 "terra_random_reseeds",
+                 "Reseeds of random generators.",
+                 counters.reseeds);
+    WriteCounter(writer,
+                 "terra_random_pool_refills",
+                 "Refills of the seed pool.",
+                 counters.pool_refills);
+    WriteCounter(writer,
+                 "terra_random_health_failures",
+                 "Reads from random sources failing the health tests.",
+                 counters.health_failures);
+    WriteCounter(writer,
+                 "terra_random_sources_disabled",
+                 "Random sources disabled after failing the health tests.",
+                 counters.sources_disabled);
+    WriteHistogram(writer,
+                   "terra_random_source_read_seconds",
+                   "Latency of reads from random sources (when timed).",
+                   metrics.source_latency);
+    WriteHistogram(writer,
+                   "terra_random_pool_refill_seconds",
+                   "Latency of seed pool refills.",
+                   metrics.refill_latency);
+
+    return writer.GetLength();
+}
+
+} // namespace Terra::Random
@@ -15,30 +15,61 @@
  *      None.
  */
 
-#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-#include <fcntl.h>
-#include <unistd.h>
-#elif defined(_WIN32)
-#include <ntstatus.h>
-// The following define is required as ntstatus.h would have already defined
-// various status definitions and, without it, there are redefinition errors
-#define WIN32_NO_STATUS
-#include <Windows.h>
-#include <bcrypt.h>
-#undef WIN32_NO_STATUS
-#endif
-#include <chrono>
-#include <cstdlib>
+#include <array>
+#include <cstring>
+#include <algorithm>
 #include <terra/random/random_generator.h>
+#include "os_source.h"
+#include "cpu_source.h"
+#include "metrics.h"
+#include "probes.h"
 
 namespace Terra::Random
 {
 
+namespace
+{
+
+// Number of 32-bit words of seed data used to seed a new engine
+constexpr std::size_t Seed_Words = RandomGenerator::Seed_Words;
+
+/*
+ *  InitialSeedData()
+ *
+ *  Description:
+ *      Produce seed data for a new engine from the shared seed pool.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The operating system source holding the seed pool.
+ *
+ *  Returns:
+ *      The seed data, which is used to initialize the engine's full state.
+ *
+ *  Comments:
+ *      The seed data holds 256 bits from the operating system, so distinct
+ *      generators do not share a stream even when a great many are created
+ *      at the same time.  This usually requires no system calls, since the
+ *      pool is refilled only when exhausted.
+ */
+std::array<std::uint32_t, Seed_Words> InitialSeedData(OSSource &source)
+{
+    std::array<std::uint32_t, Seed_Words> seed_data;
+    std::array<std::uint8_t, Seed_Words * 4> octets;
+
+    source.GetSeedOctets(octets);
+    std::memcpy(seed_data.data(), octets.data(), octets.size());
+
+    return seed_data;
+}
+
+} // namespace
+
 /*
- *  RandomGenerator::RandomGenerator()
+ *  BasicRandomGenerator::BasicRandomGenerator()
  *
  *  Description:
- *      Constructor for the RandomGenerator.
+ *      Constructor for the BasicRandomGenerator.
  *
  *  Parameters:
  *      pseudo_random_only [in]
@@ -49,69 +80,68 @@ namespace Terra::Random
  *      Nothing.
  *
  *  Comments:
- *      None.
+ *      The PRNG's full state is seeded once from 256 bits taken from the
+ *      shared seed pool.
  */
-RandomGenerator::RandomGenerator(bool pseudo_random_only) :
-    pseudo_random_only(pseudo_random_only),
+template<typename Engine>
+BasicRandomGenerator<Engine>::BasicRandomGenerator(
+                                                    bool pseudo_random_only) :
+    os_source{&OSSource::Acquire()},
+    random_engine(InitialSeedData(*os_source)),
     distribution(0, 255),
-    random_engine{static_cast<std::random_device::result_type>(
-        std::chrono::system_clock::now().time_since_epoch().count())}
+    pseudo_random_only(pseudo_random_only),
+    last_source{RandomSource::None}
 {
-#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-    if (pseudo_random_only)
-    {
-        random_fd = pseudo_random_fd = -1;
-    }
-    else
-    {
-        // Open /dev/random, which will yield the best source of random values
-        random_fd = open("/dev/random", O_NONBLOCK | O_RDONLY |  O_CLOEXEC);
-
-        // Open /dev/urandom, which will yield pseudo-random values
-        pseudo_random_fd =
-            open("/dev/urandom", O_NONBLOCK | O_RDONLY | O_CLOEXEC);
-    }
-#endif
-
-    try
-    {
-        // Get a random seed (this may throw an exception without random device)
-        random_engine.seed(std::random_device()());
-    }
-    catch (...)
-    {
-        // Just re-seed with the current time
-        random_engine.seed(static_cast<std::random_device::result_type>(
-            std::chrono::system_clock::now().time_since_epoch().count()));
-    }
 }
 
 /*
- *  RandomGenerator::~RandomGenerator()
+ *  BasicRandomGenerator::BasicRandomGenerator()
  *
  *  Description:
- *      Destructor for the RandomGenerator object.
+ *      Constructor for the BasicRandomGenerator that produces a reproducible
+ *      sequence of octets using only the PRNG.
  *
  *  Parameters:
- *      None.
+ *      seed_data [in]
+ *          Seed data used to initialize the full state of the PRNG.
  *
  *  Returns:
  *      Nothing.
  *
  *  Comments:
- *      None.
+ *      No entropy is read from the operating system.
  */
-RandomGenerator::~RandomGenerator()
+template<typename Engine>
+BasicRandomGenerator<Engine>::BasicRandomGenerator(
+                                    std::span<const std::uint32_t> seed_data) :
+    random_engine(seed_data),
+    distribution(0, 255),
+    pseudo_random_only(true),
+    last_source{RandomSource::None}
 {
-#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-    // Close the random file sources if they are open
-    if (random_fd >= 0) close(random_fd);
-    if (pseudo_random_fd >= 0) close(pseudo_random_fd);
-#endif
 }
 
 /*
- *  RandomGenerator::GetRandomOctet
+ *  BasicRandomGenerator::~BasicRandomGenerator()
+ *
+ *  Description:
+ *      Destructor for the BasicRandomGenerator object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The shared operating system source is not released, as it is
+ *      retained until the process exits (see OSSource::Acquire()).
+ */
+template<typename Engine>
+BasicRandomGenerator<Engine>::~BasicRandomGenerator() = default;
+
+/*
+ *  BasicRandomGenerator::GetRandomOctet
  *
  *  Description:
  *      Get a single random octet.
@@ -125,7 +155,8 @@ RandomGenerator::~RandomGenerator()
  *  Comments:
  *      None.
  */
-std::uint8_t RandomGenerator::GetRandomOctet() noexcept
+template<typename Engine>
+std::uint8_t BasicRandomGenerator<Engine>::GetRandomOctet() noexcept
 {
     std::uint8_t octet = 0;
 
@@ -135,11 +166,13 @@ std::uint8_t RandomGenerator::GetRandomOctet() noexcept
     // XOR that value with the C++ pseudo-random number generator
     octet ^= GetPseudoRandomOctet();
 
+    CountMetric(Counter::OctetsServed);
+
     return octet;
 }
 
 /*
- *  RandomGenerator::GetRandomOctets
+ *  BasicRandomGenerator::GetRandomOctets
  *
  *  Description:
  *      Get multiple random octets.
@@ -154,7 +187,9 @@ std::uint8_t RandomGenerator::GetRandomOctet() noexcept
  *  Comments:
  *      None.
  */
-std::vector<std::uint8_t> RandomGenerator::GetRandomOctets(std::size_t count)
+template<typename Engine>
+std::vector<std::uint8_t> BasicRandomGenerator<Engine>::GetRandomOctets(
+                                                            std::size_t count)
 {
     std::vector<std::uint8_t> octets(count);
 
@@ -168,11 +203,13 @@ std::vector<std::uint8_t> RandomGenerator::GetRandomOctets(std::size_t count)
     // number generator
     for (std::size_t i = 0; i < count; i++) octets[i] ^= GetPseudoRandomOctet();
 
+    CountMetric(Counter::OctetsServed, count);
+
     return octets;
 }
 
 /*
- *  RandomGenerator::GetRandomOctets
+ *  BasicRandomGenerator::GetRandomOctets
  *
  *  Description:
  *      Get multiple random octets.
@@ -188,7 +225,9 @@ std::vector<std::uint8_t> RandomGenerator::GetRandomOctets(std::size_t count)
  *  Comments:
  *      None.
  */
-void RandomGenerator::GetRandomOctets(std::span<std::uint8_t> octets) noexcept
+template<typename Engine>
+void BasicRandomGenerator<Engine>::GetRandomOctets(
+                                    std::span<std::uint8_t> octets) noexcept
 {
     // If requesting no values, return early
     if (octets.empty()) return;
@@ -199,10 +238,458 @@ void RandomGenerator::GetRandomOctets(std::span<std::uint8_t> octets) noexcept
     // XOR each of the random octets with octets from the C++ pseudo-random
     // number generator
     for (auto &octet : octets) octet ^= GetPseudoRandomOctet();
+
+    CountMetric(Counter::OctetsServed, octets.size());
+}
+
+/*
+ *  BasicRandomGenerator::FillRandomOctets
+ *
+ *  Description:
+ *      Fill the span with random octets, requiring that every octet be read
+ *      from the random sources (before being mixed with the PRNG).
+ *
+ *  Parameters:
+ *      octets [out]
+ *          A span into which random octets will be written.
+ *
+ *      budget [in]
+ *          The time allowed for retrying sources that fail.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::system_error if the random sources cannot produce all of
+ *      the octets, in which case the octets are cleared.
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::FillRandomOctets(
+                                            std::span<std::uint8_t> octets,
+                                            std::chrono::microseconds budget)
+{
+    std::error_code error;
+
+    FillRandomOctets(octets, error, budget);
+
+    if (error) throw std::system_error(error, "Unable to read random octets");
 }
 
 /*
- *  RandomGenerator::GetPseudoRandomOctet
+ *  BasicRandomGenerator::FillRandomOctets
+ *
+ *  Description:
+ *      Fill the span with random octets, requiring that every octet be read
+ *      from the random sources (before being mixed with the PRNG).
+ *
+ *  Parameters:
+ *      octets [out]
+ *          A span into which random octets will be written.
+ *
+ *      error [out]
+ *          Set to the error that prevented the span from being filled, or
+ *          cleared on success.
+ *
+ *      budget [in]
+ *          The time allowed for retrying sources that fail.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      On failure, the octets are cleared.  If the object was constructed
+ *      with pseudo_random_only set to true, the octets come only from the
+ *      PRNG, as with GetRandomOctets(), and no error is reported.  As with
+ *      SourceRandomOctets(), the read of the sources fires the source_entry
+ *      and source_return probes and its time is counted if enabled with
+ *      SetGeneratorTiming().
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::FillRandomOctets(
+                                    std::span<std::uint8_t> octets,
+                                    std::error_code &error,
+                                    std::chrono::microseconds budget) noexcept
+{
+    error.clear();
+
+    // If requesting no values, return early
+    if (octets.empty()) return;
+
+    if (pseudo_random_only)
+    {
+        last_source = RandomSource::None;
+    }
+    else
+    {
+        bool unhealthy = false;
+
+        if (os_source)
+        {
+            TERRA_RANDOM_PROBE1(source_entry, octets.size());
+
+            {
+                LatencyTimer timer(Latency::Source);
+
+                error = os_source->ReadAll(octets,
+                                           budget,
+                                           last_source,
+                                           unhealthy);
+            }
+
+            TERRA_RANDOM_PROBE3(source_return,
+                                octets.size(),
+                                error ? std::size_t{0} : octets.size(),
+                                static_cast<unsigned>(last_source));
+        }
+        else
+        {
+            error = std::make_error_code(std::errc::no_such_device);
+        }
+
+        if (error)
+        {
+            std::fill(octets.begin(), octets.end(), 0);
+            return;
+        }
+
+        if (unhealthy &&
+            (GetHealthTestResponse() == HealthTestResponse::Reseed))
+        {
+            Reseed();
+        }
+    }
+
+    // XOR each of the random octets with octets from the C++ pseudo-random
+    // number generator
+    for (auto &octet : octets) octet ^= GetPseudoRandomOctet();
+
+    CountMetric(Counter::OctetsServed, octets.size());
+}
+
+/*
+ *  BasicRandomGenerator::Seed
+ *
+ *  Description:
+ *      Seed the pseudo-random number generator.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data used to initialize the full state of the PRNG.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      When the object was constructed with pseudo_random_only set to true,
+ *      the sequence of octets produced after seeding is reproducible.
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::Seed(
+                                    std::span<const std::uint32_t> seed_data)
+{
+    random_engine.Seed(seed_data);
+}
+
+/*
+ *  BasicRandomGenerator::Reseed
+ *
+ *  Description:
+ *      Reseed the pseudo-random number generator from the operating system
+ *      or the processor.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The PRNG's full state is seeded from 256 bits taken from the shared
+ *      seed pool, as when the object is constructed.  If the processor
+ *      provides RDRAND, 256 bits produced by the processor are XORed into
+ *      the seed as an additional input, but are never used alone, since
+ *      the PRNG's own output is known for a generator seeded with caller
+ *      data.  The resulting sequence is unrelated to the sequence produced
+ *      before.
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::Reseed()
+{
+    if (!os_source) os_source = &OSSource::Acquire();
+
+    Reseed(InitialSeedData(*os_source));
+}
+
+/*
+ *  BasicRandomGenerator::Reseed
+ *
+ *  Description:
+ *      Reseed the pseudo-random number generator from the given seed data
+ *      read from the random sources (e.g., by a generator pool).
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed_Words words of seed data from the random sources.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      As with Reseed(), RDRAND output is XORed into the seed if available.
+ *      This neither locks nor allocates.
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::Reseed(
+                            std::span<const std::uint32_t> seed_data) noexcept
+{
+    std::array<std::uint32_t, Seed_Words> words{};
+    std::array<std::uint8_t, Seed_Words * 4> octets;
+
+    CountMetric(Counter::Reseeds);
+
+    distribution.reset();
+
+    std::copy_n(seed_data.begin(),
+                std::min(seed_data.size(), words.size()),
+                words.begin());
+    const bool hardware = (CPUSource::Read(octets) == octets.size());
+
+    if (hardware)
+    {
+        std::array<std::uint32_t, Seed_Words> hardware_data;
+
+        std::memcpy(hardware_data.data(), octets.data(), octets.size());
+        for (std::size_t i = 0; i < Seed_Words; i++)
+        {
+            words[i] ^= hardware_data[i];
+        }
+    }
+
+    random_engine.Seed(words);
+    TERRA_RANDOM_PROBE1(reseed, hardware ? 1 : 0);
+}
+
+/*
+ *  BasicRandomGenerator::Discard
+ *
+ *  Description:
+ *      Skip over the given number of pseudo-random octets.
+ *
+ *  Parameters:
+ *      count [in]
+ *          The number of octets to skip.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Each pseudo-random octet consumes exactly one value from the engine,
+ *      so this advances the engine by count steps in logarithmic time.
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::Discard(std::uint64_t count)
+{
+    random_engine.Discard(count);
+}
+
+/*
+ *  BasicRandomGenerator::Jump
+ *
+ *  Description:
+ *      Advance the pseudo-random number generator by the engine's jump
+ *      distance (e.g., 2^128 octets for MT19937).
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      To split a seeded sequence across N workers, seed N generators
+ *      identically and call Jump() i times on the i-th generator.
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::Jump()
+{
+    random_engine.Jump();
+}
+
+/*
+ *  BasicRandomGenerator::LongJump
+ *
+ *  Description:
+ *      Advance the pseudo-random number generator by the engine's long jump
+ *      distance (e.g., 2^192 octets for MT19937).
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This may be used to produce starting points for groups of workers,
+ *      each of which may then be split further using Jump().
+ */
+template<typename Engine>
+void BasicRandomGenerator<Engine>::LongJump()
+{
+    random_engine.LongJump();
+}
+
+/*
+ *  BasicRandomGenerator::SaveState
+ *
+ *  Description:
+ *      Save the state of the pseudo-random number generator.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The buffer into which the state is saved.  This must be at least
+ *          Saved_State_Size octets in length.
+ *
+ *  Returns:
+ *      The number of octets written, which is zero if the buffer is too
+ *      small.
+ *
+ *  Comments:
+ *      The buffer may be part of a memory-mapped checkpoint file.
+ */
+template<typename Engine>
+std::size_t BasicRandomGenerator<Engine>::SaveState(
+                            std::span<std::uint8_t> octets) const noexcept
+{
+    if (octets.size() < Saved_State_Size) return 0;
+
+    GeneratorStateView::WriteHeader(
+        octets,
+        Engine::Engine_Id,
+        pseudo_random_only ? GeneratorStateView::Pseudo_Random_Only_Flag : 0,
+        static_cast<std::uint32_t>(Engine::Saved_State_Size),
+        distribution.a(),
+        distribution.b());
+    random_engine.SaveState(
+        std::span<std::uint8_t, Engine::Saved_State_Size>(
+            octets.data() + GeneratorStateView::Header_Size,
+            Engine::Saved_State_Size));
+
+    return Saved_State_Size;
+}
+
+/*
+ *  BasicRandomGenerator::SaveState
+ *
+ *  Description:
+ *      Save the state of the pseudo-random number generator.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A vector containing the saved state.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+std::vector<std::uint8_t> BasicRandomGenerator<Engine>::SaveState() const
+{
+    std::vector<std::uint8_t> octets(Saved_State_Size);
+
+    SaveState(octets);
+
+    return octets;
+}
+
+/*
+ *  BasicRandomGenerator::LoadState
+ *
+ *  Description:
+ *      Restore the state of the pseudo-random number generator previously
+ *      saved with SaveState().
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The saved state.
+ *
+ *  Returns:
+ *      True if the state was restored, or false if the saved state is
+ *      invalid or does not correspond to this object, in which case the
+ *      object is unchanged.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+bool BasicRandomGenerator<Engine>::LoadState(
+                            std::span<const std::uint8_t> octets) noexcept
+{
+    return LoadState(GeneratorStateView(octets));
+}
+
+/*
+ *  BasicRandomGenerator::LoadState
+ *
+ *  Description:
+ *      Restore the state of the pseudo-random number generator previously
+ *      saved with SaveState().
+ *
+ *  Parameters:
+ *      state [in]
+ *          A view of the saved state, which might refer to a memory-mapped
+ *          checkpoint file.
+ *
+ *  Returns:
+ *      True if the state was restored, or false if the saved state is
+ *      invalid or does not correspond to this object, in which case the
+ *      object is unchanged.
+ *
+ *  Comments:
+ *      The saved state must be for the same engine and the same value of
+ *      pseudo_random_only as this object.
+ */
+template<typename Engine>
+bool BasicRandomGenerator<Engine>::LoadState(
+                                const GeneratorStateView &state) noexcept
+{
+    using result_type = typename Engine::result_type;
+
+    if (!state.IsValid()) return false;
+    if (state.GetEngineId() != Engine::Engine_Id) return false;
+    if (state.GetEngineState().size() != Engine::Saved_State_Size)
+    {
+        return false;
+    }
+    if (((state.GetFlags() & GeneratorStateView::Pseudo_Random_Only_Flag) !=
+         0) != pseudo_random_only)
+    {
+        return false;
+    }
+    if ((state.GetDistributionMin() > state.GetDistributionMax()) ||
+        (state.GetDistributionMax() > Engine::max()))
+    {
+        return false;
+    }
+
+    if (!random_engine.LoadState(
+            std::span<const std::uint8_t, Engine::Saved_State_Size>(
+                state.GetEngineState().data(),
+                Engine::Saved_State_Size)))
+    {
+        return false;
+    }
+
+    distribution.param(typename decltype(distribution)::param_type(
+        static_cast<result_type>(state.GetDistributionMin()),
+        static_cast<result_type>(state.GetDistributionMax())));
+    distribution.reset();
+
+    return true;
+}
+
+/*
+ *  BasicRandomGenerator::GetPseudoRandomOctet
  *
  *  Description:
  *      Get a single random octet.
@@ -216,17 +703,18 @@ void RandomGenerator::GetRandomOctets(std::span<std::uint8_t> octets) noexcept
  *  Comments:
  *      None.
  */
-std::uint8_t RandomGenerator::GetPseudoRandomOctet()
+template<typename Engine>
+std::uint8_t BasicRandomGenerator<Engine>::GetPseudoRandomOctet()
 {
     return distribution(random_engine);
 }
 
 /*
- *  RandomGenerator::SourceRandomOctets
+ *  BasicRandomGenerator::SourceRandomOctets
  *
  *  Description:
- *      Source the specified number of octets from the random and/or
- *      pseudo-random operating system sources.
+ *      Source the specified number of octets from the chain of random
+ *      sources probed for this system.
  *
  *  Parameters:
  *      buffer [in]
@@ -237,45 +725,55 @@ std::uint8_t RandomGenerator::GetPseudoRandomOctet()
  *      be smaller than the size of the span.
  *
  *  Comments:
- *      None.
+ *      The source that served the request is recorded for GetLastSource().
+ *      The time taken is counted if enabled with SetGeneratorTiming().
  */
-std::size_t RandomGenerator::SourceRandomOctets(
-                                std::span<std::uint8_t> buffer) const noexcept
+template<typename Engine>
+std::size_t BasicRandomGenerator<Engine>::SourceRandomOctets(
+                                    std::span<std::uint8_t> buffer) noexcept
 {
-    std::size_t octets_sourced = 0;
-
-    // If the count is zero or using the C++ PRNG, just return
-    if (buffer.empty() || pseudo_random_only) return 0;
+    // If the count is zero, there is no request to serve
+    if (buffer.empty()) return 0;
 
-#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-    // Attempt to read random values
-    if (random_fd >= 0)
+    // If using the C++ PRNG, no source serves the request
+    if (pseudo_random_only || !os_source)
     {
-        auto result = read(random_fd, buffer.data(), buffer.size());
-        if (result > 0) octets_sourced += result;
+        last_source = RandomSource::None;
+        return 0;
     }
 
-    // Attempt to read pseudo-random values if more octets are needed
-    if ((octets_sourced < buffer.size()) && (pseudo_random_fd >= 0))
+    std::size_t octets_sourced;
+    bool unhealthy;
+
+    TERRA_RANDOM_PROBE1(source_entry, buffer.size());
+
     {
-        auto result = read(pseudo_random_fd,
-                           buffer.data() + octets_sourced,
-                           buffer.size() - octets_sourced);
-        if (result > 0) octets_sourced += result;
+        LatencyTimer timer(Latency::Source);
+
+        octets_sourced = os_source->Read(buffer, last_source, unhealthy);
     }
-#elif defined(_WIN32)
-    // Source random octets from Windows' NIST SP800-90 compliant RNG, or
-    // prior to Vista SP1, a FIPS 186-2 compliant RNG
-    if (BCryptGenRandom(NULL,
-                        reinterpret_cast<PUCHAR>(buffer.data()),
-                        static_cast<ULONG>(buffer.size()),
-                        BCRYPT_USE_SYSTEM_PREFERRED_RNG) == STATUS_SUCCESS)
+
+    // Octets that failed the health tests were discarded, but ensure the
+    // PRNG with which these octets are mixed does not depend on them
+    if (unhealthy &&
+        (GetHealthTestResponse() == HealthTestResponse::Reseed))
     {
-        octets_sourced = buffer.size();
+        Reseed();
     }
-#endif
+
+    TERRA_RANDOM_PROBE3(source_return,
+                        buffer.size(),
+                        octets_sourced,
+                        static_cast<unsigned>(last_source));
 
     return octets_sourced;
 }
 
+// Instantiate the generator for each of the supported engines
+template class BasicRandomGenerator<MT19937>;
+template class BasicRandomGenerator<Xoshiro256PlusPlus>;
+template class BasicRandomGenerator<Xoshiro128PlusPlus>;
+template class BasicRandomGenerator<PCG32>;
+template class BasicRandomGenerator<Philox4x32>;
+
 } // namespace Terra::Random
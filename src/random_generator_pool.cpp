@@ -0,0 +1,426 @@
+/*
+ *  random_generator_pool.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the BasicRandomGeneratorPool object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <terra/random/random_generator_pool.h>
+#include "os_source.h"
+
+namespace Terra::Random
+{
+
+/*
+ *  BasicRandomGeneratorPool::BasicRandomGeneratorPool()
+ *
+ *  Description:
+ *      Constructor for the BasicRandomGeneratorPool object, which constructs
+ *      all of the pooled generators.
+ *
+ *  Parameters:
+ *      capacity [in]
+ *          The number of generators in the pool.
+ *
+ *      pseudo_random_only [in]
+ *          The pseudo_random_only argument given to each generator.
+ *
+ *      policy [in]
+ *          The action taken on a generator as it is returned to the pool.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::length_error if the capacity is too large.  The reserve
+ *      of seeds of each generator is filled when the generator is first
+ *      returned.
+ */
+template<typename Engine>
+BasicRandomGeneratorPool<Engine>::BasicRandomGeneratorPool(
+                                                std::size_t capacity,
+                                                bool pseudo_random_only,
+                                                PoolReturnPolicy policy) :
+    pseudo_random_only{pseudo_random_only},
+    policy{policy},
+    os_source{OSSource::Acquire()},
+    next{std::make_unique<Link[]>(capacity)},
+    head{Empty}
+{
+    if (capacity >= Empty)
+    {
+        throw std::length_error("Random generator pool capacity too large");
+    }
+
+    slots.reserve(capacity);
+    for (std::size_t i = 0; i < capacity; i++)
+    {
+        slots.emplace_back(pseudo_random_only);
+    }
+
+    // Place the generators on the free stack, with the first on top
+    for (std::size_t i = capacity; i > 0; i--)
+    {
+        Push(static_cast<std::uint32_t>(i - 1));
+    }
+}
+
+/*
+ *  BasicRandomGeneratorPool::Checkout()
+ *
+ *  Description:
+ *      Check out a generator from the pool.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      A lease on the generator, which returns the generator to the pool
+ *      when destroyed.
+ *
+ *  Comments:
+ *      If all pooled generators are checked out, a new generator is
+ *      constructed for the lease and destroyed when the lease is returned.
+ */
+template<typename Engine>
+typename BasicRandomGeneratorPool<Engine>::Lease
+    BasicRandomGeneratorPool<Engine>::Checkout()
+{
+    std::uint32_t slot = Pop();
+
+    if (slot == Empty)
+    {
+        return Lease(nullptr,
+                     0,
+                     std::make_unique<Generator>(pseudo_random_only));
+    }
+
+    return Lease(this, slot, nullptr);
+}
+
+/*
+ *  BasicRandomGeneratorPool::Push()
+ *
+ *  Description:
+ *      Push a generator onto the free stack.
+ *
+ *  Parameters:
+ *      slot [in]
+ *          The index of the generator.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The release ordering makes the generator's state visible to the
+ *      thread that next pops it.
+ */
+template<typename Engine>
+void BasicRandomGeneratorPool<Engine>::Push(std::uint32_t slot) noexcept
+{
+    std::uint64_t current = head.load(std::memory_order_relaxed);
+    std::uint64_t desired;
+
+    do
+    {
+        next[slot].next.store(static_cast<std::uint32_t>(current),
+                         std::memory_order_relaxed);
+        desired = (((current >> 32) + 1) << 32) | slot;
+    } while (!head.compare_exchange_weak(current,
+                                         desired,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+}
+
+/*
+ *  BasicRandomGeneratorPool::Pop()
+ *
+ *  Description:
+ *      Pop a generator from the free stack.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The index of the generator, or Empty if the stack is empty.
+ *
+ *  Comments:
+ *      The version tag in the head changes with every push and pop, so the
+ *      exchange fails if the head was popped and pushed again after its
+ *      successor was read.
+ */
+template<typename Engine>
+std::uint32_t BasicRandomGeneratorPool<Engine>::Pop() noexcept
+{
+    std::uint64_t current = head.load(std::memory_order_acquire);
+
+    while (static_cast<std::uint32_t>(current) != Empty)
+    {
+        std::uint32_t slot = static_cast<std::uint32_t>(current);
+        std::uint32_t successor =
+            next[slot].next.load(std::memory_order_relaxed);
+        std::uint64_t desired = (((current >> 32) + 1) << 32) | successor;
+
+        if (head.compare_exchange_weak(current,
+                                       desired,
+                                       std::memory_order_acquire,
+                                       std::memory_order_acquire))
+        {
+            return slot;
+        }
+    }
+
+    return Empty;
+}
+
+/*
+ *  BasicRandomGeneratorPool::Return()
+ *
+ *  Description:
+ *      Return a generator to the pool.
+ *
+ *  Parameters:
+ *      slot [in]
+ *          The index of the generator.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The generator is reseeded or advanced before it is made available.
+ *      Should Jump() fail (e.g., MT19937 failing to allocate memory), the
+ *      generator is reseeded instead.
+ */
+template<typename Engine>
+void BasicRandomGeneratorPool<Engine>::Return(std::uint32_t slot) noexcept
+{
+    bool reseed = (policy == PoolReturnPolicy::Reseed);
+
+    if (!reseed)
+    {
+        try
+        {
+            slots[slot].generator.Jump();
+        }
+        catch (...)
+        {
+            reseed = true;
+        }
+    }
+
+    if (reseed) Reseed(slots[slot]);
+
+    Push(slot);
+}
+
+/*
+ *  BasicRandomGeneratorPool::Reseed()
+ *
+ *  Description:
+ *      Reseed a pooled generator from its reserve of seeds, refilling the
+ *      reserve from the random sources if it is exhausted.
+ *
+ *  Parameters:
+ *      entry [in/out]
+ *          The slot holding the generator.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The reserve is read from the operating system's sources (never
+ *      RDRAND alone), which requires no lock.  Only if those sources fail
+ *      to fill the reserve is the remainder taken from the shared seed
+ *      pool, which requires the pool's lock.  Each seed is erased once
+ *      used.
+ */
+template<typename Engine>
+void BasicRandomGeneratorPool<Engine>::Reseed(Slot &entry) noexcept
+{
+    constexpr std::size_t Seed_Words = Generator::Seed_Words;
+
+    if (entry.seeds_used == Reserved_Seeds)
+    {
+        const std::span<std::uint8_t> octets(
+            reinterpret_cast<std::uint8_t *>(entry.seeds.data()),
+            entry.seeds.size() * sizeof(std::uint32_t));
+        RandomSource source;
+        bool unhealthy;
+
+        const std::size_t octets_sourced =
+            os_source.Read(octets, source, unhealthy, false);
+        if (octets_sourced < octets.size())
+        {
+            os_source.GetSeedOctets(octets.subspan(octets_sourced));
+        }
+
+        entry.seeds_used = 0;
+    }
+
+    const auto seed = std::span(entry.seeds).subspan(
+        entry.seeds_used * Seed_Words,
+        Seed_Words);
+
+    entry.generator.Reseed(seed);
+    std::fill(seed.begin(), seed.end(), 0);
+    entry.seeds_used++;
+}
+
+/*
+ *  BasicRandomGeneratorPool::Lease::Lease()
+ *
+ *  Description:
+ *      Constructor for the Lease object.
+ *
+ *  Parameters:
+ *      pool [in]
+ *          The pool that owns the generator, or nullptr if not pooled.
+ *
+ *      slot [in]
+ *          The index of the pooled generator.
+ *
+ *      overflow [in]
+ *          The generator if not pooled.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+BasicRandomGeneratorPool<Engine>::Lease::Lease(
+                            BasicRandomGeneratorPool *pool,
+                            std::uint32_t slot,
+                            std::unique_ptr<Generator> overflow) noexcept :
+    pool{pool},
+    slot{slot},
+    overflow{std::move(overflow)},
+    generator{pool ? &pool->slots[slot].generator : this->overflow.get()}
+{
+}
+
+/*
+ *  BasicRandomGeneratorPool::Lease::Lease()
+ *
+ *  Description:
+ *      Move constructor for the Lease object.
+ *
+ *  Parameters:
+ *      other [in]
+ *          The lease to move, which becomes empty.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+BasicRandomGeneratorPool<Engine>::Lease::Lease(Lease &&other) noexcept :
+    pool{std::exchange(other.pool, nullptr)},
+    slot{other.slot},
+    overflow{std::move(other.overflow)},
+    generator{std::exchange(other.generator, nullptr)}
+{
+}
+
+/*
+ *  BasicRandomGeneratorPool::Lease::~Lease()
+ *
+ *  Description:
+ *      Destructor for the Lease object, which returns the generator.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+BasicRandomGeneratorPool<Engine>::Lease::~Lease()
+{
+    Return();
+}
+
+/*
+ *  BasicRandomGeneratorPool::Lease::operator=()
+ *
+ *  Description:
+ *      Move assignment operator for the Lease object.
+ *
+ *  Parameters:
+ *      other [in]
+ *          The lease to move, which becomes empty.
+ *
+ *  Returns:
+ *      A reference to this object.
+ *
+ *  Comments:
+ *      Any generator held by this lease is returned first.
+ */
+template<typename Engine>
+typename BasicRandomGeneratorPool<Engine>::Lease &
+    BasicRandomGeneratorPool<Engine>::Lease::operator=(Lease &&other) noexcept
+{
+    if (this != &other)
+    {
+        Return();
+        pool = std::exchange(other.pool, nullptr);
+        slot = other.slot;
+        overflow = std::move(other.overflow);
+        generator = std::exchange(other.generator, nullptr);
+    }
+
+    return *this;
+}
+
+/*
+ *  BasicRandomGeneratorPool::Lease::Return()
+ *
+ *  Description:
+ *      Return the generator before the lease is destroyed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The lease is empty afterward.
+ */
+template<typename Engine>
+void BasicRandomGeneratorPool<Engine>::Lease::Return() noexcept
+{
+    if (pool != nullptr) pool->Return(slot);
+
+    pool = nullptr;
+    overflow.reset();
+    generator = nullptr;
+}
+
+// Instantiate the pool for each of the supported engines
+template class BasicRandomGeneratorPool<MT19937>;
+template class BasicRandomGeneratorPool<Xoshiro256PlusPlus>;
+template class BasicRandomGeneratorPool<Xoshiro128PlusPlus>;
+template class BasicRandomGeneratorPool<PCG32>;
+template class BasicRandomGeneratorPool<Philox4x32>;
+
+} // namespace Terra::Random
@@ -0,0 +1,262 @@
+/*
+ *  random_log.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the RandomLogWriter object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <chrono>
+#include <stdexcept>
+#include "random_log.h"
+#include "little_endian.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Time the writer thread sleeps when there is nothing to write
+constexpr std::chrono::milliseconds Idle_Interval{1};
+
+// Records up to this size are placed in the ring with a single write
+constexpr std::size_t Small_Record_Size = 64;
+
+} // namespace
+
+/*
+ *  RandomLogWriter::RandomLogWriter()
+ *
+ *  Description:
+ *      Constructor for the RandomLogWriter object, which creates the log
+ *      file and starts the writer thread.
+ *
+ *  Parameters:
+ *      filename [in]
+ *          The name of the log file to create.  An existing file is
+ *          replaced.
+ *
+ *      ring_size [in]
+ *          The size of the ring buffer between the caller and the writer
+ *          thread.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the file cannot be created.  The file
+ *      is owned by a std::unique_ptr, so it is closed if any later step
+ *      (ring allocation or starting the writer thread) throws.
+ */
+RandomLogWriter::RandomLogWriter(const std::string &filename,
+                                 std::size_t ring_size) :
+    file{std::fopen(filename.c_str(), "wb")},
+    ring{ring_size},
+    stopping{false},
+    failed{false}
+{
+    if (file == nullptr)
+    {
+        throw std::runtime_error("Unable to create random log: " + filename);
+    }
+
+    // Records are written in batches, so stdio buffering only adds a copy
+    std::setvbuf(file.get(), nullptr, _IONBF, 0);
+
+    std::array<std::uint8_t, Random_Log_Header_Size> header{};
+    std::copy(Random_Log_Magic.begin(), Random_Log_Magic.end(), header.begin());
+    StoreLittleEndian(header.data() + 4, Random_Log_Version);
+
+    if (std::fwrite(header.data(), 1, header.size(), file.get()) !=
+        header.size())
+    {
+        throw std::runtime_error("Unable to write random log: " + filename);
+    }
+
+    writer = std::thread(&RandomLogWriter::Drain, this);
+}
+
+/*
+ *  RandomLogWriter::~RandomLogWriter()
+ *
+ *  Description:
+ *      Destructor for the RandomLogWriter object, which writes any remaining
+ *      records and closes the log file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+RandomLogWriter::~RandomLogWriter()
+{
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+}
+
+/*
+ *  RandomLogWriter::Append()
+ *
+ *  Description:
+ *      Append a record to the log.
+ *
+ *  Parameters:
+ *      tag [in]
+ *          The call-site tag for the record.
+ *
+ *      octets [in]
+ *          The generated octets to record.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      This must only be called from one thread at a time.  Small records
+ *      are assembled on the stack so that each is placed in the ring with a
+ *      single release of the producer position.
+ */
+void RandomLogWriter::Append(std::uint32_t tag,
+                             std::span<const std::uint8_t> octets) noexcept
+{
+    std::array<std::uint8_t, Small_Record_Size> record;
+
+    while (!octets.empty())
+    {
+        std::size_t length = std::min(octets.size(), Max_Record_Length);
+
+        StoreLittleEndian(record.data(), tag);
+        StoreLittleEndian(record.data() + 4,
+                          static_cast<std::uint32_t>(length));
+
+        if (length <= Small_Record_Size - Random_Log_Record_Header_Size)
+        {
+            std::copy(octets.begin(),
+                      octets.begin() + length,
+                      record.begin() + Random_Log_Record_Header_Size);
+            Write({record.data(), Random_Log_Record_Header_Size + length});
+        }
+        else
+        {
+            Write({record.data(), Random_Log_Record_Header_Size});
+            Write(octets.first(length));
+        }
+
+        octets = octets.subspan(length);
+    }
+}
+
+/*
+ *  RandomLogWriter::Flush()
+ *
+ *  Description:
+ *      Wait until all appended records have been written to the file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if all records were written successfully, false if there was an
+ *      error writing to the file.
+ *
+ *  Comments:
+ *      None.
+ */
+bool RandomLogWriter::Flush() noexcept
+{
+    while (!ring.Empty()) std::this_thread::yield();
+
+    return !failed.load(std::memory_order_acquire);
+}
+
+/*
+ *  RandomLogWriter::Write()
+ *
+ *  Description:
+ *      Place the given octets into the ring, waiting for the writer thread
+ *      if the ring is full.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets to place into the ring.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void RandomLogWriter::Write(std::span<const std::uint8_t> octets) noexcept
+{
+    while (!octets.empty())
+    {
+        std::size_t length = ring.Write(octets);
+        if (length == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        octets = octets.subspan(length);
+    }
+}
+
+/*
+ *  RandomLogWriter::Drain()
+ *
+ *  Description:
+ *      Writer thread that moves records from the ring to the log file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      After a write error, records continue to be consumed (and discarded)
+ *      so that the caller is never blocked; the error is reported by
+ *      Flush().
+ */
+void RandomLogWriter::Drain() noexcept
+{
+    while (true)
+    {
+        auto octets = ring.Peek();
+
+        if (octets.empty())
+        {
+            // Check the ring again after stopping to get the final records
+            if (stopping.load(std::memory_order_acquire))
+            {
+                if (ring.Peek().empty()) break;
+                continue;
+            }
+            std::this_thread::sleep_for(Idle_Interval);
+            continue;
+        }
+
+        if (!failed.load(std::memory_order_relaxed) &&
+            (std::fwrite(octets.data(), 1, octets.size(), file.get()) !=
+             octets.size()))
+        {
+            failed.store(true, std::memory_order_release);
+        }
+
+        ring.Consume(octets.size());
+    }
+}
+
+} // namespace Terra::Random
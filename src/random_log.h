@@ -0,0 +1,93 @@
+/*
+ *  random_log.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines the format of the random log produced
+ *      by the recording generator and consumed by the replay generator, as
+ *      well as the RandomLogWriter object that writes the log.
+ *
+ *      The log has the following binary format, with all integers in
+ *      little-endian order:
+ *
+ *          Offset  Size  Field
+ *          0       4     Magic value "TRRL"
+ *          4       2     Format version (1)
+ *          6       2     Reserved (0)
+ *          8       ...   Records
+ *
+ *      Each record holds the output of one call to the generator:
+ *
+ *          Offset  Size  Field
+ *          0       4     Call-site tag
+ *          4       4     Length of the output
+ *          8       n     The output octets
+ *
+ *      Output longer than Max_Record_Length is split into multiple records
+ *      having the same tag.
+ *
+ *      The RandomLogWriter appends records to a lock-free ring buffer that is
+ *      drained to the file by a background thread, so the caller never waits
+ *      on file I/O unless the ring is full.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <string>
+#include <span>
+#include "octet_ring.h"
+
+namespace Terra::Random
+{
+
+// Log format constants
+constexpr std::array<std::uint8_t, 4> Random_Log_Magic = {'T', 'R', 'R', 'L'};
+constexpr std::uint16_t Random_Log_Version = 1;
+constexpr std::size_t Random_Log_Header_Size = 8;
+constexpr std::size_t Random_Log_Record_Header_Size = 8;
+constexpr std::size_t Max_Record_Length = 0xffff'ffff;
+
+// Closes a log file held by std::unique_ptr
+struct RandomLogFileCloser
+{
+    void operator()(std::FILE *file) const noexcept { std::fclose(file); }
+};
+
+class RandomLogWriter
+{
+    public:
+        RandomLogWriter(const std::string &filename, std::size_t ring_size);
+        ~RandomLogWriter();
+
+        void Append(std::uint32_t tag,
+                    std::span<const std::uint8_t> octets) noexcept;
+        bool Flush() noexcept;
+
+    protected:
+        void Write(std::span<const std::uint8_t> octets) noexcept;
+        void Drain() noexcept;
+
+        std::unique_ptr<std::FILE, RandomLogFileCloser> file;
+        OctetRing ring;
+        std::atomic<bool> stopping;
+        std::atomic<bool> failed;
+        std::thread writer;
+};
+
+} // namespace Terra::Random
@@ -0,0 +1,371 @@
+/*
+ *  random_tape.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the RandomTape object.
+ *
+ *  Portability Issues:
+ *      On systems without mmap(), the tape is read into memory.
+ */
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+#include <cstdio>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <terra/random/random_tape.h>
+#include <terra/random/parallel_fill.h>
+#include <terra/random/philox.h>
+#include "little_endian.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Magic value at the start of the tape
+constexpr std::array<std::uint8_t, 4> Magic = {'T', 'R', 'T', 'P'};
+
+// Size of each segment generated in memory while creating a tape; this is a
+// multiple of the Philox block size
+constexpr std::size_t Segment_Size = 64 * 1024 * 1024;
+
+} // namespace
+
+/*
+ *  RandomTape::Create()
+ *
+ *  Description:
+ *      Create a random tape file.
+ *
+ *  Parameters:
+ *      filename [in]
+ *          The name of the tape file to create.  An existing file is
+ *          replaced.
+ *
+ *      size [in]
+ *          The number of random octets on the tape.
+ *
+ *      seed [in]
+ *          The seed, which determines the content of the tape.
+ *
+ *      threads [in]
+ *          The number of threads used to generate the tape.  If zero, the
+ *          number of hardware threads is used.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The tape is generated in segments, so memory use does not depend on
+ *      the size of the tape.  Throws std::runtime_error if the file cannot
+ *      be written, in which case the partial file is removed.
+ */
+void RandomTape::Create(const std::string &filename,
+                        std::uint64_t size,
+                        std::uint64_t seed,
+                        unsigned threads)
+{
+    std::FILE *file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr)
+    {
+        throw std::runtime_error("Unable to create random tape: " + filename);
+    }
+
+    auto fail = [&]()
+    {
+        std::fclose(file);
+        std::remove(filename.c_str());
+        throw std::runtime_error("Unable to write random tape: " + filename);
+    };
+
+    std::vector<std::uint8_t> header(Data_Offset);
+    std::copy(Magic.begin(), Magic.end(), header.begin());
+    StoreLittleEndian(header.data() + 4, Version);
+    StoreLittleEndian(header.data() + 8, seed);
+    StoreLittleEndian(header.data() + 16, size);
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size())
+    {
+        fail();
+    }
+
+    std::vector<std::uint8_t> segment(
+        static_cast<std::size_t>(std::min<std::uint64_t>(size, Segment_Size)));
+
+    for (std::uint64_t offset = 0; offset < size; offset += Segment_Size)
+    {
+        std::span<std::uint8_t> octets(
+            segment.data(),
+            static_cast<std::size_t>(
+                std::min<std::uint64_t>(size - offset, Segment_Size)));
+
+        ParallelFill(octets, threads, seed, offset / Philox4x32::Block_Size);
+
+        if (std::fwrite(octets.data(), 1, octets.size(), file) !=
+            octets.size())
+        {
+            fail();
+        }
+    }
+
+    if (std::fclose(file) != 0)
+    {
+        std::remove(filename.c_str());
+        throw std::runtime_error("Unable to write random tape: " + filename);
+    }
+}
+
+/*
+ *  RandomTape::RandomTape()
+ *
+ *  Description:
+ *      Constructor for the RandomTape object, which maps the tape file.
+ *
+ *  Parameters:
+ *      filename [in]
+ *          The name of a tape file created with Create().
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the file cannot be read or is not a
+ *      random tape.
+ */
+RandomTape::RandomTape(const std::string &filename) : position{0}, seed{0}
+{
+    std::span<const std::uint8_t> file_octets;
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+    mapping = nullptr;
+    mapping_size = 0;
+
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Unable to open random tape: " + filename);
+    }
+
+    struct stat status;
+    if ((fstat(fd, &status) != 0) ||
+        (static_cast<std::uint64_t>(status.st_size) < Data_Offset))
+    {
+        close(fd);
+        throw std::runtime_error("Invalid random tape: " + filename);
+    }
+
+    std::size_t file_size = static_cast<std::size_t>(status.st_size);
+    void *address = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        throw std::runtime_error("Unable to map random tape: " + filename);
+    }
+    mapping = address;
+    mapping_size = file_size;
+    file_octets = {static_cast<const std::uint8_t *>(mapping), file_size};
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Unable to open random tape: " + filename);
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+    file_octets = buffer;
+#endif
+
+    std::uint64_t size = 0;
+    bool valid = (file_octets.size() >= Data_Offset) &&
+                 std::equal(Magic.begin(), Magic.end(), file_octets.begin()) &&
+                 (LoadLittleEndian<std::uint16_t>(file_octets.data() + 4) ==
+                  Version);
+    if (valid)
+    {
+        seed = LoadLittleEndian<std::uint64_t>(file_octets.data() + 8);
+        size = LoadLittleEndian<std::uint64_t>(file_octets.data() + 16);
+        valid = (file_octets.size() - Data_Offset >= size);
+    }
+    if (!valid)
+    {
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+        munmap(mapping, mapping_size);
+#endif
+        throw std::runtime_error("Invalid random tape: " + filename);
+    }
+
+    data = file_octets.subspan(Data_Offset, static_cast<std::size_t>(size));
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+    // The tape is usually read from beginning to end, and huge pages reduce
+    // TLB misses on large tapes where the file system supports them
+    madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(mapping, mapping_size, MADV_HUGEPAGE);
+#endif
+#endif
+}
+
+/*
+ *  RandomTape::~RandomTape()
+ *
+ *  Description:
+ *      Destructor for the RandomTape object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+RandomTape::~RandomTape()
+{
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+    munmap(mapping, mapping_size);
+#endif
+}
+
+/*
+ *  RandomTape::Seek()
+ *
+ *  Description:
+ *      Set the position on the tape from which the next octets are read.
+ *
+ *  Parameters:
+ *      offset [in]
+ *          The offset from the start of the tape's data.  This may be equal
+ *          to the size of the tape (i.e., the end).
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::out_of_range if the offset is beyond the end of the tape.
+ */
+void RandomTape::Seek(std::uint64_t offset)
+{
+    if (offset > data.size())
+    {
+        throw std::out_of_range("Random tape offset out of range");
+    }
+
+    position = static_cast<std::size_t>(offset);
+}
+
+/*
+ *  RandomTape::GetRandomOctet
+ *
+ *  Description:
+ *      Get the next octet from the tape.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The random octet.
+ *
+ *  Comments:
+ *      Throws std::out_of_range if the tape is exhausted.
+ */
+std::uint8_t RandomTape::GetRandomOctet()
+{
+    return ViewRandomOctets(1)[0];
+}
+
+/*
+ *  RandomTape::GetRandomOctets
+ *
+ *  Description:
+ *      Get the next octets from the tape.
+ *
+ *  Parameters:
+ *      count [in]
+ *          Number of random octets to return.
+ *
+ *  Returns:
+ *      A vector of random octets of the requested count.
+ *
+ *  Comments:
+ *      Throws std::out_of_range if the tape is exhausted.
+ */
+std::vector<std::uint8_t> RandomTape::GetRandomOctets(std::size_t count)
+{
+    auto octets = ViewRandomOctets(count);
+
+    return {octets.begin(), octets.end()};
+}
+
+/*
+ *  RandomTape::GetRandomOctets
+ *
+ *  Description:
+ *      Get the next octets from the tape.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          A span into which random octets will be written.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::out_of_range if the tape is exhausted.
+ */
+void RandomTape::GetRandomOctets(std::span<std::uint8_t> octets)
+{
+    auto tape_octets = ViewRandomOctets(octets.size());
+
+    std::copy(tape_octets.begin(), tape_octets.end(), octets.begin());
+}
+
+/*
+ *  RandomTape::ViewRandomOctets
+ *
+ *  Description:
+ *      Get the next octets from the tape without copying them.
+ *
+ *  Parameters:
+ *      count [in]
+ *          Number of random octets to return.
+ *
+ *  Returns:
+ *      A span of the octets on the tape, which remains valid for the
+ *      lifetime of this object.
+ *
+ *  Comments:
+ *      Throws std::out_of_range if the tape is exhausted, in which case the
+ *      position is unchanged.
+ */
+std::span<const std::uint8_t> RandomTape::ViewRandomOctets(std::size_t count)
+{
+    if (count > data.size() - position)
+    {
+        throw std::out_of_range("Random tape exhausted");
+    }
+
+    auto octets = data.subspan(position, count);
+    position += count;
+
+    return octets;
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,192 @@
+/*
+ *  recording_generator.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the BasicRecordingGenerator object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <terra/random/recording_generator.h>
+#include "random_log.h"
+
+namespace Terra::Random
+{
+
+/*
+ *  BasicRecordingGenerator::BasicRecordingGenerator()
+ *
+ *  Description:
+ *      Constructor for the BasicRecordingGenerator object.
+ *
+ *  Parameters:
+ *      generator [in]
+ *          The generator whose output is to be recorded.
+ *
+ *      filename [in]
+ *          The name of the log file to create.  An existing file is
+ *          replaced.
+ *
+ *      ring_size [in]
+ *          The size of the ring buffer that holds records until they are
+ *          written to the file by the background thread.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the log file cannot be created.
+ */
+template<typename Engine>
+BasicRecordingGenerator<Engine>::BasicRecordingGenerator(
+                                    BasicRandomGenerator<Engine> &generator,
+                                    const std::string &filename,
+                                    std::size_t ring_size) :
+    generator{generator},
+    writer{std::make_unique<RandomLogWriter>(filename, ring_size)}
+{
+}
+
+/*
+ *  BasicRecordingGenerator::~BasicRecordingGenerator()
+ *
+ *  Description:
+ *      Destructor for the BasicRecordingGenerator object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Any records not yet written are written before the log is closed.
+ */
+template<typename Engine>
+BasicRecordingGenerator<Engine>::~BasicRecordingGenerator() = default;
+
+/*
+ *  BasicRecordingGenerator::GetRandomOctet
+ *
+ *  Description:
+ *      Get a single random octet and record it.
+ *
+ *  Parameters:
+ *      tag [in]
+ *          A value identifying the call site, which is verified on replay.
+ *
+ *  Returns:
+ *      The random octet.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+std::uint8_t BasicRecordingGenerator<Engine>::GetRandomOctet(
+                                                std::uint32_t tag) noexcept
+{
+    std::uint8_t octet = generator.GetRandomOctet();
+
+    writer->Append(tag, {&octet, 1});
+
+    return octet;
+}
+
+/*
+ *  BasicRecordingGenerator::GetRandomOctets
+ *
+ *  Description:
+ *      Get multiple random octets and record them.
+ *
+ *  Parameters:
+ *      count [in]
+ *          Number of random octets to return.
+ *
+ *      tag [in]
+ *          A value identifying the call site, which is verified on replay.
+ *
+ *  Returns:
+ *      A vector of random octets of the requested count.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+std::vector<std::uint8_t> BasicRecordingGenerator<Engine>::GetRandomOctets(
+                                                        std::size_t count,
+                                                        std::uint32_t tag)
+{
+    std::vector<std::uint8_t> octets(count);
+
+    GetRandomOctets(octets, tag);
+
+    return octets;
+}
+
+/*
+ *  BasicRecordingGenerator::GetRandomOctets
+ *
+ *  Description:
+ *      Get multiple random octets and record them.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          A span into which random octets will be written.
+ *
+ *      tag [in]
+ *          A value identifying the call site, which is verified on replay.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Requests for no octets are not recorded.
+ */
+template<typename Engine>
+void BasicRecordingGenerator<Engine>::GetRandomOctets(
+                                            std::span<std::uint8_t> octets,
+                                            std::uint32_t tag) noexcept
+{
+    generator.GetRandomOctets(octets);
+
+    writer->Append(tag, octets);
+}
+
+/*
+ *  BasicRecordingGenerator::Flush
+ *
+ *  Description:
+ *      Wait until all recorded octets have been written to the log file.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the log has been written successfully, false if there was an
+ *      error writing to the log file.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Engine>
+bool BasicRecordingGenerator<Engine>::Flush() noexcept
+{
+    return writer->Flush();
+}
+
+// Instantiate the recording generator for each of the supported engines
+template class BasicRecordingGenerator<MT19937>;
+template class BasicRecordingGenerator<Xoshiro256PlusPlus>;
+template class BasicRecordingGenerator<Xoshiro128PlusPlus>;
+template class BasicRecordingGenerator<PCG32>;
+template class BasicRecordingGenerator<Philox4x32>;
+
+} // namespace Terra::Random
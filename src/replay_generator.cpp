@@ -0,0 +1,295 @@
+/*
+ *  replay_generator.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the ReplayGenerator object.
+ *
+ *  Portability Issues:
+ *      On systems without mmap(), the log is read into memory.
+ */
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+#include <algorithm>
+#include <stdexcept>
+#include <terra/random/replay_generator.h>
+#include "random_log.h"
+#include "little_endian.h"
+
+namespace Terra::Random
+{
+
+/*
+ *  ReplayGenerator::ReplayGenerator()
+ *
+ *  Description:
+ *      Constructor for the ReplayGenerator object.
+ *
+ *  Parameters:
+ *      filename [in]
+ *          The name of a log file written by a BasicRecordingGenerator.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the file cannot be read or is not a
+ *      random log.
+ */
+ReplayGenerator::ReplayGenerator(const std::string &filename) :
+    position{Random_Log_Header_Size}
+{
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+    mapping = nullptr;
+
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Unable to open random log: " + filename);
+    }
+
+    struct stat status;
+    if ((fstat(fd, &status) != 0) ||
+        (static_cast<std::size_t>(status.st_size) < Random_Log_Header_Size))
+    {
+        close(fd);
+        throw std::runtime_error("Invalid random log: " + filename);
+    }
+
+    std::size_t size = static_cast<std::size_t>(status.st_size);
+    void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        throw std::runtime_error("Unable to map random log: " + filename);
+    }
+    mapping = address;
+
+    // The log is consumed from beginning to end
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    log = {static_cast<const std::uint8_t *>(mapping), size};
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Unable to open random log: " + filename);
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+    log = buffer;
+#endif
+
+    if ((log.size() < Random_Log_Header_Size) ||
+        !std::equal(Random_Log_Magic.begin(),
+                    Random_Log_Magic.end(),
+                    log.begin()) ||
+        (LoadLittleEndian<std::uint16_t>(log.data() + 4) !=
+         Random_Log_Version))
+    {
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+        munmap(mapping, log.size());
+#endif
+        throw std::runtime_error("Invalid random log: " + filename);
+    }
+}
+
+/*
+ *  ReplayGenerator::~ReplayGenerator()
+ *
+ *  Description:
+ *      Destructor for the ReplayGenerator object.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+ReplayGenerator::~ReplayGenerator()
+{
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+    munmap(mapping, log.size());
+#endif
+}
+
+/*
+ *  ReplayGenerator::GetRandomOctet
+ *
+ *  Description:
+ *      Get the next recorded octet.
+ *
+ *  Parameters:
+ *      tag [in]
+ *          The call-site tag, which must match the recorded tag.
+ *
+ *  Returns:
+ *      The recorded octet.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the replay has diverged.
+ */
+std::uint8_t ReplayGenerator::GetRandomOctet(std::uint32_t tag)
+{
+    return ViewRandomOctets(1, tag)[0];
+}
+
+/*
+ *  ReplayGenerator::GetRandomOctets
+ *
+ *  Description:
+ *      Get the next recorded octets.
+ *
+ *  Parameters:
+ *      count [in]
+ *          Number of octets to return.
+ *
+ *      tag [in]
+ *          The call-site tag, which must match the recorded tag.
+ *
+ *  Returns:
+ *      A vector of the recorded octets.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the replay has diverged.
+ */
+std::vector<std::uint8_t> ReplayGenerator::GetRandomOctets(std::size_t count,
+                                                           std::uint32_t tag)
+{
+    std::vector<std::uint8_t> octets(count);
+
+    GetRandomOctets(octets, tag);
+
+    return octets;
+}
+
+/*
+ *  ReplayGenerator::GetRandomOctets
+ *
+ *  Description:
+ *      Get the next recorded octets.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          A span into which the recorded octets will be written.
+ *
+ *      tag [in]
+ *          The call-site tag, which must match the recorded tag.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the replay has diverged.  Large requests
+ *      are split across records exactly as they were when recorded.
+ */
+void ReplayGenerator::GetRandomOctets(std::span<std::uint8_t> octets,
+                                      std::uint32_t tag)
+{
+    while (!octets.empty())
+    {
+        std::size_t length = std::min(octets.size(), Max_Record_Length);
+        auto recorded = ViewRandomOctets(length, tag);
+
+        std::copy(recorded.begin(), recorded.end(), octets.begin());
+        octets = octets.subspan(length);
+    }
+}
+
+/*
+ *  ReplayGenerator::ViewRandomOctets
+ *
+ *  Description:
+ *      Get the next recorded octets without copying them.
+ *
+ *  Parameters:
+ *      count [in]
+ *          Number of octets to return, which must not exceed the maximum
+ *          record length (2^32 - 1).
+ *
+ *      tag [in]
+ *          The call-site tag, which must match the recorded tag.
+ *
+ *  Returns:
+ *      A span of the recorded octets, which remains valid for the lifetime
+ *      of this object.
+ *
+ *  Comments:
+ *      Throws std::runtime_error if the replay has diverged.
+ */
+std::span<const std::uint8_t> ReplayGenerator::ViewRandomOctets(
+                                                        std::size_t count,
+                                                        std::uint32_t tag)
+{
+    if (count == 0) return {};
+
+    if (log.size() - position < Random_Log_Record_Header_Size)
+    {
+        throw std::runtime_error("Random log exhausted");
+    }
+
+    auto recorded_tag = LoadLittleEndian<std::uint32_t>(log.data() + position);
+    auto recorded_length =
+        LoadLittleEndian<std::uint32_t>(log.data() + position + 4);
+
+    if (recorded_tag != tag)
+    {
+        throw std::runtime_error("Random log tag mismatch: expected " +
+                                 std::to_string(recorded_tag) + ", got " +
+                                 std::to_string(tag));
+    }
+    if (recorded_length != count)
+    {
+        throw std::runtime_error("Random log length mismatch: expected " +
+                                 std::to_string(recorded_length) + ", got " +
+                                 std::to_string(count));
+    }
+    if (log.size() - position - Random_Log_Record_Header_Size < count)
+    {
+        throw std::runtime_error("Random log truncated");
+    }
+
+    auto octets = log.subspan(position + Random_Log_Record_Header_Size, count);
+    position += Random_Log_Record_Header_Size + count;
+
+    return octets;
+}
+
+/*
+ *  ReplayGenerator::AtEnd
+ *
+ *  Description:
+ *      Determine whether all recorded octets have been replayed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if there are no more records in the log.
+ *
+ *  Comments:
+ *      None.
+ */
+bool ReplayGenerator::AtEnd() const noexcept
+{
+    return position >= log.size();
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,161 @@
+/*
+ *  siphash.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation of SipHash-2-4 with 128-bit output.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <bit>
+#include "siphash.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// SipHash state
+struct SipState
+{
+    std::uint64_t v0;
+    std::uint64_t v1;
+    std::uint64_t v2;
+    std::uint64_t v3;
+};
+
+/*
+ *  SipRound()
+ *
+ *  Description:
+ *      Perform one SipHash round.
+ *
+ *  Parameters:
+ *      state [in/out]
+ *          The SipHash state.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr void SipRound(SipState &state) noexcept
+{
+    state.v0 += state.v1;
+    state.v1 = std::rotl(state.v1, 13);
+    state.v1 ^= state.v0;
+    state.v0 = std::rotl(state.v0, 32);
+    state.v2 += state.v3;
+    state.v3 = std::rotl(state.v3, 16);
+    state.v3 ^= state.v2;
+    state.v0 += state.v3;
+    state.v3 = std::rotl(state.v3, 21);
+    state.v3 ^= state.v0;
+    state.v2 += state.v1;
+    state.v1 = std::rotl(state.v1, 17);
+    state.v1 ^= state.v2;
+    state.v2 = std::rotl(state.v2, 32);
+}
+
+/*
+ *  Compress()
+ *
+ *  Description:
+ *      Absorb one 64-bit message word.
+ *
+ *  Parameters:
+ *      state [in/out]
+ *          The SipHash state.
+ *
+ *      word [in]
+ *          The message word.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr void Compress(SipState &state, std::uint64_t word) noexcept
+{
+    state.v3 ^= word;
+    SipRound(state);
+    SipRound(state);
+    state.v0 ^= word;
+}
+
+} // namespace
+
+/*
+ *  SipHash128()
+ *
+ *  Description:
+ *      Compute SipHash-2-4 with 128-bit output over the given message.
+ *
+ *  Parameters:
+ *      key [in]
+ *          The 128-bit key as two 64-bit words (the little-endian reading of
+ *          the 16 key octets).
+ *
+ *      message [in]
+ *          The message to hash.
+ *
+ *  Returns:
+ *      The 128-bit hash as two 64-bit words.
+ *
+ *  Comments:
+ *      None.
+ */
+std::array<std::uint64_t, 2> SipHash128(
+                                const std::array<std::uint64_t, 2> &key,
+                                std::span<const std::uint8_t> message) noexcept
+{
+    SipState state{key[0] ^ 0x736f'6d65'7073'6575,
+                   key[1] ^ 0x646f'7261'6e64'6f6d ^ 0xee,
+                   key[0] ^ 0x6c79'6765'6e65'7261,
+                   key[1] ^ 0x7465'6462'7974'6573};
+    std::uint64_t word = 0;
+    std::size_t i = 0;
+
+    // Absorb whole words
+    for (; i + 8 <= message.size(); i += 8)
+    {
+        word = 0;
+        for (std::size_t j = 0; j < 8; j++)
+        {
+            word |= static_cast<std::uint64_t>(message[i + j]) << (8 * j);
+        }
+        Compress(state, word);
+    }
+
+    // Absorb the final word, which includes the message length
+    word = static_cast<std::uint64_t>(message.size()) << 56;
+    for (std::size_t j = 0; i + j < message.size(); j++)
+    {
+        word |= static_cast<std::uint64_t>(message[i + j]) << (8 * j);
+    }
+    Compress(state, word);
+
+    // Finalize
+    std::array<std::uint64_t, 2> result;
+    state.v2 ^= 0xee;
+    for (unsigned round = 0; round < 4; round++) SipRound(state);
+    result[0] = state.v0 ^ state.v1 ^ state.v2 ^ state.v3;
+    state.v1 ^= 0xdd;
+    for (unsigned round = 0; round < 4; round++) SipRound(state);
+    result[1] = state.v0 ^ state.v1 ^ state.v2 ^ state.v3;
+
+    return result;
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,33 @@
+/*
+ *  siphash.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines SipHash-2-4 with 128-bit output, the
+ *      keyed pseudo-random function by Aumasson and Bernstein.  This is used
+ *      to derive independent keys and seeds from a parent key.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <span>
+
+namespace Terra::Random
+{
+
+std::array<std::uint64_t, 2> SipHash128(
+                                const std::array<std::uint64_t, 2> &key,
+                                std::span<const std::uint8_t> message) noexcept;
+
+} // namespace Terra::Random
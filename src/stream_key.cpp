@@ -0,0 +1,186 @@
+/*
+ *  stream_key.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the StreamKey object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <terra/random/stream_key.h>
+#include "siphash.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Tags that distinguish the types of path elements
+constexpr std::uint8_t Integer_Tag = 0x01;
+constexpr std::uint8_t String_Tag = 0x02;
+
+/*
+ *  StoreWord()
+ *
+ *  Description:
+ *      Store a 64-bit value into a message in little-endian order.
+ *
+ *  Parameters:
+ *      message [in/out]
+ *          The message into which the value is stored.
+ *
+ *      offset [in]
+ *          The offset within the message at which to store the value.
+ *
+ *      value [in]
+ *          The value to store.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+template<typename Message>
+void StoreWord(Message &message, std::size_t offset, std::uint64_t value)
+{
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        message[offset + i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+/*
+ *  StreamKey::StreamKey()
+ *
+ *  Description:
+ *      Constructor for the StreamKey object that forms the root key from a
+ *      master seed.
+ *
+ *  Parameters:
+ *      master_seed [in]
+ *          The master seed.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The master seed is hashed so that similar seeds (e.g., 1 and 2)
+ *      produce unrelated root keys.
+ */
+StreamKey::StreamKey(std::uint64_t master_seed) noexcept :
+    value{SipHash128({master_seed, 0}, {})}
+{
+}
+
+/*
+ *  StreamKey::StreamKey()
+ *
+ *  Description:
+ *      Constructor for the StreamKey object using the given key value.
+ *
+ *  Parameters:
+ *      value [in]
+ *          The 128-bit key value (e.g., previously returned by GetValue()).
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+StreamKey::StreamKey(const Value &value) noexcept : value{value}
+{
+}
+
+/*
+ *  StreamKey::Derive()
+ *
+ *  Description:
+ *      Derive a child key for the given integer path element.
+ *
+ *  Parameters:
+ *      id [in]
+ *          The path element.
+ *
+ *  Returns:
+ *      The child key.
+ *
+ *  Comments:
+ *      None.
+ */
+StreamKey StreamKey::Derive(std::uint64_t id) const
+{
+    std::array<std::uint8_t, 9> message;
+
+    message[0] = Integer_Tag;
+    StoreWord(message, 1, id);
+
+    return StreamKey(SipHash128(value, message));
+}
+
+/*
+ *  StreamKey::Derive()
+ *
+ *  Description:
+ *      Derive a child key for the given string path element.
+ *
+ *  Parameters:
+ *      label [in]
+ *          The path element.
+ *
+ *  Returns:
+ *      The child key.
+ *
+ *  Comments:
+ *      The string is prefixed with its length, so the encoding of each path
+ *      element is unambiguous.
+ */
+StreamKey StreamKey::Derive(std::string_view label) const
+{
+    std::vector<std::uint8_t> message(9 + label.size());
+
+    message[0] = String_Tag;
+    StoreWord(message, 1, label.size());
+    std::copy(label.begin(), label.end(), message.begin() + 9);
+
+    return StreamKey(SipHash128(value, message));
+}
+
+/*
+ *  StreamKey::SeedData()
+ *
+ *  Description:
+ *      Return seed data for seeding an engine or generator with this key.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The key as four 32-bit words.
+ *
+ *  Comments:
+ *      None.
+ */
+StreamKey::SeedWords StreamKey::SeedData() const noexcept
+{
+    return {static_cast<std::uint32_t>(value[0]),
+            static_cast<std::uint32_t>(value[0] >> 32),
+            static_cast<std::uint32_t>(value[1]),
+            static_cast<std::uint32_t>(value[1] >> 32)};
+}
+
+} // namespace Terra::Random
@@ -0,0 +1,351 @@
+/*
+ *  vdso_getrandom.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the vDSO getrandom() functions.
+ *
+ *  Portability Issues:
+ *      Only available on Linux on x86-64 and AArch64 processors.
+ */
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#include <elf.h>
+#include <link.h>
+#include <unistd.h>
+#include <sys/auxv.h>
+#include <sys/mman.h>
+#define TERRA_RANDOM_VDSO
+#endif
+#include <cerrno>
+#include <cstring>
+#include "vdso_getrandom.h"
+
+namespace Terra::Random
+{
+
+#ifdef TERRA_RANDOM_VDSO
+
+namespace
+{
+
+// Name of the getrandom() function exported by the vDSO
+#if defined(__x86_64__)
+constexpr const char *VDSO_Symbol = "__vdso_getrandom";
+#else
+constexpr const char *VDSO_Symbol = "__kernel_getrandom";
+#endif
+
+// Parameters for allocating the per-thread state, returned by the kernel
+struct OpaqueParams
+{
+    std::uint32_t size_of_opaque_state;
+    std::uint32_t mmap_prot;
+    std::uint32_t mmap_flags;
+    std::uint32_t reserved[13];
+};
+
+// The vDSO function
+using GetRandomFunction = long (*)(void *buffer,
+                                   std::size_t length,
+                                   unsigned flags,
+                                   void *opaque_state,
+                                   std::size_t opaque_length);
+
+// The located vDSO function and the parameters for its state
+struct VDSO
+{
+    GetRandomFunction function = nullptr;
+    OpaqueParams params{};
+    std::size_t state_size = 0;
+};
+
+// A thread's state, which is unmapped when the thread exits
+struct ThreadState
+{
+    ThreadState() = default;
+    ThreadState(const ThreadState &) = delete;
+    ~ThreadState()
+    {
+        if (state != nullptr) munmap(state, size);
+    }
+    ThreadState &operator=(const ThreadState &) = delete;
+
+    void *state = nullptr;
+    std::size_t size = 0;
+    bool failed = false;
+};
+
+/*
+ *  FindVDSOSymbol()
+ *
+ *  Description:
+ *      Locate a function exported by the vDSO.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The name of the function.
+ *
+ *  Returns:
+ *      The address of the function, or nullptr if it is not exported.
+ *
+ *  Comments:
+ *      Symbol versions are not checked, as each vDSO function has only one
+ *      version.
+ */
+void *FindVDSOSymbol(const char *name) noexcept
+{
+    auto base = getauxval(AT_SYSINFO_EHDR);
+    if (base == 0) return nullptr;
+
+    const auto *header = reinterpret_cast<const ElfW(Ehdr) *>(base);
+    const auto *program_headers = reinterpret_cast<const ElfW(Phdr) *>(
+        base + header->e_phoff);
+    const ElfW(Dyn) *dynamic = nullptr;
+    ElfW(Addr) load_offset = 0;
+    bool found_load = false;
+
+    for (std::size_t i = 0; i < header->e_phnum; i++)
+    {
+        const auto &program_header = program_headers[i];
+
+        if ((program_header.p_type == PT_LOAD) && !found_load)
+        {
+            load_offset = base + program_header.p_offset -
+                          program_header.p_vaddr;
+            found_load = true;
+        }
+        else if (program_header.p_type == PT_DYNAMIC)
+        {
+            dynamic = reinterpret_cast<const ElfW(Dyn) *>(
+                base + program_header.p_offset);
+        }
+    }
+
+    if (!found_load || (dynamic == nullptr)) return nullptr;
+
+    const ElfW(Sym) *symbols = nullptr;
+    const char *strings = nullptr;
+    const ElfW(Word) *hash = nullptr;
+
+    for (const auto *entry = dynamic; entry->d_tag != DT_NULL; entry++)
+    {
+        switch (entry->d_tag)
+        {
+            case DT_SYMTAB:
+                symbols = reinterpret_cast<const ElfW(Sym) *>(
+                    load_offset + entry->d_un.d_ptr);
+                break;
+
+            case DT_STRTAB:
+                strings = reinterpret_cast<const char *>(
+                    load_offset + entry->d_un.d_ptr);
+                break;
+
+            case DT_HASH:
+                hash = reinterpret_cast<const ElfW(Word) *>(
+                    load_offset + entry->d_un.d_ptr);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if ((symbols == nullptr) || (strings == nullptr) || (hash == nullptr))
+    {
+        return nullptr;
+    }
+
+    // The second word of the hash table is the number of symbols
+    for (ElfW(Word) i = 0; i < hash[1]; i++)
+    {
+        const auto &symbol = symbols[i];
+
+        if ((ELF64_ST_TYPE(symbol.st_info) == STT_FUNC) &&
+            (symbol.st_shndx != SHN_UNDEF) &&
+            (std::strcmp(strings + symbol.st_name, name) == 0))
+        {
+            return reinterpret_cast<void *>(load_offset + symbol.st_value);
+        }
+    }
+
+    return nullptr;
+}
+
+/*
+ *  GetVDSO()
+ *
+ *  Description:
+ *      Locate the vDSO getrandom() function and query the parameters for
+ *      its state, which is done once per process.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The located function, whose function pointer is nullptr if the vDSO
+ *      does not provide getrandom().
+ *
+ *  Comments:
+ *      The state size is rounded up to a whole number of pages.
+ */
+const VDSO &GetVDSO() noexcept
+{
+    static const VDSO vdso = []()
+    {
+        VDSO result;
+        auto function = reinterpret_cast<GetRandomFunction>(
+            FindVDSOSymbol(VDSO_Symbol));
+
+        // Passing an opaque length of ~0 requests the state parameters
+        if ((function == nullptr) ||
+            (function(nullptr, 0, 0, &result.params, ~std::size_t(0)) != 0))
+        {
+            return result;
+        }
+
+        const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        result.state_size = (result.params.size_of_opaque_state + page_size -
+                             1) / page_size * page_size;
+        result.function = function;
+
+        return result;
+    }();
+
+    return vdso;
+}
+
+} // namespace
+
+/*
+ *  HaveVDSOGetRandom()
+ *
+ *  Description:
+ *      Determine whether the vDSO provides getrandom().
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if the vDSO provides getrandom(), false if not.
+ *
+ *  Comments:
+ *      None.
+ */
+bool HaveVDSOGetRandom() noexcept
+{
+    return GetVDSO().function != nullptr;
+}
+
+/*
+ *  VDSOGetRandom()
+ *
+ *  Description:
+ *      Read random octets using the vDSO getrandom() function.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *      flags [in]
+ *          The getrandom() flags (e.g., GRND_NONBLOCK).
+ *
+ *  Returns:
+ *      The number of octets placed into the buffer, or the negated error
+ *      number on failure.
+ *
+ *  Comments:
+ *      The calling thread's state is allocated on first use.  If it cannot
+ *      be allocated, -ENOMEM is returned.
+ */
+std::ptrdiff_t VDSOGetRandom(std::span<std::uint8_t> buffer,
+                             unsigned flags) noexcept
+{
+    static thread_local ThreadState thread_state;
+    const VDSO &vdso = GetVDSO();
+
+    if (vdso.function == nullptr) return -ENOSYS;
+
+    if (thread_state.state == nullptr)
+    {
+        if (thread_state.failed) return -ENOMEM;
+
+        void *state = mmap(nullptr,
+                           vdso.state_size,
+                           static_cast<int>(vdso.params.mmap_prot),
+                           static_cast<int>(vdso.params.mmap_flags),
+                           -1,
+                           0);
+        if (state == MAP_FAILED)
+        {
+            thread_state.failed = true;
+            return -ENOMEM;
+        }
+
+        thread_state.state = state;
+        thread_state.size = vdso.state_size;
+    }
+
+    return vdso.function(buffer.data(),
+                         buffer.size(),
+                         flags,
+                         thread_state.state,
+                         vdso.params.size_of_opaque_state);
+}
+
+#else
+
+/*
+ *  HaveVDSOGetRandom()
+ *
+ *  Description:
+ *      Determine whether the vDSO provides getrandom().
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      False, as the vDSO is not supported on this platform.
+ *
+ *  Comments:
+ *      None.
+ */
+bool HaveVDSOGetRandom() noexcept
+{
+    return false;
+}
+
+/*
+ *  VDSOGetRandom()
+ *
+ *  Description:
+ *      Read random octets using the vDSO getrandom() function.
+ *
+ *  Parameters:
+ *      buffer [out]
+ *          A span of octets into which random octets will be placed.
+ *
+ *      flags [in]
+ *          The getrandom() flags.
+ *
+ *  Returns:
+ *      -ENOSYS, as the vDSO is not supported on this platform.
+ *
+ *  Comments:
+ *      None.
+ */
+std::ptrdiff_t VDSOGetRandom(std::span<std::uint8_t>, unsigned) noexcept
+{
+    return -ENOSYS;
+}
+
+#endif // TERRA_RANDOM_VDSO
+
+} // namespace Terra::Random
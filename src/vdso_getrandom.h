@@ -0,0 +1,40 @@
+/*
+ *  vdso_getrandom.h
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Internal header that defines functions to call the getrandom()
+ *      function exported by the Linux kernel's vDSO (Linux 6.11 and later),
+ *      which produces random octets in user space from a per-thread state
+ *      without a system call.
+ *
+ *      The vDSO function is located by name in the vDSO's ELF symbol table.
+ *      Each thread that calls it is given its own state, which is mapped
+ *      with the protection and flags given by the kernel (so that it is
+ *      wiped on fork()) and unmapped when the thread exits.
+ *
+ *  Portability Issues:
+ *      Only available on Linux on x86-64 and AArch64 processors.  Elsewhere,
+ *      HaveVDSOGetRandom() returns false.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace Terra::Random
+{
+
+bool HaveVDSOGetRandom() noexcept;
+std::ptrdiff_t VDSOGetRandom(std::span<std::uint8_t> buffer,
+                             unsigned flags) noexcept;
+
+} // namespace Terra::Random
@@ -0,0 +1,758 @@
+/*
+ *  xoshiro.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Implementation file for the xoshiro family of engines.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <vector>
+#include <terra/random/xoshiro.h>
+#include "f2_polynomial.h"
+#include "seed_sequence.h"
+#include "little_endian.h"
+
+namespace Terra::Random
+{
+
+namespace
+{
+
+// Jump polynomials published with the reference implementation
+constexpr std::array<std::uint64_t, 4> Xoshiro256_Jump =
+{
+    0x180e'c6d3'3cfd'0aba, 0xd5a6'1266'f0c9'392c,
+    0xa958'2618'e03f'c9aa, 0x39ab'dc45'29b1'661c
+};
+constexpr std::array<std::uint64_t, 4> Xoshiro256_Long_Jump =
+{
+    0x76e1'5d3e'fefd'cbbf, 0xc500'4e44'1c52'2fb3,
+    0x7771'0069'854e'e241, 0x3910'9bb0'2acb'e635
+};
+constexpr std::array<std::uint32_t, 4> Xoshiro128_Jump =
+{
+    0x8764'000b, 0xf542'd2d3, 0x6fa0'35c3, 0x77f2'db5b
+};
+constexpr std::array<std::uint32_t, 4> Xoshiro128_Long_Jump =
+{
+    0xb523'952e, 0x0b6f'099f, 0xccf5'a0ef, 0x1c58'0662
+};
+
+// Below this many steps, it is faster to step than to use a polynomial jump
+constexpr std::uint64_t Jump_Threshold = 4096;
+
+/*
+ *  SplitMix64()
+ *
+ *  Description:
+ *      Produce the next value from a SplitMix64 generator, which is used to
+ *      expand a single 64-bit seed into the full engine state as
+ *      recommended by the authors of xoshiro.
+ *
+ *  Parameters:
+ *      value [in/out]
+ *          The SplitMix64 state.
+ *
+ *  Returns:
+ *      The next SplitMix64 output.
+ *
+ *  Comments:
+ *      None.
+ */
+constexpr std::uint64_t SplitMix64(std::uint64_t &value) noexcept
+{
+    std::uint64_t z = (value += 0x9e37'79b9'7f4a'7c15);
+    z = (z ^ (z >> 30)) * 0xbf58'476d'1ce4'e5b9;
+    z = (z ^ (z >> 27)) * 0x94d0'49bb'1331'11eb;
+    return z ^ (z >> 31);
+}
+
+/*
+ *  Step256()
+ *
+ *  Description:
+ *      Advance the xoshiro256 state by one step.
+ *
+ *  Parameters:
+ *      state [in/out]
+ *          The state to advance.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The state transition is common to all xoshiro256 scramblers.
+ */
+void Step256(std::array<std::uint64_t, 4> &state) noexcept
+{
+    const std::uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = (state[3] << 45) | (state[3] >> 19);
+}
+
+/*
+ *  Add256()
+ *
+ *  Description:
+ *      Add (XOR) one xoshiro256 state into another.
+ *
+ *  Parameters:
+ *      result [in/out]
+ *          The state into which the other state is added.
+ *
+ *      other [in]
+ *          The state to add.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Add256(std::array<std::uint64_t, 4> &result,
+            const std::array<std::uint64_t, 4> &other) noexcept
+{
+    for (std::size_t i = 0; i < result.size(); i++) result[i] ^= other[i];
+}
+
+/*
+ *  GetModulus256()
+ *
+ *  Description:
+ *      Return the characteristic polynomial of the xoshiro256 state
+ *      transition, which is computed once when first needed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The characteristic polynomial of degree 256.
+ *
+ *  Comments:
+ *      The output of the ++ scrambler is not linear, so the polynomial is
+ *      found from a bit of the state rather than from the output.
+ */
+const F2Modulus &GetModulus256()
+{
+    static const F2Modulus modulus = []()
+    {
+        std::array<std::uint64_t, 4> state = {1, 2, 3, 4};
+        std::vector<bool> sequence(2 * 256);
+
+        for (std::size_t i = 0; i < sequence.size(); i++)
+        {
+            sequence[i] = (state[0] & 1) != 0;
+            Step256(state);
+        }
+
+        return F2Modulus(MinimalPolynomial(sequence));
+    }();
+
+    return modulus;
+}
+
+/*
+ *  Step128()
+ *
+ *  Description:
+ *      Advance the xoshiro128 state by one step.
+ *
+ *  Parameters:
+ *      state [in/out]
+ *          The state to advance.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The state transition is common to all xoshiro128 scramblers.
+ */
+void Step128(std::array<std::uint32_t, 4> &state) noexcept
+{
+    const std::uint32_t t = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = (state[3] << 11) | (state[3] >> 21);
+}
+
+/*
+ *  Add128()
+ *
+ *  Description:
+ *      Add (XOR) one xoshiro128 state into another.
+ *
+ *  Parameters:
+ *      result [in/out]
+ *          The state into which the other state is added.
+ *
+ *      other [in]
+ *          The state to add.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Add128(std::array<std::uint32_t, 4> &result,
+            const std::array<std::uint32_t, 4> &other) noexcept
+{
+    for (std::size_t i = 0; i < result.size(); i++) result[i] ^= other[i];
+}
+
+/*
+ *  GetModulus128()
+ *
+ *  Description:
+ *      Return the characteristic polynomial of the xoshiro128 state
+ *      transition, which is computed once when first needed.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The characteristic polynomial of degree 128.
+ *
+ *  Comments:
+ *      As with xoshiro256, the polynomial is found from a bit of the state.
+ */
+const F2Modulus &GetModulus128()
+{
+    static const F2Modulus modulus = []()
+    {
+        std::array<std::uint32_t, 4> state = {1, 2, 3, 4};
+        std::vector<bool> sequence(2 * 128);
+
+        for (std::size_t i = 0; i < sequence.size(); i++)
+        {
+            sequence[i] = (state[0] & 1) != 0;
+            Step128(state);
+        }
+
+        return F2Modulus(MinimalPolynomial(sequence));
+    }();
+
+    return modulus;
+}
+
+} // namespace
+
+/*
+ *  Xoshiro256PlusPlus::Xoshiro256PlusPlus()
+ *
+ *  Description:
+ *      Constructor for the Xoshiro256PlusPlus object.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value with which to seed the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+Xoshiro256PlusPlus::Xoshiro256PlusPlus(result_type seed) noexcept
+{
+    Seed(seed);
+}
+
+/*
+ *  Xoshiro256PlusPlus::Xoshiro256PlusPlus()
+ *
+ *  Description:
+ *      Constructor for the Xoshiro256PlusPlus object.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data used to initialize the full state of the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+Xoshiro256PlusPlus::Xoshiro256PlusPlus(std::span<const std::uint32_t> seed_data)
+{
+    Seed(seed_data);
+}
+
+/*
+ *  Xoshiro256PlusPlus::Seed()
+ *
+ *  Description:
+ *      Seed the engine using a single value.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value with which to seed the engine.  This is expanded to
+ *          fill the state using SplitMix64.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro256PlusPlus::Seed(result_type seed) noexcept
+{
+    for (auto &word : state) word = SplitMix64(seed);
+}
+
+/*
+ *  Xoshiro256PlusPlus::Seed()
+ *
+ *  Description:
+ *      Seed the full state of the engine from the given seed data.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data that is expanded as by std::seed_seq.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The all-zero state is a fixed point, so it is avoided.
+ */
+void Xoshiro256PlusPlus::Seed(std::span<const std::uint32_t> seed_data)
+{
+    std::array<std::uint32_t, 8> words;
+
+    GenerateSeedSequence(seed_data, words);
+
+    for (std::size_t i = 0; i < state.size(); i++)
+    {
+        state[i] = (static_cast<std::uint64_t>(words[2 * i]) << 32) |
+                   words[2 * i + 1];
+    }
+
+    if ((state[0] | state[1] | state[2] | state[3]) == 0) state[0] = 1;
+}
+
+/*
+ *  Xoshiro256PlusPlus::Discard()
+ *
+ *  Description:
+ *      Advance the engine as if the given number of values were produced.
+ *
+ *  Parameters:
+ *      count [in]
+ *          The number of values to discard.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Small counts are stepped; larger counts use a polynomial jump, whose
+ *      cost is logarithmic in the count.
+ */
+void Xoshiro256PlusPlus::Discard(std::uint64_t count)
+{
+    if (count < Jump_Threshold)
+    {
+        while (count-- > 0) Step256(state);
+        return;
+    }
+
+    F2Evaluate(GetModulus256().PowerOfX(count),
+               state,
+               std::array<std::uint64_t, 4>{},
+               Step256,
+               Add256);
+}
+
+/*
+ *  Xoshiro256PlusPlus::Jump()
+ *
+ *  Description:
+ *      Advance the engine by 2^128 steps.  This may be used to produce 2^128
+ *      non-overlapping sub-sequences for parallel computations.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro256PlusPlus::Jump() noexcept
+{
+    std::array<std::uint64_t, 4> result{};
+
+    for (auto word : Xoshiro256_Jump)
+    {
+        for (unsigned bit = 0; bit < 64; bit++)
+        {
+            if ((word >> bit) & 1) Add256(result, state);
+            Step256(state);
+        }
+    }
+
+    state = result;
+}
+
+/*
+ *  Xoshiro256PlusPlus::LongJump()
+ *
+ *  Description:
+ *      Advance the engine by 2^192 steps.  This may be used to produce 2^64
+ *      starting points, from each of which Jump() will produce 2^64
+ *      non-overlapping sub-sequences.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro256PlusPlus::LongJump() noexcept
+{
+    std::array<std::uint64_t, 4> result{};
+
+    for (auto word : Xoshiro256_Long_Jump)
+    {
+        for (unsigned bit = 0; bit < 64; bit++)
+        {
+            if ((word >> bit) & 1) Add256(result, state);
+            Step256(state);
+        }
+    }
+
+    state = result;
+}
+
+/*
+ *  Xoshiro256PlusPlus::SaveState()
+ *
+ *  Description:
+ *      Save the state of the engine.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The array into which the state is saved.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro256PlusPlus::SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept
+{
+    for (std::size_t i = 0; i < state.size(); i++)
+    {
+        StoreLittleEndian(octets.data() + 8 * i, state[i]);
+    }
+}
+
+/*
+ *  Xoshiro256PlusPlus::LoadState()
+ *
+ *  Description:
+ *      Load the state of the engine previously saved with SaveState().
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The array from which the state is loaded.
+ *
+ *  Returns:
+ *      True if the state was loaded, false if it is invalid, in which case
+ *      the engine is unchanged.
+ *
+ *  Comments:
+ *      The all-zero state is rejected.
+ */
+bool Xoshiro256PlusPlus::LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept
+{
+    std::array<std::uint64_t, 4> saved;
+
+    for (std::size_t i = 0; i < saved.size(); i++)
+    {
+        saved[i] = LoadLittleEndian<std::uint64_t>(octets.data() + 8 * i);
+    }
+
+    if ((saved[0] | saved[1] | saved[2] | saved[3]) == 0) return false;
+
+    state = saved;
+
+    return true;
+}
+
+/*
+ *  Xoshiro128PlusPlus::Xoshiro128PlusPlus()
+ *
+ *  Description:
+ *      Constructor for the Xoshiro128PlusPlus object.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value with which to seed the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+Xoshiro128PlusPlus::Xoshiro128PlusPlus(std::uint64_t seed) noexcept
+{
+    Seed(seed);
+}
+
+/*
+ *  Xoshiro128PlusPlus::Xoshiro128PlusPlus()
+ *
+ *  Description:
+ *      Constructor for the Xoshiro128PlusPlus object.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data used to initialize the full state of the engine.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+Xoshiro128PlusPlus::Xoshiro128PlusPlus(std::span<const std::uint32_t> seed_data)
+{
+    Seed(seed_data);
+}
+
+/*
+ *  Xoshiro128PlusPlus::Seed()
+ *
+ *  Description:
+ *      Seed the engine using a single value.
+ *
+ *  Parameters:
+ *      seed [in]
+ *          The value with which to seed the engine.  This is expanded to
+ *          fill the state using SplitMix64.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro128PlusPlus::Seed(std::uint64_t seed) noexcept
+{
+    for (std::size_t i = 0; i < state.size(); i += 2)
+    {
+        const std::uint64_t value = SplitMix64(seed);
+
+        state[i] = static_cast<std::uint32_t>(value);
+        state[i + 1] = static_cast<std::uint32_t>(value >> 32);
+    }
+}
+
+/*
+ *  Xoshiro128PlusPlus::Seed()
+ *
+ *  Description:
+ *      Seed the full state of the engine from the given seed data.
+ *
+ *  Parameters:
+ *      seed_data [in]
+ *          Seed data that is expanded as by std::seed_seq.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      The all-zero state is a fixed point, so it is avoided.
+ */
+void Xoshiro128PlusPlus::Seed(std::span<const std::uint32_t> seed_data)
+{
+    GenerateSeedSequence(seed_data, state);
+
+    if ((state[0] | state[1] | state[2] | state[3]) == 0) state[0] = 1;
+}
+
+/*
+ *  Xoshiro128PlusPlus::Discard()
+ *
+ *  Description:
+ *      Advance the engine as if the given number of values were produced.
+ *
+ *  Parameters:
+ *      count [in]
+ *          The number of values to discard.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Small counts are stepped; larger counts use a polynomial jump, whose
+ *      cost is logarithmic in the count.
+ */
+void Xoshiro128PlusPlus::Discard(std::uint64_t count)
+{
+    if (count < Jump_Threshold)
+    {
+        while (count-- > 0) Step128(state);
+        return;
+    }
+
+    F2Evaluate(GetModulus128().PowerOfX(count),
+               state,
+               std::array<std::uint32_t, 4>{},
+               Step128,
+               Add128);
+}
+
+/*
+ *  Xoshiro128PlusPlus::Jump()
+ *
+ *  Description:
+ *      Advance the engine by 2^64 steps.  This may be used to produce 2^64
+ *      non-overlapping sub-sequences for parallel computations.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro128PlusPlus::Jump() noexcept
+{
+    std::array<std::uint32_t, 4> result{};
+
+    for (auto word : Xoshiro128_Jump)
+    {
+        for (unsigned bit = 0; bit < 32; bit++)
+        {
+            if ((word >> bit) & 1) Add128(result, state);
+            Step128(state);
+        }
+    }
+
+    state = result;
+}
+
+/*
+ *  Xoshiro128PlusPlus::LongJump()
+ *
+ *  Description:
+ *      Advance the engine by 2^96 steps.  This may be used to produce 2^32
+ *      starting points, from each of which Jump() will produce 2^32
+ *      non-overlapping sub-sequences.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro128PlusPlus::LongJump() noexcept
+{
+    std::array<std::uint32_t, 4> result{};
+
+    for (auto word : Xoshiro128_Long_Jump)
+    {
+        for (unsigned bit = 0; bit < 32; bit++)
+        {
+            if ((word >> bit) & 1) Add128(result, state);
+            Step128(state);
+        }
+    }
+
+    state = result;
+}
+
+/*
+ *  Xoshiro128PlusPlus::SaveState()
+ *
+ *  Description:
+ *      Save the state of the engine.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The array into which the state is saved.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Xoshiro128PlusPlus::SaveState(
+            std::span<std::uint8_t, Saved_State_Size> octets) const noexcept
+{
+    for (std::size_t i = 0; i < state.size(); i++)
+    {
+        StoreLittleEndian(octets.data() + 4 * i, state[i]);
+    }
+}
+
+/*
+ *  Xoshiro128PlusPlus::LoadState()
+ *
+ *  Description:
+ *      Load the state of the engine previously saved with SaveState().
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The array from which the state is loaded.
+ *
+ *  Returns:
+ *      True if the state was loaded, false if it is invalid, in which case
+ *      the engine is unchanged.
+ *
+ *  Comments:
+ *      The all-zero state is rejected.
+ */
+bool Xoshiro128PlusPlus::LoadState(
+            std::span<const std::uint8_t, Saved_State_Size> octets) noexcept
+{
+    std::array<std::uint32_t, 4> saved;
+
+    for (std::size_t i = 0; i < saved.size(); i++)
+    {
+        saved[i] = LoadLittleEndian<std::uint32_t>(octets.data() + 4 * i);
+    }
+
+    if ((saved[0] | saved[1] | saved[2] | saved[3]) == 0) return false;
+
+    state = saved;
+
+    return true;
+}
+
+} // namespace Terra::Random
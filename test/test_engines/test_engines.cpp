@@ -0,0 +1,268 @@
+/*
+ *  test_engines.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the pseudo-random engines.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <random>
+#include <vector>
+#include <array>
+#include <terra/random/mt19937.h>
+#include <terra/random/xoshiro.h>
+#include <terra/random/pcg32.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+// Verify that MT19937 produces the same sequence as std::mt19937
+STF_TEST(MT19937, MatchesStandardLibrary)
+{
+    std::mt19937 expected(12345);
+    MT19937 engine(12345);
+
+    for (unsigned i = 0; i < 10'000; i++) STF_ASSERT_EQ(expected(), engine());
+}
+
+// Verify that MT19937 full-state seeding matches std::mt19937
+STF_TEST(MT19937, MatchesStandardLibrarySeedSequence)
+{
+    std::vector<std::uint32_t> seed_data = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::seed_seq sequence(seed_data.begin(), seed_data.end());
+    std::mt19937 expected(sequence);
+    MT19937 engine(seed_data);
+
+    for (unsigned i = 0; i < 10'000; i++) STF_ASSERT_EQ(expected(), engine());
+}
+
+// Verify that short and long discards agree with stepping
+STF_TEST(MT19937, Discard)
+{
+    for (std::uint64_t count : {std::uint64_t(0),
+                                std::uint64_t(1),
+                                std::uint64_t(623),
+                                std::uint64_t(1) << 22,
+                                (std::uint64_t(1) << 22) + 625})
+    {
+        std::mt19937 expected(42);
+        MT19937 engine(42);
+
+        // Start from a position that is not aligned to the state size
+        for (unsigned i = 0; i < 7; i++) STF_ASSERT_EQ(expected(), engine());
+
+        expected.discard(count);
+        engine.Discard(count);
+
+        for (unsigned i = 0; i < 1'000; i++)
+        {
+            STF_ASSERT_EQ(expected(), engine());
+        }
+    }
+}
+
+// Verify that jumps produce distinct sub-sequences
+STF_TEST(MT19937, Jump)
+{
+    MT19937 engine1(42);
+    MT19937 engine2(42);
+    MT19937 engine3(42);
+
+    engine2.Jump();
+    engine3.LongJump();
+
+    auto value1 = engine1();
+    auto value2 = engine2();
+    auto value3 = engine3();
+
+    STF_ASSERT_NE(value1, value2);
+    STF_ASSERT_NE(value1, value3);
+    STF_ASSERT_NE(value2, value3);
+}
+
+// Verify that the xoshiro256++ discard agrees with stepping
+STF_TEST(Xoshiro256PlusPlus, Discard)
+{
+    Xoshiro256PlusPlus expected(42);
+    Xoshiro256PlusPlus engine(42);
+
+    for (unsigned i = 0; i < 100'000; i++) expected();
+    engine.Discard(100'000);
+
+    for (unsigned i = 0; i < 1'000; i++) STF_ASSERT_EQ(expected(), engine());
+}
+
+// Verify that the jump functions agree with the jump polynomial
+STF_TEST(Xoshiro256PlusPlus, Jump)
+{
+    Xoshiro256PlusPlus engine1(42);
+    Xoshiro256PlusPlus engine2(42);
+
+    // Jumping then discarding must arrive at the same point as discarding
+    // then jumping
+    engine1.Jump();
+    engine1.Discard(1'000'000);
+    engine2.Discard(1'000'000);
+    engine2.Jump();
+
+    for (unsigned i = 0; i < 1'000; i++) STF_ASSERT_EQ(engine1(), engine2());
+
+    Xoshiro256PlusPlus engine3(42);
+    Xoshiro256PlusPlus engine4(42);
+    engine3.LongJump();
+    engine4.Jump();
+    STF_ASSERT_NE(engine3(), engine4());
+}
+
+// Verify the xoshiro256++ jumps against the reference implementation
+STF_TEST(Xoshiro256PlusPlus, JumpReferenceOutput)
+{
+    constexpr std::array<std::uint64_t, 3> Expected_Jump =
+    {
+        0xec87'9073'673d'f437, 0x20d2'12a3'9aca'1eaa, 0xc19d'712a'27e4'0f57
+    };
+    constexpr std::array<std::uint64_t, 3> Expected_Long_Jump =
+    {
+        0xb5c4'ea37'0b33'0bf5, 0x5173'cc69'3c0f'a533, 0x1dc5'df01'51f7'b491
+    };
+    constexpr std::array<std::uint8_t, 32> State =
+    {
+        1, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0,
+        3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0
+    };
+    Xoshiro256PlusPlus engine;
+
+    STF_ASSERT_TRUE(engine.LoadState(State));
+    engine.Jump();
+    for (auto value : Expected_Jump) STF_ASSERT_EQ(value, engine());
+
+    STF_ASSERT_TRUE(engine.LoadState(State));
+    engine.LongJump();
+    for (auto value : Expected_Long_Jump) STF_ASSERT_EQ(value, engine());
+}
+
+// Verify xoshiro128++ against the reference implementation's output
+STF_TEST(Xoshiro128PlusPlus, ReferenceOutput)
+{
+    constexpr std::array<std::uint32_t, 6> Expected =
+    {
+        0x0000'0281, 0x0018'0387, 0xc018'3387,
+        0xd1ae'3b02, 0x31e2'310a, 0xfd27'5ab0
+    };
+    constexpr std::array<std::uint8_t, 16> State =
+    {
+        1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0, 4, 0, 0, 0
+    };
+    Xoshiro128PlusPlus engine;
+
+    STF_ASSERT_TRUE(engine.LoadState(State));
+
+    for (auto value : Expected) STF_ASSERT_EQ(value, engine());
+
+    // The all-zero state is rejected
+    STF_ASSERT_FALSE(engine.LoadState(std::array<std::uint8_t, 16>{}));
+}
+
+// Verify that the xoshiro128++ discard agrees with stepping
+STF_TEST(Xoshiro128PlusPlus, Discard)
+{
+    Xoshiro128PlusPlus expected(42);
+    Xoshiro128PlusPlus engine(42);
+
+    for (unsigned i = 0; i < 100'000; i++) expected();
+    engine.Discard(100'000);
+
+    for (unsigned i = 0; i < 1'000; i++) STF_ASSERT_EQ(expected(), engine());
+}
+
+// Verify that the xoshiro128++ jumps agree with the jump polynomial
+STF_TEST(Xoshiro128PlusPlus, Jump)
+{
+    Xoshiro128PlusPlus engine1(42);
+    Xoshiro128PlusPlus engine2(42);
+
+    engine1.Jump();
+    engine1.Discard(1'000'000);
+    engine2.Discard(1'000'000);
+    engine2.Jump();
+
+    for (unsigned i = 0; i < 1'000; i++) STF_ASSERT_EQ(engine1(), engine2());
+
+    Xoshiro128PlusPlus engine3(42);
+    Xoshiro128PlusPlus engine4(42);
+    engine3.LongJump();
+    engine4.Jump();
+    STF_ASSERT_NE(engine3(), engine4());
+}
+
+// Verify the xoshiro128++ jumps against the reference implementation
+STF_TEST(Xoshiro128PlusPlus, JumpReferenceOutput)
+{
+    constexpr std::array<std::uint32_t, 3> Expected_Jump =
+    {
+        0xba8c'0ddc, 0x06a2'28ce, 0x4506'c342
+    };
+    constexpr std::array<std::uint32_t, 3> Expected_Long_Jump =
+    {
+        0x99cc'2935, 0x7f4f'19b6, 0x09b9'14e1
+    };
+    constexpr std::array<std::uint8_t, 16> State =
+    {
+        1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0, 4, 0, 0, 0
+    };
+    Xoshiro128PlusPlus engine;
+
+    STF_ASSERT_TRUE(engine.LoadState(State));
+    engine.Jump();
+    for (auto value : Expected_Jump) STF_ASSERT_EQ(value, engine());
+
+    STF_ASSERT_TRUE(engine.LoadState(State));
+    engine.LongJump();
+    for (auto value : Expected_Long_Jump) STF_ASSERT_EQ(value, engine());
+
+    // The jump is 2^64 steps, which may also be reached by discarding
+    STF_ASSERT_TRUE(engine.LoadState(State));
+    engine.Discard(std::uint64_t{1} << 63);
+    engine.Discard(std::uint64_t{1} << 63);
+    for (auto value : Expected_Jump) STF_ASSERT_EQ(value, engine());
+}
+
+// Verify PCG32 against the reference implementation's demonstration output
+STF_TEST(PCG32, ReferenceOutput)
+{
+    constexpr std::array<std::uint32_t, 6> Expected =
+    {
+        0xa15c'02b7, 0x7b47'f409, 0xba1d'3330,
+        0x83d2'f293, 0xbfa4'784b, 0xcbed'606e
+    };
+    PCG32 engine(42, 54);
+
+    for (auto value : Expected) STF_ASSERT_EQ(value, engine());
+}
+
+// Verify that the PCG32 discard agrees with stepping
+STF_TEST(PCG32, Discard)
+{
+    PCG32 expected(42, 54);
+    PCG32 engine(42, 54);
+
+    for (unsigned i = 0; i < 100'000; i++) expected();
+    engine.Discard(100'000);
+
+    for (unsigned i = 0; i < 1'000; i++) STF_ASSERT_EQ(expected(), engine());
+
+    // Discarding the full period returns to the same point
+    PCG32 engine1(42, 54);
+    PCG32 engine2(42, 54);
+    for (unsigned i = 0; i < 256; i++) engine2.LongJump();
+    STF_ASSERT_EQ(engine1(), engine2());
+}
@@ -0,0 +1,341 @@
+/*
+ *  test_generator_metrics.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Test the counters and latency histograms reported by the generators
+ *      and their rendering in the Prometheus text format.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <terra/random/random_generator.h>
+#include <terra/random/generator_metrics.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+// Verify that octets served and read from the sources are counted
+STF_TEST(GeneratorMetrics, OctetsCounted)
+{
+    std::array<std::uint8_t, 64> octets;
+    RandomGenerator rng;
+
+    auto before = GetGeneratorCounters();
+
+    rng.GetRandomOctets(octets);
+    rng.GetRandomOctet();
+
+    auto after = GetGeneratorCounters();
+
+    STF_ASSERT_EQ(65, after.octets_served - before.octets_served);
+    STF_ASSERT_EQ(65, after.source_octets - before.source_octets);
+}
+
+// Verify that a pseudo-random generator serves octets without the sources
+STF_TEST(GeneratorMetrics, PseudoRandomOnly)
+{
+    std::array<std::uint8_t, 64> octets;
+    RandomGenerator rng(true);
+
+    auto before = GetGeneratorCounters();
+
+    rng.GetRandomOctets(octets);
+
+    auto after = GetGeneratorCounters();
+
+    STF_ASSERT_EQ(64, after.octets_served - before.octets_served);
+    STF_ASSERT_EQ(0, after.source_octets - before.source_octets);
+    STF_ASSERT_EQ(0, after.system_calls - before.system_calls);
+}
+
+// Verify that reseeds are counted
+STF_TEST(GeneratorMetrics, Reseeds)
+{
+    RandomGenerator rng(true);
+
+    auto before = GetGeneratorCounters();
+
+    rng.Reseed();
+    rng.Reseed();
+
+    auto after = GetGeneratorCounters();
+
+    STF_ASSERT_EQ(2, after.reseeds - before.reseeds);
+}
+
+// Verify that the seed pool is kept when no generator exists
+STF_TEST(GeneratorMetrics, PoolRetained)
+{
+    {
+        RandomGenerator rng;
+    }
+
+    auto before = GetGeneratorCounters();
+
+    // Each generator takes 32 octets, so at most one refill is needed
+    for (std::size_t i = 0; i < 10; i++)
+    {
+        RandomGenerator rng;
+    }
+
+    auto after = GetGeneratorCounters();
+
+    STF_ASSERT_LE(after.pool_refills - before.pool_refills, 1);
+}
+
+// Verify that the counters of other threads, running or exited, are included
+STF_TEST(GeneratorMetrics, AggregateThreads)
+{
+    constexpr std::size_t Thread_Count = 4;
+    constexpr std::size_t Octets_Per_Thread = 1000;
+    std::vector<std::thread> threads;
+
+    auto before = GetGeneratorCounters();
+
+    for (std::size_t i = 0; i < Thread_Count; i++)
+    {
+        threads.emplace_back(
+            []()
+            {
+                RandomGenerator rng(true);
+                std::vector<std::uint8_t> octets(Octets_Per_Thread);
+
+                rng.GetRandomOctets(octets);
+            });
+    }
+
+    for (auto &thread : threads) thread.join();
+
+    auto after = GetGeneratorCounters();
+
+    STF_ASSERT_EQ(Thread_Count * Octets_Per_Thread,
+                  after.octets_served - before.octets_served);
+}
+
+// Verify that time is counted only while timing is enabled
+STF_TEST(GeneratorMetrics, Timing)
+{
+    std::array<std::uint8_t, 16> octets;
+    RandomGenerator rng;
+
+    auto before = GetGeneratorCounters();
+    rng.GetRandomOctets(octets);
+    auto after = GetGeneratorCounters();
+
+    STF_ASSERT_EQ(before.source_nanoseconds, after.source_nanoseconds);
+
+    SetGeneratorTiming(true);
+    for (std::size_t i = 0; i < 100; i++) rng.GetRandomOctets(octets);
+    SetGeneratorTiming(false);
+
+    auto timed = GetGeneratorCounters();
+
+    STF_ASSERT_GT(timed.source_nanoseconds, after.source_nanoseconds);
+}
+
+// Verify the latency histogram bucket boundaries
+STF_TEST(LatencyHistogram, Buckets)
+{
+    // Small latencies have their own buckets
+    STF_ASSERT_EQ(0, LatencyHistogram::GetBucket(0));
+    STF_ASSERT_EQ(0, LatencyHistogram::GetBucket(1));
+    STF_ASSERT_EQ(1, LatencyHistogram::GetBucket(2));
+    STF_ASSERT_EQ(31, LatencyHistogram::GetBucket(32));
+
+    // Powers of two are bucket limits
+    STF_ASSERT_EQ(1024, LatencyHistogram::GetBucketLimit(
+                            LatencyHistogram::GetBucket(1024)));
+    STF_ASSERT_EQ(LatencyHistogram::GetBucket(1024) + 1,
+                  LatencyHistogram::GetBucket(1025));
+    STF_ASSERT_EQ(LatencyHistogram::Bucket_Count - 1,
+                  LatencyHistogram::GetBucket(LatencyHistogram::Max_Latency));
+    STF_ASSERT_EQ(LatencyHistogram::Bucket_Count - 1,
+                  LatencyHistogram::GetBucket(~std::uint64_t{0}));
+
+    // Each value is within its bucket, whose width is at most 1/16 of the
+    // value (or 1 for small values)
+    for (std::uint64_t value = 0; value < 100'000'000; value += value / 7 + 1)
+    {
+        auto bucket = LatencyHistogram::GetBucket(value);
+        auto limit = LatencyHistogram::GetBucketLimit(bucket);
+
+        STF_ASSERT_LE(value, limit);
+        if (bucket > 0)
+        {
+            auto lower = LatencyHistogram::GetBucketLimit(bucket - 1);
+            STF_ASSERT_GT(value, lower);
+            STF_ASSERT_LE(limit - lower, std::max<std::uint64_t>(value / 16,
+                                                                 1));
+        }
+    }
+
+    // Each bucket begins just above the limit of the prior bucket
+    for (std::size_t bucket = 1; bucket < LatencyHistogram::Bucket_Count;
+         bucket++)
+    {
+        STF_ASSERT_EQ(bucket,
+                      LatencyHistogram::GetBucket(
+                          LatencyHistogram::GetBucketLimit(bucket - 1) + 1));
+    }
+}
+
+// Verify recording and merging latencies
+STF_TEST(LatencyHistogram, RecordMerge)
+{
+    LatencyHistogram first;
+    LatencyHistogram second;
+
+    first.Record(100);
+    first.Record(150);
+    second.Record(100);
+    second.Record(50'000);
+
+    first.Merge(second);
+
+    STF_ASSERT_EQ(4, first.GetCount());
+    STF_ASSERT_EQ(50'350, first.GetSum());
+    STF_ASSERT_EQ(50'000, first.GetMaximum());
+    STF_ASSERT_EQ(2, first.GetBucketCount(LatencyHistogram::GetBucket(100)));
+    STF_ASSERT_EQ(1, first.GetBucketCount(LatencyHistogram::GetBucket(150)));
+}
+
+// Verify percentiles are within a bucket of the true value
+STF_TEST(LatencyHistogram, Percentiles)
+{
+    LatencyHistogram histogram;
+
+    STF_ASSERT_EQ(0, histogram.GetPercentile(50.0));
+
+    // Latencies of 1 to 1000 us
+    for (std::uint64_t i = 1; i <= 1000; i++) histogram.Record(i * 1000);
+
+    auto near = [](std::uint64_t value, std::uint64_t expected)
+    {
+        return (value >= expected) && (value <= expected + expected / 16);
+    };
+
+    STF_ASSERT_TRUE(near(histogram.GetPercentile(50.0), 500'000));
+    STF_ASSERT_TRUE(near(histogram.GetPercentile(99.0), 990'000));
+    STF_ASSERT_TRUE(near(histogram.GetPercentile(99.9), 999'000));
+    STF_ASSERT_EQ(1'000'000, histogram.GetPercentile(100.0));
+    STF_ASSERT_EQ(1'000'000, histogram.GetMaximum());
+    STF_ASSERT_TRUE(near(histogram.GetPercentile(0.0), 1000));
+
+    // A single outlier determines the maximum but not the median
+    histogram.Record(50'000'000);
+    STF_ASSERT_EQ(50'000'000, histogram.GetMaximum());
+    STF_ASSERT_EQ(50'000'000, histogram.GetPercentile(100.0));
+    STF_ASSERT_TRUE(near(histogram.GetPercentile(50.0), 501'000));
+}
+
+// Verify that timed source reads are recorded in the histogram
+STF_TEST(GeneratorMetrics, SourceLatency)
+{
+    std::array<std::uint8_t, 16> octets;
+    RandomGenerator rng;
+
+    auto before = GetGeneratorMetrics();
+
+    SetGeneratorTiming(true);
+    for (std::size_t i = 0; i < 10; i++) rng.GetRandomOctets(octets);
+    SetGeneratorTiming(false);
+
+    auto after = GetGeneratorMetrics();
+
+    STF_ASSERT_EQ(10,
+                  after.source_latency.GetCount() -
+                      before.source_latency.GetCount());
+    STF_ASSERT_EQ(after.counters.source_nanoseconds,
+                  after.source_latency.GetSum());
+}
+
+// Verify that timed strict reads are recorded in the histogram
+STF_TEST(GeneratorMetrics, StrictSourceLatency)
+{
+    std::array<std::uint8_t, 16> octets;
+    RandomGenerator rng;
+
+    auto before = GetGeneratorMetrics();
+
+    SetGeneratorTiming(true);
+    for (std::size_t i = 0; i < 10; i++) rng.FillRandomOctets(octets);
+    SetGeneratorTiming(false);
+
+    auto after = GetGeneratorMetrics();
+
+    STF_ASSERT_EQ(10,
+                  after.source_latency.GetCount() -
+                      before.source_latency.GetCount());
+}
+
+// Verify the Prometheus text rendered for known metrics
+STF_TEST(GeneratorMetrics, Prometheus)
+{
+    GeneratorMetrics metrics{};
+    std::array<char, 8192> buffer;
+
+    metrics.counters.octets_served = 5;
+    metrics.counters.reseeds = 2;
+    metrics.source_latency.Record(100);
+    metrics.source_latency.Record(150);
+    metrics.refill_latency.Record(1'500'000'000);
+
+    std::size_t length = WritePrometheusMetrics(metrics, buffer);
+    STF_ASSERT_LE(length, buffer.size());
+
+    std::string_view text(buffer.data(), length);
+    auto contains = [&text](std::string_view line)
+    {
+        return text.find(line) != std::string_view::npos;
+    };
+
+    STF_ASSERT_TRUE(contains(
+        "# TYPE terra_random_octets_served_total counter\n"
+        "terra_random_octets_served_total 5\n"));
+    STF_ASSERT_TRUE(contains("terra_random_reseeds_total 2\n"));
+    STF_ASSERT_TRUE(contains("terra_random_system_calls_total 0\n"));
+    STF_ASSERT_TRUE(contains(
+        "# TYPE terra_random_source_read_seconds histogram\n"
+        "terra_random_source_read_seconds_bucket{le=\"0.000000032\"} 0\n"));
+    STF_ASSERT_TRUE(contains(
+        "terra_random_source_read_seconds_bucket{le=\"0.000000128\"} 1\n"
+        "terra_random_source_read_seconds_bucket{le=\"0.000000256\"} 2\n"));
+    STF_ASSERT_TRUE(contains(
+        "terra_random_source_read_seconds_bucket{le=\"0.067108864\"} 2\n"
+        "terra_random_source_read_seconds_bucket{le=\"+Inf\"} 2\n"
+        "terra_random_source_read_seconds_sum 0.00000025\n"
+        "terra_random_source_read_seconds_count 2\n"));
+    STF_ASSERT_TRUE(contains(
+        "terra_random_pool_refill_seconds_bucket{le=\"0.067108864\"} 0\n"
+        "terra_random_pool_refill_seconds_bucket{le=\"+Inf\"} 1\n"
+        "terra_random_pool_refill_seconds_sum 1.5\n"));
+    STF_ASSERT_EQ('\n', text.back());
+}
+
+// Verify that a short buffer receives a prefix and the full length
+STF_TEST(GeneratorMetrics, PrometheusTruncated)
+{
+    GeneratorMetrics metrics = GetGeneratorMetrics();
+    std::array<char, 8192> full;
+    std::array<char, 64> part;
+
+    std::size_t length = WritePrometheusMetrics(metrics, full);
+    STF_ASSERT_EQ(length, WritePrometheusMetrics(metrics, part));
+    STF_ASSERT_GT(length, part.size());
+    STF_ASSERT_EQ(std::string(full.data(), part.size()),
+                  std::string(part.data(), part.size()));
+}
@@ -0,0 +1,172 @@
+/*
+ *  test_health_test.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Test the SP 800-90B continuous health tests.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <cstring>
+#include <vector>
+#include <terra/random/health_test.h>
+#include <terra/random/xoshiro.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+namespace
+{
+
+// Produce octets in which each value occurs twice per APT window and no two
+// consecutive octets are equal
+std::vector<std::uint8_t> Pattern(std::size_t length)
+{
+    std::vector<std::uint8_t> octets(length);
+
+    for (std::size_t i = 0; i < length; i++)
+    {
+        octets[i] = static_cast<std::uint8_t>(i * 167);
+    }
+
+    return octets;
+}
+
+// Test the octets in pieces of the given size
+bool TestPieces(HealthTest &health_test,
+                std::span<const std::uint8_t> octets,
+                std::size_t piece)
+{
+    while (!octets.empty())
+    {
+        const std::size_t length = std::min(piece, octets.size());
+
+        if (!health_test.Test(octets.first(length))) return false;
+        octets = octets.subspan(length);
+    }
+
+    return true;
+}
+
+// Sizes in which octets are tested, covering every code path
+constexpr std::size_t Pieces[] = {1, 5, 7, 16, 33, 100, 512, 513, 4096};
+
+} // namespace
+
+// Verify that octets without runs or excess repetition pass
+STF_TEST(HealthTest, Passes)
+{
+    auto octets = Pattern(65536);
+
+    for (auto piece : Pieces)
+    {
+        HealthTest health_test;
+
+        STF_ASSERT_TRUE(TestPieces(health_test, octets, piece));
+    }
+}
+
+// Verify that random octets pass
+STF_TEST(HealthTest, RandomOctets)
+{
+    std::vector<std::uint8_t> octets(1 << 20);
+    Xoshiro256PlusPlus engine(1);
+
+    for (std::size_t i = 0; i < octets.size(); i += 8)
+    {
+        const std::uint64_t value = engine();
+        std::memcpy(octets.data() + i, &value, sizeof(value));
+    }
+
+    for (auto piece : Pieces)
+    {
+        HealthTest health_test;
+
+        STF_ASSERT_TRUE(TestPieces(health_test, octets, piece));
+    }
+}
+
+// Verify that a run of RCT_Cutoff octets fails wherever it occurs, but that
+// a shorter run passes
+STF_TEST(HealthTest, RepetitionCount)
+{
+    for (std::size_t position = 0; position < 4096 - 8; position += 37)
+    {
+        for (auto piece : Pieces)
+        {
+            auto octets = Pattern(4096);
+            HealthTest health_test;
+
+            std::memset(octets.data() + position,
+                        0x5a,
+                        HealthTest::RCT_Cutoff - 1);
+            STF_ASSERT_TRUE(TestPieces(health_test, octets, piece));
+
+            octets[position + HealthTest::RCT_Cutoff - 1] = 0x5a;
+            octets[position + HealthTest::RCT_Cutoff] = 0xa5;
+            health_test.Reset();
+            STF_ASSERT_FALSE(TestPieces(health_test, octets, piece));
+        }
+    }
+}
+
+// Verify that a run continuing from one call to the next fails
+STF_TEST(HealthTest, RepetitionAcrossCalls)
+{
+    auto octets = Pattern(1024);
+    HealthTest health_test;
+
+    std::memset(octets.data() + 509, 0x5a, HealthTest::RCT_Cutoff);
+
+    STF_ASSERT_TRUE(health_test.Test(std::span(octets).first(512)));
+    STF_ASSERT_FALSE(health_test.Test(std::span(octets).subspan(512)));
+}
+
+// Verify that an octet occurring APT_Cutoff times in a window fails, but
+// that fewer occurrences pass
+STF_TEST(HealthTest, AdaptiveProportion)
+{
+    for (std::size_t window = 0; window < 4096; window += 1024)
+    {
+        for (auto piece : Pieces)
+        {
+            auto octets = Pattern(4096);
+            const std::uint8_t value = octets[window];
+            HealthTest health_test;
+
+            // The value occurs twice in the pattern, so make it occur
+            // APT_Cutoff - 1 times in all
+            for (unsigned i = 0; i < HealthTest::APT_Cutoff - 3; i++)
+            {
+                octets[window + 10 + i * 20] = value;
+            }
+            STF_ASSERT_TRUE(TestPieces(health_test, octets, piece));
+
+            octets[window + 511] = value;
+            health_test.Reset();
+            STF_ASSERT_FALSE(TestPieces(health_test, octets, piece));
+        }
+    }
+}
+
+// Verify that the tests start over after Reset()
+STF_TEST(HealthTest, Reset)
+{
+    std::vector<std::uint8_t> run(HealthTest::RCT_Cutoff, 0x00);
+    auto octets = Pattern(4096);
+    HealthTest health_test;
+
+    STF_ASSERT_FALSE(health_test.Test(run));
+
+    health_test.Reset();
+
+    STF_ASSERT_TRUE(health_test.Test(octets));
+}
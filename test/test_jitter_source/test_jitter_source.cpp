@@ -0,0 +1,103 @@
+/*
+ *  test_jitter_source.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the JitterSource object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <array>
+#include <algorithm>
+#include <terra/random/jitter_source.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+class JitterSource_ : public JitterSource
+{
+    public:
+        explicit JitterSource_(Timer timer) : JitterSource(timer) {}
+};
+
+namespace
+{
+
+std::uint64_t stuck_timer_ticks = 0;
+std::uint64_t stuck_timer_time = 0;
+
+// Timer that advances steadily for the first 100 reads, then irregularly
+std::uint64_t StuckTimer() noexcept
+{
+    const std::uint64_t tick = stuck_timer_ticks++;
+
+    if (tick < 100)
+    {
+        stuck_timer_time += 10;
+    }
+    else
+    {
+        stuck_timer_time += 1 + ((tick * 0x9e37'79b9) >> 8) % 1000;
+    }
+
+    return stuck_timer_time;
+}
+
+} // namespace
+
+// Verify that the jitter source produces distinct output
+STF_TEST(JitterSource, DistinctOutput)
+{
+    JitterSource source;
+
+    // The startup health test must pass on the test machines
+    STF_ASSERT_TRUE(source.IsHealthy());
+
+    // Use a size that is not a multiple of the 8-octet output
+    std::array<std::uint8_t, 37> octets1{};
+    std::array<std::uint8_t, 37> octets2{};
+
+    STF_ASSERT_EQ(octets1.size(), source.Read(octets1));
+    STF_ASSERT_EQ(octets2.size(), source.Read(octets2));
+    STF_ASSERT_NE(octets1, octets2);
+    STF_ASSERT_TRUE(std::any_of(octets1.begin(),
+                                octets1.end(),
+                                [](std::uint8_t octet) { return octet != 0; }));
+    STF_ASSERT_TRUE(source.IsHealthy());
+}
+
+// Verify that independent sources produce distinct output
+STF_TEST(JitterSource, DistinctSources)
+{
+    JitterSource source1;
+    JitterSource source2;
+    std::array<std::uint8_t, 16> octets1{};
+    std::array<std::uint8_t, 16> octets2{};
+
+    STF_ASSERT_EQ(octets1.size(), source1.Read(octets1));
+    STF_ASSERT_EQ(octets2.size(), source2.Read(octets2));
+    STF_ASSERT_NE(octets1, octets2);
+}
+
+// Verify that a timer stuck during startup fails the repetition count test
+STF_TEST(JitterSource, StuckTimer)
+{
+    stuck_timer_ticks = 0;
+    stuck_timer_time = 0;
+
+    // Most startup samples vary, but the first are stuck for longer than
+    // the repetition count test permits
+    JitterSource_ source(StuckTimer);
+    std::array<std::uint8_t, 8> octets{};
+
+    STF_ASSERT_FALSE(source.IsHealthy());
+    STF_ASSERT_EQ(0, source.Read(octets));
+}
@@ -15,9 +15,22 @@
  *      None.
  */
 
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <system_error>
+#include <vector>
+#include <string>
+#include <algorithm>
 #include <terra/random/random_generator.h>
+#include <terra/random/generator_metrics.h>
 #include <terra/stf/stf.h>
+#include "os_source.h"
 
 using namespace Terra::Random;
 
@@ -28,6 +41,83 @@ class RandomGenerator_ : public RandomGenerator
         using RandomGenerator::SourceRandomOctets;
 };
 
+namespace
+{
+
+// Consecutive failing reads after which a source is disabled
+constexpr unsigned Disable_Failures = 3;
+
+// The source whose reads the hook alters, or None for all sources
+std::atomic<RandomSource> hook_source{RandomSource::None};
+
+// Set to make reads fail the health tests (by producing only zeros)
+std::atomic<bool> hook_zero{false};
+
+// Set to make reads fail with this error number
+std::atomic<int> hook_error{0};
+
+// Set to make reads produce at most one octet
+std::atomic<bool> hook_short{false};
+
+// Alter the result of reads from the random sources as configured above
+std::ptrdiff_t TestReadHook(RandomSource source,
+                            std::span<std::uint8_t> buffer,
+                            std::ptrdiff_t result) noexcept
+{
+    const RandomSource target = hook_source.load();
+
+    if ((target != RandomSource::None) && (target != source)) return result;
+    if (hook_error.load() != 0) return -hook_error.load();
+    if (result <= 0) return result;
+    if (hook_zero.load())
+    {
+        std::fill(buffer.begin(), buffer.end(), 0);
+    }
+    if (hook_short.load()) return 1;
+
+    return result;
+}
+
+// Install the read hook and health test response for the life of a test
+class ReadHookScope
+{
+    public:
+        ReadHookScope(RandomSource source,
+                      HealthTestResponse response =
+                          HealthTestResponse::SwitchSource)
+        {
+            hook_source = source;
+            hook_zero = false;
+            hook_error = 0;
+            hook_short = false;
+            SetHealthTestResponse(response);
+            ResetSourceHealth();
+            SetSourceReadHook(TestReadHook);
+        }
+
+        ~ReadHookScope()
+        {
+            SetSourceReadHook(nullptr);
+            SetHealthTestResponse(HealthTestResponse::SwitchSource);
+            ResetSourceHealth();
+        }
+};
+
+// Return the non-jitter sources in the chain
+std::vector<RandomSource> ReadableSources()
+{
+    std::vector<RandomSource> sources;
+
+    for (auto source : GetRandomSources())
+    {
+        if (source != RandomSource::Jitter) sources.push_back(source);
+    }
+
+    return sources;
+}
+
+} // namespace
+
 // Verify the OS RNG produces output
 STF_TEST(RandomOSSources, VerifyContent)
 {
@@ -37,3 +127,370 @@ STF_TEST(RandomOSSources, VerifyContent)
     // Ensure we retrieve the expected number of octets
     STF_ASSERT_EQ(octets.size(), rng.SourceRandomOctets(octets));
 }
+
+// Verify that generators constructed together are seeded differently
+STF_TEST(RandomOSSources, DistinctSeeds)
+{
+    std::set<std::array<std::uint8_t, 16>> outputs;
+
+    for (std::size_t i = 0; i < 1'000; i++)
+    {
+        RandomGenerator rng(true);
+        std::array<std::uint8_t, 16> octets;
+
+        rng.GetRandomOctets(octets);
+        outputs.insert(octets);
+    }
+
+    STF_ASSERT_EQ(1'000U, outputs.size());
+}
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+// Verify that parent and child processes do not share seeds after fork()
+STF_TEST(RandomOSSources, ForkedSeeds)
+{
+    // Ensure the seed pool is filled before forking
+    RandomGenerator parent_rng(true);
+    std::array<std::uint8_t, 16> child_octets{};
+    int pipe_fds[2];
+
+    STF_ASSERT_EQ(0, pipe(pipe_fds));
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        RandomGenerator rng(true);
+        auto octets = rng.GetRandomOctets(child_octets.size());
+        auto result = write(pipe_fds[1], octets.data(), octets.size());
+        _exit(result == static_cast<ssize_t>(octets.size()) ? 0 : 1);
+    }
+    STF_ASSERT_GT(pid, 0);
+
+    close(pipe_fds[1]);
+    auto result = read(pipe_fds[0], child_octets.data(), child_octets.size());
+    close(pipe_fds[0]);
+    waitpid(pid, nullptr, 0);
+    STF_ASSERT_EQ(static_cast<ssize_t>(child_octets.size()), result);
+
+    RandomGenerator rng(true);
+    auto octets = rng.GetRandomOctets(child_octets.size());
+    STF_ASSERT_FALSE(std::equal(octets.begin(),
+                                octets.end(),
+                                child_octets.begin()));
+}
+#endif
+
+// Verify that reseeding produces sequences unrelated to the prior sequence
+STF_TEST(RandomOSSources, Reseed)
+{
+    const std::vector<std::uint32_t> seed_data = {1, 2, 3};
+    BasicRandomGenerator<Xoshiro256PlusPlus> generator1(seed_data);
+    BasicRandomGenerator<Xoshiro256PlusPlus> generator2(seed_data);
+    BasicRandomGenerator<Xoshiro256PlusPlus> reference(seed_data);
+
+    generator1.Reseed();
+    generator2.Reseed();
+
+    auto octets1 = generator1.GetRandomOctets(32);
+    auto octets2 = generator2.GetRandomOctets(32);
+    auto expected = reference.GetRandomOctets(32);
+
+    STF_ASSERT_NE(octets1, octets2);
+    STF_ASSERT_NE(octets1, expected);
+    STF_ASSERT_NE(octets2, expected);
+}
+
+// Verify that requests are served by the first probed source
+STF_TEST(RandomOSSources, SourceChain)
+{
+    auto sources = GetRandomSources();
+
+    STF_ASSERT_FALSE(sources.empty());
+    for (auto source : sources)
+    {
+        STF_ASSERT_NE(RandomSource::None, source);
+        STF_ASSERT_NE(std::string("unknown"), GetRandomSourceName(source));
+    }
+
+    RandomGenerator generator;
+    RandomGenerator pseudo_generator(true);
+
+    STF_ASSERT_EQ(RandomSource::None, generator.GetLastSource());
+    generator.GetRandomOctets(16);
+    STF_ASSERT_EQ(sources.front(), generator.GetLastSource());
+
+    pseudo_generator.GetRandomOctets(16);
+    STF_ASSERT_EQ(RandomSource::None, pseudo_generator.GetLastSource());
+}
+
+// Verify that each source in the chain can be read directly
+STF_TEST(RandomOSSources, ReadRandomSource)
+{
+    std::error_code error;
+
+    for (auto source : GetRandomSources())
+    {
+        std::array<std::uint8_t, 64> octets{};
+
+        if (source == RandomSource::Jitter) continue;
+
+        STF_ASSERT_EQ(octets.size(), ReadRandomSource(source, octets, error));
+        STF_ASSERT_FALSE(error);
+        STF_ASSERT_TRUE(
+            std::any_of(octets.begin(),
+                        octets.end(),
+                        [](std::uint8_t octet) { return octet != 0; }));
+    }
+
+    std::array<std::uint8_t, 16> octets{};
+
+    STF_ASSERT_EQ(0U, ReadRandomSource(RandomSource::None, octets, error));
+    STF_ASSERT_EQ(std::make_error_code(std::errc::not_supported), error);
+}
+
+// Verify that a strict fill reads every octet from the random sources
+STF_TEST(RandomOSSources, FillRandomOctets)
+{
+    RandomGenerator generator;
+    std::array<std::uint8_t, 4096> octets{};
+    std::error_code error = std::make_error_code(std::errc::io_error);
+
+    generator.FillRandomOctets(octets, error);
+    STF_ASSERT_FALSE(error);
+    STF_ASSERT_EQ(GetRandomSources().front(), generator.GetLastSource());
+    STF_ASSERT_TRUE(std::any_of(octets.begin(),
+                                octets.end(),
+                                [](std::uint8_t octet) { return octet != 0; }));
+
+    // A full first read needs no time budget
+    generator.FillRandomOctets(octets, std::chrono::microseconds(0));
+
+    // With only the PRNG, the result is that of GetRandomOctets()
+    const std::vector<std::uint32_t> seed_data = {4, 5, 6};
+    RandomGenerator pseudo_generator(seed_data);
+    RandomGenerator reference(seed_data);
+    std::vector<std::uint8_t> pseudo_octets(100);
+
+    pseudo_generator.FillRandomOctets(pseudo_octets, error);
+    STF_ASSERT_FALSE(error);
+    STF_ASSERT_EQ(reference.GetRandomOctets(100), pseudo_octets);
+}
+
+// Verify that with the Error response a failing read is reported
+STF_TEST(RandomOSSources, HealthResponseError)
+{
+    ReadHookScope scope(RandomSource::None, HealthTestResponse::Error);
+    RandomGenerator generator;
+    std::array<std::uint8_t, 64> octets;
+    std::error_code error;
+
+    hook_zero = true;
+    octets.fill(0xff);
+
+    generator.FillRandomOctets(octets, error);
+    STF_ASSERT_EQ(std::make_error_code(std::errc::bad_message), error);
+    STF_ASSERT_TRUE(std::all_of(octets.begin(),
+                                octets.end(),
+                                [](std::uint8_t octet) { return octet == 0; }));
+}
+
+// Verify that with the SwitchSource response a failing source is skipped
+// and disabled after consecutive failures
+STF_TEST(RandomOSSources, HealthResponseSwitchSource)
+{
+    const auto sources = ReadableSources();
+
+    // A second source is needed to switch to
+    if (sources.size() < 2) return;
+
+    ReadHookScope scope(sources[0]);
+    RandomGenerator_ generator;
+    std::array<std::uint8_t, 64> octets;
+    auto before = GetGeneratorCounters();
+
+    hook_zero = true;
+
+    for (unsigned i = 0; i < Disable_Failures; i++)
+    {
+        STF_ASSERT_EQ(octets.size(), generator.SourceRandomOctets(octets));
+        STF_ASSERT_EQ(sources[1], generator.GetLastSource());
+    }
+
+    auto after = GetGeneratorCounters();
+    STF_ASSERT_EQ(Disable_Failures,
+                  after.health_failures - before.health_failures);
+    STF_ASSERT_EQ(1, after.sources_disabled - before.sources_disabled);
+
+    // The source remains disabled even once it produces good octets
+    hook_zero = false;
+    STF_ASSERT_EQ(octets.size(), generator.SourceRandomOctets(octets));
+    STF_ASSERT_EQ(sources[1], generator.GetLastSource());
+
+    // It is used again once enabled
+    ResetSourceHealth();
+    STF_ASSERT_EQ(octets.size(), generator.SourceRandomOctets(octets));
+    STF_ASSERT_EQ(sources[0], generator.GetLastSource());
+}
+
+// Verify that a passing read resets the count of consecutive failures
+STF_TEST(RandomOSSources, HealthPassResetsFailures)
+{
+    const auto sources = ReadableSources();
+
+    if (sources.size() < 2) return;
+
+    ReadHookScope scope(sources[0]);
+    RandomGenerator_ generator;
+    std::array<std::uint8_t, 64> octets;
+    auto before = GetGeneratorCounters();
+
+    for (unsigned round = 0; round < 2; round++)
+    {
+        hook_zero = true;
+        for (unsigned i = 0; i + 1 < Disable_Failures; i++)
+        {
+            generator.SourceRandomOctets(octets);
+            STF_ASSERT_EQ(sources[1], generator.GetLastSource());
+        }
+
+        hook_zero = false;
+        generator.SourceRandomOctets(octets);
+        STF_ASSERT_EQ(sources[0], generator.GetLastSource());
+    }
+
+    auto after = GetGeneratorCounters();
+    STF_ASSERT_EQ(2 * (Disable_Failures - 1),
+                  after.health_failures - before.health_failures);
+    STF_ASSERT_EQ(0, after.sources_disabled - before.sources_disabled);
+}
+
+// Verify that with the Reseed response a failing read reseeds the PRNG
+STF_TEST(RandomOSSources, HealthResponseReseed)
+{
+    ReadHookScope scope(RandomSource::None, HealthTestResponse::Reseed);
+    RandomGenerator generator;
+    std::array<std::uint8_t, 64> octets;
+    auto before = GetGeneratorCounters();
+
+    hook_zero = true;
+    generator.GetRandomOctets(octets);
+
+    auto after = GetGeneratorCounters();
+    STF_ASSERT_EQ(1, after.reseeds - before.reseeds);
+    STF_ASSERT_EQ(0, after.sources_disabled - before.sources_disabled);
+    STF_ASSERT_TRUE(std::any_of(octets.begin(),
+                                octets.end(),
+                                [](std::uint8_t octet) { return octet != 0; }));
+}
+
+// Verify that a strict fill retries short reads until the span is filled
+STF_TEST(RandomOSSources, FillRandomOctetsShortReads)
+{
+    ReadHookScope scope(RandomSource::None);
+    RandomGenerator generator;
+    std::array<std::uint8_t, 64> octets;
+    std::error_code error;
+
+    hook_short = true;
+
+    generator.FillRandomOctets(octets, error);
+    STF_ASSERT_FALSE(error);
+    STF_ASSERT_EQ(GetRandomSources().front(), generator.GetLastSource());
+}
+
+// Verify that a strict fill moves to the next source when a source fails
+STF_TEST(RandomOSSources, FillRandomOctetsEscalates)
+{
+    const auto sources = ReadableSources();
+
+    if (sources.size() < 2) return;
+
+    ReadHookScope scope(sources[0]);
+    RandomGenerator generator;
+    std::array<std::uint8_t, 64> octets;
+    std::error_code error;
+    auto before = GetGeneratorCounters();
+
+    hook_error = EIO;
+
+    generator.FillRandomOctets(octets, error);
+    STF_ASSERT_FALSE(error);
+    STF_ASSERT_EQ(sources[1], generator.GetLastSource());
+
+    auto after = GetGeneratorCounters();
+    STF_ASSERT_EQ(1, after.fallbacks - before.fallbacks);
+}
+
+// Verify that a strict fill reports failure when every source fails
+STF_TEST(RandomOSSources, FillRandomOctetsFailure)
+{
+    ReadHookScope scope(RandomSource::None);
+    RandomGenerator generator;
+    std::array<std::uint8_t, 64> octets;
+    std::error_code error;
+
+    hook_error = EIO;
+    octets.fill(0xff);
+
+    generator.FillRandomOctets(octets, error);
+    STF_ASSERT_EQ(std::make_error_code(std::errc::io_error), error);
+    STF_ASSERT_TRUE(std::all_of(octets.begin(),
+                                octets.end(),
+                                [](std::uint8_t octet) { return octet == 0; }));
+
+    STF_ASSERT_EXCEPTION_E(generator.FillRandomOctets(octets),
+                           std::system_error);
+}
+
+// Verify that a strict fill gives up once the retry budget is spent
+STF_TEST(RandomOSSources, FillRandomOctetsBudget)
+{
+    constexpr std::chrono::milliseconds Budget{20};
+    ReadHookScope scope(RandomSource::None);
+    RandomGenerator generator;
+    std::array<std::uint8_t, 64> octets;
+    std::error_code error;
+
+    hook_error = EAGAIN;
+
+    auto start = std::chrono::steady_clock::now();
+    generator.FillRandomOctets(octets, error, Budget);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    STF_ASSERT_EQ(std::make_error_code(std::errc::timed_out), error);
+    STF_ASSERT_TRUE(elapsed >= Budget);
+    STF_ASSERT_TRUE(elapsed < Budget + std::chrono::seconds(1));
+
+    // The throwing form reports the same error
+    bool thrown = false;
+    try
+    {
+        generator.FillRandomOctets(octets, Budget);
+    }
+    catch (const std::system_error &e)
+    {
+        thrown = (e.code() == std::make_error_code(std::errc::timed_out));
+    }
+    STF_ASSERT_TRUE(thrown);
+}
+
+// Verify that distinct seeds are produced when no source produces octets
+STF_TEST(RandomOSSources, SeedsWithoutSources)
+{
+    ReadHookScope scope(RandomSource::None);
+    std::set<std::array<std::uint8_t, 16>> outputs;
+
+    hook_error = EIO;
+
+    // Use more seeds than the pool holds, so the pool is refilled
+    for (std::size_t i = 0; i < 200; i++)
+    {
+        RandomGenerator rng(true);
+        std::array<std::uint8_t, 16> octets;
+
+        rng.GetRandomOctets(octets);
+        outputs.insert(octets);
+    }
+
+    STF_ASSERT_EQ(200U, outputs.size());
+}
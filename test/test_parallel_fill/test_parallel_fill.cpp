@@ -0,0 +1,92 @@
+/*
+ *  test_parallel_fill.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the ParallelFill() function.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <vector>
+#include <terra/random/parallel_fill.h>
+#include <terra/random/philox.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+// Verify that the result does not depend on the number of threads
+STF_TEST(ParallelFill, ThreadIndependence)
+{
+    constexpr std::uint64_t Seed = 0x0123'4567'89ab'cdef;
+
+    // Use a size that is not a multiple of the chunk or block size
+    std::vector<std::uint8_t> expected(3 * 1024 * 1024 + 1'001);
+    Philox4x32::FillRange({0x89ab'cdef, 0x0123'4567}, 0, expected);
+
+    for (unsigned threads : {1, 2, 3, 7, 16})
+    {
+        std::vector<std::uint8_t> octets(expected.size());
+        ParallelFill(octets, threads, Seed);
+        STF_ASSERT_EQ(expected, octets);
+    }
+}
+
+// Verify that the result matches the sequential Philox4x32 engine
+STF_TEST(ParallelFill, MatchesEngine)
+{
+    constexpr std::uint64_t Seed = 42;
+    Philox4x32 engine(Seed);
+    std::vector<std::uint8_t> octets(1024 * 1024);
+
+    ParallelFill(octets, 4, Seed);
+
+    for (std::size_t i = 0; i < octets.size(); i += 4)
+    {
+        auto value = engine();
+        STF_ASSERT_EQ(static_cast<std::uint8_t>(value), octets[i]);
+        STF_ASSERT_EQ(static_cast<std::uint8_t>(value >> 24), octets[i + 3]);
+    }
+}
+
+// Verify that small and empty buffers are handled
+STF_TEST(ParallelFill, SmallBuffers)
+{
+    std::vector<std::uint8_t> empty;
+    std::vector<std::uint8_t> small(5);
+    std::vector<std::uint8_t> expected(5);
+
+    ParallelFill(empty, 4, 1);
+    ParallelFill(small, 4, 1);
+    Philox4x32::FillRange({1, 0}, 0, expected);
+
+    STF_ASSERT_EQ(expected, small);
+}
+
+// Verify that a sequence may be produced in segments
+STF_TEST(ParallelFill, Segments)
+{
+    constexpr std::uint64_t Seed = 7;
+    constexpr std::size_t Segment_Size = 512 * 1024 + 16 * 3;
+    std::vector<std::uint8_t> expected(3 * Segment_Size);
+    std::vector<std::uint8_t> octets(expected.size());
+
+    ParallelFill(expected, 3, Seed);
+
+    for (std::size_t offset = 0; offset < octets.size(); offset += Segment_Size)
+    {
+        ParallelFill(std::span(octets).subspan(offset, Segment_Size),
+                     3,
+                     Seed,
+                     offset / Philox4x32::Block_Size);
+    }
+
+    STF_ASSERT_EQ(expected, octets);
+}
@@ -0,0 +1,128 @@
+/*
+ *  test_philox.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the Philox4x32 counter-based engine.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <vector>
+#include <cstring>
+#include <terra/random/philox.h>
+#include <terra/random/random_generator.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+// Verify the known-answer tests published with the reference implementation
+STF_TEST(Philox4x32, KnownAnswer)
+{
+    STF_ASSERT_EQ(
+        (Philox4x32::Block{0x6627'e8d5, 0xe169'c58d, 0xbc57'ac4c, 0x9b00'dbd8}),
+        Philox4x32::At({0, 0}, {0, 0, 0, 0}));
+
+    STF_ASSERT_EQ(
+        (Philox4x32::Block{0x408f'276d, 0x41c8'3b0e, 0xa20b'c7c6, 0x6d54'51fd}),
+        Philox4x32::At({0xffff'ffff, 0xffff'ffff},
+                       {0xffff'ffff, 0xffff'ffff, 0xffff'ffff, 0xffff'ffff}));
+
+    STF_ASSERT_EQ(
+        (Philox4x32::Block{0xd16c'fe09, 0x94fd'cceb, 0x5001'e420, 0x2412'6ea1}),
+        Philox4x32::At({0xa409'3822, 0x299f'31d0},
+                       {0x243f'6a88, 0x85a3'08d3, 0x1319'8a2e, 0x0370'7344}));
+}
+
+// Verify that FillRange() agrees with At() for all lengths and offsets
+STF_TEST(Philox4x32, FillRange)
+{
+    const Philox4x32::Key key = {0x1234'5678, 0x9abc'def0};
+    const std::uint64_t first_counter = 0xffff'fff0;
+
+    // Produce the expected sequence one block at a time, crossing the 2^32
+    // boundary of the low counter word
+    std::vector<std::uint8_t> expected(1'024);
+    for (std::size_t i = 0; i < expected.size() / 16; i++)
+    {
+        std::uint64_t value = first_counter + i;
+        auto block = Philox4x32::At(key,
+                                    {static_cast<std::uint32_t>(value),
+                                     static_cast<std::uint32_t>(value >> 32),
+                                     0,
+                                     0});
+        for (std::size_t j = 0; j < 16; j++)
+        {
+            expected[i * 16 + j] =
+                static_cast<std::uint8_t>(block[j / 4] >> (8 * (j % 4)));
+        }
+    }
+
+    // Every sub-range must match regardless of where it starts or ends
+    for (std::size_t start_block = 0; start_block < 9; start_block++)
+    {
+        for (std::size_t length = 0; length < 300; length += 7)
+        {
+            std::vector<std::uint8_t> octets(length);
+            Philox4x32::FillRange(key, first_counter + start_block, octets);
+            STF_ASSERT_EQ(0,
+                          std::memcmp(octets.data(),
+                                      expected.data() + start_block * 16,
+                                      length));
+        }
+    }
+}
+
+// Verify that the sequential engine agrees with random access
+STF_TEST(Philox4x32, Sequential)
+{
+    Philox4x32 engine(0x9abc'def0'1234'5678);
+
+    for (std::uint32_t i = 0; i < 100; i++)
+    {
+        auto block = Philox4x32::At({0x1234'5678, 0x9abc'def0}, {i, 0, 0, 0});
+        for (auto value : block) STF_ASSERT_EQ(value, engine());
+    }
+}
+
+// Verify that discarding agrees with stepping
+STF_TEST(Philox4x32, Discard)
+{
+    for (std::uint64_t count : {0, 1, 3, 4, 5, 1'001})
+    {
+        Philox4x32 expected(42);
+        Philox4x32 engine(42);
+
+        // Start from a position within a block
+        expected();
+        engine();
+
+        for (std::uint64_t i = 0; i < count; i++) expected();
+        engine.Discard(count);
+
+        for (unsigned i = 0; i < 100; i++) STF_ASSERT_EQ(expected(), engine());
+    }
+}
+
+// Verify that Philox4x32 may be used as the generator's engine
+STF_TEST(Philox4x32, RandomGenerator)
+{
+    const std::vector<std::uint32_t> seed_data = {1, 2, 3, 4};
+    BasicRandomGenerator<Philox4x32> generator1(true);
+    BasicRandomGenerator<Philox4x32> generator2(true);
+
+    generator1.Seed(seed_data);
+    generator2.Seed(seed_data);
+    generator2.Discard(1'000);
+    generator1.GetRandomOctets(1'000);
+
+    STF_ASSERT_EQ(generator1.GetRandomOctets(100),
+                  generator2.GetRandomOctets(100));
+}
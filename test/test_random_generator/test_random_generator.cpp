@@ -15,6 +15,9 @@
  *      None.
  */
 
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <terra/random/random_generator.h>
 #include <terra/stf/stf.h>
 
@@ -258,3 +261,157 @@ STF_TEST(RandomGenerator, GetVectorOfRandomOctets3)
     // Ensure that the trail count was not exhausted.
     STF_ASSERT_NE(trials, Retry_Count);
 }
+
+// Verify that seeding produces a reproducible sequence
+STF_TEST(RandomGenerator, SeedReproducible)
+{
+    const std::vector<std::uint32_t> seed_data = {1, 2, 3, 4};
+    RandomGenerator generator1(true);
+    RandomGenerator generator2(true);
+
+    generator1.Seed(seed_data);
+    generator2.Seed(seed_data);
+
+    STF_ASSERT_EQ(generator1.GetRandomOctets(1'000),
+                  generator2.GetRandomOctets(1'000));
+}
+
+// Verify that discarding octets is the same as producing them
+STF_TEST(RandomGenerator, Discard)
+{
+    const std::vector<std::uint32_t> seed_data = {1, 2, 3, 4};
+    RandomGenerator generator1(true);
+    RandomGenerator generator2(true);
+
+    generator1.Seed(seed_data);
+    generator2.Seed(seed_data);
+
+    generator1.GetRandomOctets(5'000'000);
+    generator2.Discard(5'000'000);
+
+    STF_ASSERT_EQ(generator1.GetRandomOctets(1'000),
+                  generator2.GetRandomOctets(1'000));
+}
+
+// Verify that jumping produces a different sub-sequence
+STF_TEST(RandomGenerator, Jump)
+{
+    const std::vector<std::uint32_t> seed_data = {1, 2, 3, 4};
+    RandomGenerator generator1(true);
+    RandomGenerator generator2(true);
+
+    generator1.Seed(seed_data);
+    generator2.Seed(seed_data);
+    generator2.Jump();
+
+    STF_ASSERT_NE(generator1.GetRandomOctets(16),
+                  generator2.GetRandomOctets(16));
+}
+
+// Verify that saving and loading the state continues the sequence
+STF_TEST(RandomGenerator, SaveLoadState)
+{
+    const std::vector<std::uint32_t> seed_data = {1, 2, 3, 4};
+    RandomGenerator generator1(seed_data);
+    RandomGenerator generator2(true);
+
+    generator1.GetRandomOctets(1'234);
+    auto state = generator1.SaveState();
+    STF_ASSERT_EQ(RandomGenerator::Saved_State_Size, state.size());
+
+    STF_ASSERT_TRUE(generator2.LoadState(state));
+    STF_ASSERT_EQ(generator1.GetRandomOctets(1'000),
+                  generator2.GetRandomOctets(1'000));
+}
+
+// Verify that each engine's state can be saved and loaded
+STF_TEST(RandomGenerator, SaveLoadStateEngines)
+{
+    auto check = [](auto generator1, auto generator2)
+    {
+        generator1.GetRandomOctets(7);
+        std::vector<std::uint8_t> state(generator1.Saved_State_Size + 10);
+        STF_ASSERT_EQ(generator1.Saved_State_Size, generator1.SaveState(state));
+
+        GeneratorStateView view(state);
+        STF_ASSERT_TRUE(view.IsValid());
+        STF_ASSERT_EQ(generator1.Saved_State_Size, view.Size());
+        STF_ASSERT_EQ(state.data() + GeneratorStateView::Header_Size,
+                      view.GetEngineState().data());
+        STF_ASSERT_TRUE(generator2.LoadState(view));
+        STF_ASSERT_EQ(generator1.GetRandomOctets(100),
+                      generator2.GetRandomOctets(100));
+    };
+    const std::vector<std::uint32_t> seed_data = {5, 6, 7};
+
+    check(BasicRandomGenerator<Xoshiro256PlusPlus>(seed_data),
+          BasicRandomGenerator<Xoshiro256PlusPlus>(true));
+    check(BasicRandomGenerator<Xoshiro128PlusPlus>(seed_data),
+          BasicRandomGenerator<Xoshiro128PlusPlus>(true));
+    check(BasicRandomGenerator<PCG32>(seed_data),
+          BasicRandomGenerator<PCG32>(true));
+    check(BasicRandomGenerator<Philox4x32>(seed_data),
+          BasicRandomGenerator<Philox4x32>(true));
+}
+
+// Verify that invalid saved state is rejected
+STF_TEST(RandomGenerator, LoadInvalidState)
+{
+    const std::vector<std::uint32_t> seed_data = {1, 2, 3, 4};
+    RandomGenerator generator(seed_data);
+    BasicRandomGenerator<PCG32> other(seed_data);
+    RandomGenerator os_generator;
+
+    auto state = generator.SaveState();
+
+    // Truncated
+    STF_ASSERT_FALSE(generator.LoadState(
+        std::span<const std::uint8_t>(state.data(), state.size() - 1)));
+
+    // Wrong engine
+    STF_ASSERT_FALSE(other.LoadState(state));
+
+    // Different mode
+    STF_ASSERT_FALSE(os_generator.LoadState(state));
+
+    // Corrupt magic value
+    state[0] ^= 0xff;
+    STF_ASSERT_FALSE(generator.LoadState(state));
+}
+
+// Verify that generators may be moved, but not copied
+STF_TEST(RandomGenerator, MoveOnly)
+{
+    static_assert(!std::is_copy_constructible_v<RandomGenerator>);
+    static_assert(!std::is_copy_assignable_v<RandomGenerator>);
+    static_assert(std::is_nothrow_move_constructible_v<RandomGenerator>);
+    static_assert(std::is_nothrow_move_assignable_v<RandomGenerator>);
+
+    const std::vector<std::uint32_t> seed_data = {9, 8, 7};
+    RandomGenerator reference(seed_data);
+    RandomGenerator original(seed_data);
+    std::vector<RandomGenerator> generators;
+
+    // A moved generator continues the original sequence
+    STF_ASSERT_EQ(reference.GetRandomOctets(10), original.GetRandomOctets(10));
+    generators.push_back(std::move(original));
+    for (std::size_t i = 0; i < 10; i++) generators.emplace_back(true);
+    STF_ASSERT_EQ(reference.GetRandomOctets(10),
+                  generators[0].GetRandomOctets(10));
+
+    // Generators using OS sources remain usable after being moved
+    RandomGenerator os_generator;
+    RandomGenerator moved(std::move(os_generator));
+    os_generator = std::move(moved);
+    STF_ASSERT_EQ(100U, os_generator.GetRandomOctets(100).size());
+}
+
+// Verify that the compact generator is usable with and without OS sources
+// (its size is checked where it is defined)
+STF_TEST(RandomGenerator, CompactUsable)
+{
+    CompactRandomGenerator generator;
+    CompactRandomGenerator pseudo_generator(true);
+    STF_ASSERT_EQ(100U, generator.GetRandomOctets(100).size());
+    STF_ASSERT_EQ(100U, pseudo_generator.GetRandomOctets(100).size());
+}
@@ -0,0 +1,212 @@
+/*
+ *  test_random_generator_pool.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the BasicRandomGeneratorPool object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+#include <terra/random/random_generator_pool.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+// Verify that generators are reused and reseeded when returned
+STF_TEST(RandomGeneratorPool, Reuse)
+{
+    RandomGeneratorPool pool(2, true);
+    const RandomGenerator *first;
+    std::vector<std::uint8_t> state;
+
+    STF_ASSERT_EQ(2U, pool.Capacity());
+
+    {
+        auto lease = pool.Checkout();
+        STF_ASSERT_TRUE(lease.IsPooled());
+        first = &*lease;
+        state = lease->SaveState();
+    }
+
+    // The same generator is handed out again, but its state has changed
+    auto lease = pool.Checkout();
+    STF_ASSERT_EQ(first, &*lease);
+    STF_ASSERT_NE(state, lease->SaveState());
+}
+
+// Verify that generators are reseeded after the reserve of seeds is used
+STF_TEST(RandomGeneratorPool, ReserveRefilled)
+{
+    constexpr std::size_t Returns = RandomGeneratorPool::Reserved_Seeds * 3;
+    BasicRandomGeneratorPool<Xoshiro128PlusPlus> pool(1, true);
+    using State =
+        std::array<std::uint8_t, CompactRandomGenerator::Saved_State_Size>;
+    std::set<State> states;
+
+    for (std::size_t i = 0; i <= Returns; i++)
+    {
+        auto lease = pool.Checkout();
+        State state;
+
+        STF_ASSERT_EQ(state.size(), lease->SaveState(state));
+        states.insert(state);
+    }
+
+    STF_ASSERT_EQ(Returns + 1, states.size());
+}
+
+// Verify that pooled generators do not share cache lines
+STF_TEST(RandomGeneratorPool, CacheLineAligned)
+{
+    BasicRandomGeneratorPool<Xoshiro128PlusPlus> pool(2, true);
+    auto lease1 = pool.Checkout();
+    auto lease2 = pool.Checkout();
+    auto address1 = reinterpret_cast<std::uintptr_t>(&*lease1);
+    auto address2 = reinterpret_cast<std::uintptr_t>(&*lease2);
+
+    STF_ASSERT_EQ(0U, address1 % 64);
+    STF_ASSERT_EQ(0U, address2 % 64);
+    STF_ASSERT_LE(std::uintptr_t{64},
+                  std::max(address1, address2) - std::min(address1, address2));
+}
+
+// Verify that a returned generator is advanced using the Jump policy
+STF_TEST(RandomGeneratorPool, JumpPolicy)
+{
+    BasicRandomGeneratorPool<Xoshiro256PlusPlus> pool(
+        1,
+        true,
+        PoolReturnPolicy::Jump);
+    BasicRandomGenerator<Xoshiro256PlusPlus> expected(true);
+
+    {
+        auto lease = pool.Checkout();
+        STF_ASSERT_TRUE(expected.LoadState(lease->SaveState()));
+    }
+
+    expected.Jump();
+    auto lease = pool.Checkout();
+    STF_ASSERT_EQ(expected.GetRandomOctets(32), lease->GetRandomOctets(32));
+}
+
+// Verify that, using the Jump policy, a previous user that seeded the
+// generator can predict what the next user receives
+STF_TEST(RandomGeneratorPool, JumpPolicyPredictable)
+{
+    BasicRandomGeneratorPool<Xoshiro256PlusPlus> pool(
+        1,
+        true,
+        PoolReturnPolicy::Jump);
+    BasicRandomGenerator<Xoshiro256PlusPlus> predicted(true);
+    const std::vector<std::uint32_t> seed_data{1, 2, 3, 4, 5, 6, 7, 8};
+
+    {
+        auto lease = pool.Checkout();
+        lease->Seed(seed_data);
+    }
+
+    predicted.Seed(seed_data);
+    predicted.Jump();
+    auto lease = pool.Checkout();
+    STF_ASSERT_EQ(predicted.GetRandomOctets(32), lease->GetRandomOctets(32));
+}
+
+// Verify that, using the Reseed policy, a previous user that seeded the
+// generator cannot predict what the next user receives
+STF_TEST(RandomGeneratorPool, ReseedPolicyUnpredictable)
+{
+    RandomGeneratorPool pool(1, true);
+    RandomGenerator predicted(true);
+    const std::vector<std::uint32_t> seed_data{1, 2, 3, 4, 5, 6, 7, 8};
+
+    {
+        auto lease = pool.Checkout();
+        lease->Seed(seed_data);
+    }
+
+    predicted.Seed(seed_data);
+    auto lease = pool.Checkout();
+    auto octets = lease->GetRandomOctets(32);
+    STF_ASSERT_NE(predicted.GetRandomOctets(32), octets);
+    predicted.Seed(seed_data);
+    predicted.Jump();
+    STF_ASSERT_NE(predicted.GetRandomOctets(32), octets);
+}
+
+// Verify that checkout succeeds when the pool is exhausted
+STF_TEST(RandomGeneratorPool, Overflow)
+{
+    RandomGeneratorPool pool(1);
+
+    auto lease1 = pool.Checkout();
+    auto lease2 = pool.Checkout();
+    STF_ASSERT_TRUE(lease1.IsPooled());
+    STF_ASSERT_FALSE(lease2.IsPooled());
+    STF_ASSERT_EQ(16U, lease2->GetRandomOctets(16).size());
+
+    // Returning and moving leases
+    lease1.Return();
+    lease2 = pool.Checkout();
+    STF_ASSERT_TRUE(lease2.IsPooled());
+    auto lease3 = std::move(lease2);
+    STF_ASSERT_TRUE(lease3.IsPooled());
+    STF_ASSERT_FALSE(lease2.IsPooled());
+}
+
+// Verify that a generator is never checked out by two threads at once
+STF_TEST(RandomGeneratorPool, Concurrency)
+{
+    constexpr std::size_t Capacity = 4;
+    BasicRandomGeneratorPool<PCG32> pool(Capacity, true);
+    std::vector<std::atomic<int>> in_use(Capacity);
+    std::vector<std::thread> threads;
+    std::atomic<bool> conflict{false};
+
+    // Record the address of each pooled generator
+    std::vector<const void *> addresses;
+    {
+        std::vector<BasicRandomGeneratorPool<PCG32>::Lease> leases;
+        for (std::size_t i = 0; i < Capacity; i++)
+        {
+            leases.push_back(pool.Checkout());
+            addresses.push_back(&*leases.back());
+        }
+    }
+
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        threads.emplace_back([&]()
+        {
+            for (std::size_t j = 0; j < 10'000; j++)
+            {
+                auto lease = pool.Checkout();
+                if (!lease.IsPooled()) continue;
+
+                std::size_t index = 0;
+                while (addresses[index] != &*lease) index++;
+
+                if (in_use[index].fetch_add(1) != 0) conflict = true;
+                lease->GetRandomOctet();
+                in_use[index].fetch_sub(1);
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    STF_ASSERT_FALSE(conflict.load());
+}
@@ -0,0 +1,105 @@
+/*
+ *  test_random_tape.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the RandomTape object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <terra/random/random_tape.h>
+#include <terra/random/parallel_fill.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+namespace
+{
+
+// Return a tape file name unique to the given test
+std::string TapeFile(const std::string &name)
+{
+    return (std::filesystem::temp_directory_path() /
+            ("test_random_tape_" + name + ".tape")).string();
+}
+
+} // namespace
+
+// Verify that the tape holds the ParallelFill() output for its seed
+STF_TEST(RandomTape, Content)
+{
+    constexpr std::uint64_t Seed = 0xfeed;
+    const std::string filename = TapeFile("content");
+    std::vector<std::uint8_t> expected(3 * 1024 * 1024 + 7);
+
+    ParallelFill(expected, 1, Seed);
+    RandomTape::Create(filename, expected.size(), Seed, 2);
+
+    RandomTape tape(filename);
+    STF_ASSERT_EQ(Seed, tape.GetSeed());
+    STF_ASSERT_EQ(expected.size(), tape.Size());
+
+    std::vector<std::uint8_t> octets(expected.size());
+    octets[0] = tape.GetRandomOctet();
+    tape.GetRandomOctets(std::span(octets).subspan(1, 1000));
+    auto view = tape.ViewRandomOctets(octets.size() - 1001);
+    std::copy(view.begin(), view.end(), octets.begin() + 1001);
+
+    STF_ASSERT_EQ(expected, octets);
+    STF_ASSERT_EQ(0U, tape.Remaining());
+    STF_ASSERT_EXCEPTION_E(tape.GetRandomOctet(), std::out_of_range);
+
+    std::filesystem::remove(filename);
+}
+
+// Verify that the tape may be read from any position
+STF_TEST(RandomTape, Seek)
+{
+    const std::string filename = TapeFile("seek");
+
+    RandomTape::Create(filename, 10'000, 1);
+    RandomTape tape(filename);
+
+    tape.Seek(5'000);
+    auto octets = tape.GetRandomOctets(100);
+    STF_ASSERT_EQ(5'100U, tape.Tell());
+
+    tape.Seek(5'000);
+    STF_ASSERT_EQ(octets, tape.GetRandomOctets(100));
+
+    tape.Seek(10'000);
+    STF_ASSERT_EQ(0U, tape.Remaining());
+    STF_ASSERT_EXCEPTION_E(tape.Seek(10'001), std::out_of_range);
+
+    // Reading beyond the end does not change the position
+    tape.Seek(9'990);
+    STF_ASSERT_EXCEPTION_E(tape.GetRandomOctets(11), std::out_of_range);
+    STF_ASSERT_EQ(9'990U, tape.Tell());
+
+    std::filesystem::remove(filename);
+}
+
+// Verify that an invalid tape is rejected
+STF_TEST(RandomTape, InvalidTape)
+{
+    const std::string filename = TapeFile("invalid");
+
+    std::ofstream(filename) << "not a random tape";
+    STF_ASSERT_EXCEPTION_E(RandomTape{filename}, std::runtime_error);
+    std::filesystem::remove(filename);
+
+    STF_ASSERT_EXCEPTION_E(RandomTape{filename}, std::runtime_error);
+}
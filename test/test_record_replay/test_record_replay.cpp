@@ -0,0 +1,120 @@
+/*
+ *  test_record_replay.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the BasicRecordingGenerator and
+ *      ReplayGenerator objects.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <array>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <terra/random/recording_generator.h>
+#include <terra/random/replay_generator.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+namespace
+{
+
+// Return a log file name unique to the given test
+std::string LogFile(const std::string &name)
+{
+    return (std::filesystem::temp_directory_path() /
+            ("test_record_replay_" + name + ".log")).string();
+}
+
+} // namespace
+
+// Verify that replay produces exactly the recorded octets
+STF_TEST(RecordReplay, RoundTrip)
+{
+    const std::string filename = LogFile("round_trip");
+    RandomGenerator generator;
+    std::vector<std::uint8_t> expected;
+
+    {
+        RecordingGenerator recorder(generator, filename, 64);
+        std::array<std::uint8_t, 1'000> octets;
+
+        expected.push_back(recorder.GetRandomOctet(1));
+        auto block = recorder.GetRandomOctets(10, 2);
+        expected.insert(expected.end(), block.begin(), block.end());
+        recorder.GetRandomOctets(octets, 3);
+        expected.insert(expected.end(), octets.begin(), octets.end());
+        recorder.GetRandomOctets(0, 4);
+
+        STF_ASSERT_TRUE(recorder.Flush());
+    }
+
+    ReplayGenerator replay(filename);
+    std::vector<std::uint8_t> actual;
+    std::array<std::uint8_t, 1'000> octets;
+
+    actual.push_back(replay.GetRandomOctet(1));
+    auto block = replay.ViewRandomOctets(10, 2);
+    actual.insert(actual.end(), block.begin(), block.end());
+    replay.GetRandomOctets(octets, 3);
+    actual.insert(actual.end(), octets.begin(), octets.end());
+    STF_ASSERT_TRUE(replay.GetRandomOctets(0, 4).empty());
+
+    STF_ASSERT_TRUE(replay.AtEnd());
+    STF_ASSERT_EQ(expected, actual);
+
+    std::filesystem::remove(filename);
+}
+
+// Verify that a divergent replay is detected
+STF_TEST(RecordReplay, Divergence)
+{
+    const std::string filename = LogFile("divergence");
+    RandomGenerator generator(true);
+
+    {
+        RecordingGenerator recorder(generator, filename);
+        recorder.GetRandomOctets(16, 7);
+        recorder.GetRandomOctets(16, 8);
+    }
+
+    ReplayGenerator replay(filename);
+
+    // Wrong length
+    STF_ASSERT_EXCEPTION_E(replay.GetRandomOctets(15, 7), std::runtime_error);
+
+    ReplayGenerator replay2(filename);
+    replay2.GetRandomOctets(16, 7);
+
+    // Wrong tag
+    STF_ASSERT_EXCEPTION_E(replay2.GetRandomOctets(16, 9), std::runtime_error);
+    replay2.GetRandomOctets(16, 8);
+
+    // Exhausted
+    STF_ASSERT_EXCEPTION_E(replay2.GetRandomOctet(), std::runtime_error);
+
+    std::filesystem::remove(filename);
+}
+
+// Verify that an invalid log is rejected
+STF_TEST(RecordReplay, InvalidLog)
+{
+    const std::string filename = LogFile("invalid");
+
+    std::ofstream(filename) << "not a random log";
+    STF_ASSERT_EXCEPTION_E(ReplayGenerator{filename}, std::runtime_error);
+    std::filesystem::remove(filename);
+
+    STF_ASSERT_EXCEPTION_E(ReplayGenerator{filename}, std::runtime_error);
+}
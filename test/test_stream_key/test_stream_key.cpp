@@ -0,0 +1,78 @@
+/*
+ *  test_stream_key.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      This module contains tests for the StreamKey object.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <set>
+#include <string>
+#include <terra/random/stream_key.h>
+#include <terra/random/random_generator.h>
+#include <terra/stf/stf.h>
+
+using namespace Terra::Random;
+
+// Verify that derivation is deterministic and hierarchical
+STF_TEST(StreamKey, Deterministic)
+{
+    StreamKey master(1234);
+    StreamKey node = Derive(master, 7);
+
+    STF_ASSERT_EQ(Derive(master, 7, 3, 1, "purpose"),
+                  Derive(node, 3, 1, "purpose"));
+    STF_ASSERT_EQ(Derive(master, 7, 3, 1, "purpose"),
+                  Derive(StreamKey(1234), 7, 3, 1, "purpose"));
+    STF_ASSERT_EQ(master, Derive(master));
+}
+
+// Verify that distinct paths produce distinct keys
+STF_TEST(StreamKey, Distinct)
+{
+    StreamKey master(1234);
+    std::set<StreamKey::Value> values;
+
+    for (unsigned node = 0; node < 16; node++)
+    {
+        for (unsigned rank = 0; rank < 16; rank++)
+        {
+            for (unsigned thread = 0; thread < 16; thread++)
+            {
+                values.insert(
+                    Derive(master, node, rank, thread, "a").GetValue());
+                values.insert(
+                    Derive(master, node, rank, thread, "b").GetValue());
+            }
+        }
+    }
+    STF_ASSERT_EQ(16U * 16U * 16U * 2U, values.size());
+
+    // Encodings must not be ambiguous
+    STF_ASSERT_NE(Derive(master, "ab", "c"), Derive(master, "a", "bc"));
+    STF_ASSERT_NE(Derive(master, 1), Derive(master, std::string(1, '\1')));
+    STF_ASSERT_NE(Derive(master, 1, 2), Derive(master, 2, 1));
+    STF_ASSERT_NE(StreamKey(1), StreamKey(2));
+}
+
+// Verify that generators seeded from derived keys are reproducible
+STF_TEST(StreamKey, SeedGenerator)
+{
+    StreamKey master(1234);
+    RandomGenerator generator1(Derive(master, 1, "x").SeedData());
+    RandomGenerator generator2(Derive(master, 1, "x").SeedData());
+    RandomGenerator generator3(Derive(master, 2, "x").SeedData());
+
+    auto octets = generator1.GetRandomOctets(64);
+    STF_ASSERT_EQ(octets, generator2.GetRandomOctets(64));
+    STF_ASSERT_NE(octets, generator3.GetRandomOctets(64));
+}
@@ -0,0 +1,1399 @@
+/*
+ *  random_quality.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Utility to apply a battery of statistical tests to the octets
+ *      produced by a BasicRandomGenerator.
+ *
+ *      Usage:
+ *          random_quality [-e engine] [-m prng|source] [-s size[K|M|G|T]]
+ *                         [-S seed] [-t threads]
+ *
+ *      The tests are applied to one stream of octets, in the manner of
+ *      PractRand: each test accumulates its statistics over the stream,
+ *      and the results are reported each time the length of the stream
+ *      tested doubles, until the given size is reached or a test fails.
+ *      Each p-value is reported as "unusual" if it is within 10^-4 of 0 or
+ *      1 and as "FAIL" if it is within 10^-10 (at which point testing
+ *      stops and the exit code is 1).
+ *
+ *      The tests are:
+ *
+ *          frequency   Chi-square test of the distribution of octets
+ *          serial      Chi-square test of the distribution of
+ *                      non-overlapping pairs of octets
+ *          gap         Knuth's gap test on octets less than 32
+ *          runs        Knuth's runs up test on 32-bit words, discarding
+ *                      the word that follows each run
+ *          weight      Distribution of the Hamming weight of 64-bit words
+ *          birthday    Marsaglia's birthday spacings test with 4096
+ *                      birthdays in a year of 2^32 days (sampled from
+ *                      the first 16 KiB of every 256 KiB)
+ *          complexity  NIST linear complexity test on 512-bit blocks
+ *                      (sampled from the first 64 octets of every 16 KiB)
+ *          rank        NIST binary matrix rank test on 32x32 matrices
+ *                      (sampled from the first 128 octets of every 1 KiB)
+ *
+ *      The most expensive tests are applied to samples of the stream so
+ *      that the battery costs a small multiple of generating the octets.
+ *      Octets are assembled into words in little-endian order.
+ *
+ *      The stream is divided into chunks that are generated and tested in
+ *      parallel.  With the "prng" mode (the default), each thread's
+ *      generator is seeded identically and positioned with Discard() at
+ *      the start of each chunk, so the octets tested are those of a single
+ *      generator and do not depend on the number of threads.  With the
+ *      "source" mode, each thread's generator reads the random sources, as
+ *      does a RandomGenerator constructed without arguments.
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <span>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <bit>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <terra/random/random_generator.h>
+
+using namespace Terra::Random;
+
+namespace
+{
+
+// Octets generated and tested at a time by each thread
+constexpr std::size_t Block_Size = std::size_t{1} << 20;
+
+// Largest number of octets in each chunk of the stream
+constexpr std::uint64_t Chunk_Size = std::uint64_t{64} << 20;
+
+// p-values this close to 0 or 1 are unusual or failures
+constexpr double Unusual_Threshold = 1e-4;
+constexpr double Fail_Threshold = 1e-10;
+
+// Categories are merged until each is expected to have this many samples
+constexpr double Minimum_Expected = 5.0;
+
+// Gap test: octets below Gap_Octet begin and end gaps, and gaps of
+// Gap_Limit or more octets are counted together
+constexpr unsigned Gap_Octet = 32;
+constexpr std::size_t Gap_Limit = 64;
+
+// Runs test: runs of Run_Limit or more are counted together
+constexpr std::size_t Run_Limit = 7;
+
+// Birthday spacings test parameters (lambda = n^3 / (4 * 2^32) = 4)
+constexpr std::size_t Birthdays = 4096;
+constexpr double Birthday_Lambda = 4.0;
+constexpr std::size_t Spacing_Limit = 12;
+constexpr std::size_t Birthday_Interval = std::size_t{256} << 10;
+
+// Linear complexity test parameters
+constexpr std::size_t Complexity_Bits = 512;
+constexpr std::size_t Complexity_Interval = std::size_t{16} << 10;
+constexpr std::size_t Complexity_Words = Complexity_Bits / 64 + 1;
+
+// Matrix rank test parameters
+constexpr std::size_t Matrix_Rows = 32;
+constexpr std::size_t Rank_Interval = 1024;
+
+// Options given on the command line
+struct Options
+{
+    std::string engine = "mt19937";
+    bool pseudo_random_only = true;
+    std::uint64_t size = std::uint64_t{1} << 30;
+    std::uint64_t seed = 0;
+    unsigned threads = 0;
+};
+
+// Counts accumulated by each test
+struct Statistics
+{
+    std::array<std::uint64_t, 256> octets{};
+    std::vector<std::uint64_t> pairs = std::vector<std::uint64_t>(65536);
+    std::array<std::uint64_t, Gap_Limit + 1> gaps{};
+    std::array<std::uint64_t, Run_Limit> runs{};
+    std::array<std::uint64_t, 65> weights{};
+    std::array<std::uint64_t, Spacing_Limit + 1> spacings{};
+    std::array<std::uint64_t, 7> complexity{};
+    std::array<std::uint64_t, 3> ranks{};
+
+    void Merge(const Statistics &other);
+};
+
+// State of the tests that examine consecutive values within a chunk
+struct ChunkState
+{
+    std::uint64_t position = 0;
+    bool in_gap = false;
+    std::uint64_t gap_start = 0;
+    std::size_t run = 0;
+    std::uint32_t previous = 0;
+};
+
+// The result of one test
+struct TestResult
+{
+    const char *name;
+    double p_value;
+    bool valid;
+};
+
+/*
+ *  Statistics::Merge()
+ *
+ *  Description:
+ *      Add the counts of another set of statistics to these.
+ *
+ *  Parameters:
+ *      other [in]
+ *          The statistics to add.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void Statistics::Merge(const Statistics &other)
+{
+    auto add = [](auto &total, const auto &counts)
+    {
+        for (std::size_t i = 0; i < total.size(); i++) total[i] += counts[i];
+    };
+
+    add(octets, other.octets);
+    add(pairs, other.pairs);
+    add(gaps, other.gaps);
+    add(runs, other.runs);
+    add(weights, other.weights);
+    add(spacings, other.spacings);
+    add(complexity, other.complexity);
+    add(ranks, other.ranks);
+}
+
+/*
+ *  UpperGamma()
+ *
+ *  Description:
+ *      Compute the regularized upper incomplete gamma function Q(a, x).
+ *
+ *  Parameters:
+ *      a [in]
+ *          The shape parameter, which is positive.
+ *
+ *      x [in]
+ *          The upper limit of integration, which is not negative.
+ *
+ *  Returns:
+ *      The value of Q(a, x).
+ *
+ *  Comments:
+ *      The series is used for x < a + 1 and the continued fraction
+ *      otherwise, as each converges quickly in its region.
+ */
+double UpperGamma(double a, double x)
+{
+    constexpr int Iterations = 100'000;
+    constexpr double Epsilon = 1e-15;
+    constexpr double Tiny = 1e-300;
+
+    if (x <= 0.0) return 1.0;
+
+    const double prefix = std::exp(-x + a * std::log(x) - std::lgamma(a));
+
+    if (x < a + 1.0)
+    {
+        double term = 1.0 / a;
+        double sum = term;
+
+        for (int n = 1; n < Iterations; n++)
+        {
+            term *= x / (a + n);
+            sum += term;
+            if (term < sum * Epsilon) break;
+        }
+
+        return 1.0 - sum * prefix;
+    }
+
+    // Modified Lentz's method
+    double b = x + 1.0 - a;
+    double c = 1.0 / Tiny;
+    double d = 1.0 / b;
+    double h = d;
+
+    for (int n = 1; n < Iterations; n++)
+    {
+        const double an = -n * (n - a);
+
+        b += 2.0;
+        d = an * d + b;
+        if (std::fabs(d) < Tiny) d = Tiny;
+        c = b + an / c;
+        if (std::fabs(c) < Tiny) c = Tiny;
+        d = 1.0 / d;
+
+        const double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < Epsilon) break;
+    }
+
+    return h * prefix;
+}
+
+/*
+ *  ChiSquareTest()
+ *
+ *  Description:
+ *      Perform a chi-square goodness-of-fit test.
+ *
+ *  Parameters:
+ *      name [in]
+ *          The name of the test.
+ *
+ *      observed [in]
+ *          The number of samples observed in each category.
+ *
+ *      probabilities [in]
+ *          The probability of a sample falling in each category.
+ *
+ *  Returns:
+ *      The result of the test, which is not valid if there are too few
+ *      samples.
+ *
+ *  Comments:
+ *      Adjacent categories are merged until each is expected to hold at
+ *      least Minimum_Expected samples, so that the chi-square distribution
+ *      approximates that of the statistic.
+ */
+template<typename Counts>
+TestResult ChiSquareTest(const char *name,
+                         const Counts &observed,
+                         std::span<const double> probabilities)
+{
+    double samples = 0.0;
+
+    for (auto count : observed) samples += static_cast<double>(count);
+
+    double statistic = 0.0;
+    std::size_t categories = 0;
+    double merged_observed = 0.0;
+    double merged_expected = 0.0;
+    double last_observed = 0.0;
+    double last_expected = 0.0;
+
+    auto add_category = [&](double observed_count, double expected_count)
+    {
+        const double difference = observed_count - expected_count;
+
+        statistic += difference * difference / expected_count;
+        categories++;
+    };
+
+    for (std::size_t i = 0; i < probabilities.size(); i++)
+    {
+        merged_observed += static_cast<double>(observed[i]);
+        merged_expected += probabilities[i] * samples;
+
+        if (merged_expected >= Minimum_Expected)
+        {
+            if (last_expected > 0.0) add_category(last_observed,
+                                                  last_expected);
+            last_observed = merged_observed;
+            last_expected = merged_expected;
+            merged_observed = 0.0;
+            merged_expected = 0.0;
+        }
+    }
+
+    // Any remainder is merged with the last category
+    last_observed += merged_observed;
+    last_expected += merged_expected;
+    if (last_expected > 0.0) add_category(last_observed, last_expected);
+
+    if (categories < 2) return {name, 0.0, false};
+
+    return {name,
+            UpperGamma(static_cast<double>(categories - 1) / 2.0,
+                       statistic / 2.0),
+            true};
+}
+
+/*
+ *  UniformProbabilities()
+ *
+ *  Description:
+ *      Produce the probabilities of equally likely categories.
+ *
+ *  Parameters:
+ *      count [in]
+ *          The number of categories.
+ *
+ *  Returns:
+ *      The probabilities.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<double> UniformProbabilities(std::size_t count)
+{
+    return std::vector<double>(count, 1.0 / static_cast<double>(count));
+}
+
+/*
+ *  GapProbabilities()
+ *
+ *  Description:
+ *      Produce the probabilities of each gap length.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The probabilities of gaps of 0 to Gap_Limit - 1 octets, followed by
+ *      that of a gap of Gap_Limit or more.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<double> GapProbabilities()
+{
+    const double p = Gap_Octet / 256.0;
+    std::vector<double> probabilities;
+
+    for (std::size_t r = 0; r < Gap_Limit; r++)
+    {
+        probabilities.push_back(p * std::pow(1.0 - p, r));
+    }
+    probabilities.push_back(std::pow(1.0 - p, Gap_Limit));
+
+    return probabilities;
+}
+
+/*
+ *  RunProbabilities()
+ *
+ *  Description:
+ *      Produce the probabilities of each run length.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The probabilities of runs of 1 to Run_Limit - 1 values, followed by
+ *      that of a run of Run_Limit or more.
+ *
+ *  Comments:
+ *      Since the value following each run is discarded, the run lengths
+ *      are independent and a run has length r with probability
+ *      1/r! - 1/(r+1)!.
+ */
+std::vector<double> RunProbabilities()
+{
+    std::vector<double> probabilities;
+    double factorial = 1.0;
+
+    for (std::size_t r = 1; r < Run_Limit; r++)
+    {
+        factorial *= static_cast<double>(r);
+        probabilities.push_back(1.0 / factorial -
+                                1.0 / (factorial * (r + 1.0)));
+    }
+    probabilities.push_back(1.0 / (factorial * Run_Limit));
+
+    return probabilities;
+}
+
+/*
+ *  WeightProbabilities()
+ *
+ *  Description:
+ *      Produce the probabilities of each Hamming weight of a 64-bit word.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The probabilities of weights 0 to 64.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<double> WeightProbabilities()
+{
+    std::vector<double> probabilities;
+
+    for (int k = 0; k <= 64; k++)
+    {
+        probabilities.push_back(std::exp(std::lgamma(65.0) -
+                                         std::lgamma(k + 1.0) -
+                                         std::lgamma(65.0 - k) -
+                                         64.0 * std::log(2.0)));
+    }
+
+    return probabilities;
+}
+
+/*
+ *  SpacingProbabilities()
+ *
+ *  Description:
+ *      Produce the probabilities of each number of duplicate spacings in
+ *      the birthday spacings test.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The Poisson probabilities of 0 to Spacing_Limit - 1 duplicates,
+ *      followed by that of Spacing_Limit or more.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<double> SpacingProbabilities()
+{
+    std::vector<double> probabilities;
+    double term = std::exp(-Birthday_Lambda);
+    double total = 0.0;
+
+    for (std::size_t k = 0; k < Spacing_Limit; k++)
+    {
+        probabilities.push_back(term);
+        total += term;
+        term *= Birthday_Lambda / static_cast<double>(k + 1);
+    }
+    probabilities.push_back(1.0 - total);
+
+    return probabilities;
+}
+
+/*
+ *  ComplexityProbabilities()
+ *
+ *  Description:
+ *      Produce the probabilities of the categories of the linear
+ *      complexity test.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The probabilities that the linear complexity L of a block is at most
+ *      M/2 - 3, M/2 - 2, ..., M/2 + 2, or at least M/2 + 3.
+ *
+ *  Comments:
+ *      These are the exact values rounded in NIST SP 800-22, section 3.10,
+ *      omitting terms of order 2^-M.
+ */
+std::vector<double> ComplexityProbabilities()
+{
+    return {1.0 / 96, 1.0 / 32, 1.0 / 8, 1.0 / 2, 1.0 / 4, 1.0 / 16, 1.0 / 48};
+}
+
+/*
+ *  RankProbabilities()
+ *
+ *  Description:
+ *      Produce the probabilities of the ranks of a random binary matrix.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The probabilities that the rank is Matrix_Rows, Matrix_Rows - 1,
+ *      or less.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<double> RankProbabilities()
+{
+    const double m = static_cast<double>(Matrix_Rows);
+
+    auto probability = [m](double r)
+    {
+        double product = std::pow(2.0, r * (2.0 * m - r) - m * m);
+
+        for (double i = 0.0; i < r; i++)
+        {
+            const double factor = 1.0 - std::pow(2.0, i - m);
+            product *= factor * factor / (1.0 - std::pow(2.0, i - r));
+        }
+
+        return product;
+    };
+
+    const double full = probability(m);
+    const double deficient = probability(m - 1.0);
+
+    return {full, deficient, 1.0 - full - deficient};
+}
+
+/*
+ *  LoadWord()
+ *
+ *  Description:
+ *      Load a 64-bit word in little-endian order.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The octets of the word, of which only the first four are read if
+ *          the length is 4.
+ *
+ *      length [in]
+ *          The number of octets to load (4 or 8).
+ *
+ *  Returns:
+ *      The word.
+ *
+ *  Comments:
+ *      Compilers recognize this as a single load on little-endian
+ *      processors.
+ */
+std::uint64_t LoadWord(const std::uint8_t *octets, std::size_t length = 4)
+{
+    std::uint64_t word = 0;
+
+    for (std::size_t i = 0; i < length; i++)
+    {
+        word |= std::uint64_t{octets[i]} << (8 * i);
+    }
+
+    return word;
+}
+
+/*
+ *  HammingWeight()
+ *
+ *  Description:
+ *      Count the bits set in a word.
+ *
+ *  Parameters:
+ *      word [in]
+ *          The word.
+ *
+ *  Returns:
+ *      The number of bits set.
+ *
+ *  Comments:
+ *      This avoids the library call that std::popcount() becomes when the
+ *      target processor is not known to have a population count
+ *      instruction.
+ */
+unsigned HammingWeight(std::uint64_t word)
+{
+    word -= (word >> 1) & 0x5555'5555'5555'5555;
+    word = (word & 0x3333'3333'3333'3333) +
+           ((word >> 2) & 0x3333'3333'3333'3333);
+    word = (word + (word >> 4)) & 0x0f0f'0f0f'0f0f'0f0f;
+
+    return static_cast<unsigned>((word * 0x0101'0101'0101'0101) >> 56);
+}
+
+/*
+ *  GapStarts()
+ *
+ *  Description:
+ *      Find the octets of a word that are less than Gap_Octet.
+ *
+ *  Parameters:
+ *      word [in]
+ *          The word, loaded in little-endian order.
+ *
+ *  Returns:
+ *      A mask in which bit i is set if octet i is less than Gap_Octet.
+ *
+ *  Comments:
+ *      The octets less than 32 are those whose top 3 bits are clear.  The
+ *      bits so found (bit 7 of each octet) are gathered into the top octet
+ *      of the product.
+ */
+std::uint64_t GapStarts(std::uint64_t word)
+{
+    static_assert(Gap_Octet == 32);
+
+    const std::uint64_t high = word & 0xe0e0'e0e0'e0e0'e0e0;
+    const std::uint64_t clear = ~(high | (high << 1) | (high << 2)) &
+                                0x8080'8080'8080'8080;
+
+    return ((clear >> 7) * 0x0102'0408'1020'4080) >> 56;
+}
+
+/*
+ *  LinearComplexity()
+ *
+ *  Description:
+ *      Compute the linear complexity of a block of bits with the
+ *      Berlekamp-Massey algorithm.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The block, of Complexity_Bits / 8 octets, taken least significant
+ *          bit first.
+ *
+ *  Returns:
+ *      The length of the shortest linear feedback shift register that
+ *      produces the block.
+ *
+ *  Comments:
+ *      The connection polynomials and the most recent bits of the block
+ *      (in reverse order) are held in words, so each discrepancy is the
+ *      parity of their intersection.
+ */
+std::size_t LinearComplexity(std::span<const std::uint8_t> octets)
+{
+    using Bits = std::array<std::uint64_t, Complexity_Words>;
+
+    Bits connection{1};
+    Bits prior{1};
+    Bits window{};
+    std::size_t complexity = 0;
+    std::size_t shift = 1;
+
+    for (std::size_t n = 0; n < Complexity_Bits; n++)
+    {
+        // Only the words holding bits 0 through n of the window are used
+        const std::size_t used = n / 64 + 1;
+
+        // Shift the next bit into the window, so bit i is bit n - i
+        for (std::size_t w = used - 1; w > 0; w--)
+        {
+            window[w] = (window[w] << 1) | (window[w - 1] >> 63);
+        }
+        window[0] = (window[0] << 1) | ((octets[n / 8] >> (n % 8)) & 1);
+
+        std::uint64_t discrepancy = 0;
+        for (std::size_t w = 0; w < used; w++)
+        {
+            discrepancy ^= connection[w] & window[w];
+        }
+
+        if ((std::popcount(discrepancy) & 1) == 0)
+        {
+            shift++;
+            continue;
+        }
+
+        // Subtract the prior polynomial, multiplied by x^shift
+        const Bits current = connection;
+        const std::size_t words = shift / 64;
+        const std::size_t bits = shift % 64;
+
+        for (std::size_t w = Complexity_Words; w-- > words;)
+        {
+            std::uint64_t value = prior[w - words] << bits;
+            if ((bits != 0) && (w > words))
+            {
+                value |= prior[w - words - 1] >> (64 - bits);
+            }
+            connection[w] ^= value;
+        }
+
+        if (2 * complexity <= n)
+        {
+            complexity = n + 1 - complexity;
+            prior = current;
+            shift = 1;
+        }
+        else
+        {
+            shift++;
+        }
+    }
+
+    return complexity;
+}
+
+/*
+ *  MatrixRank()
+ *
+ *  Description:
+ *      Compute the rank of a binary matrix over GF(2).
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The matrix, with each row formed from 4 octets.
+ *
+ *  Returns:
+ *      The rank of the matrix.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t MatrixRank(std::span<const std::uint8_t> octets)
+{
+    std::array<std::uint32_t, Matrix_Rows> rows;
+    std::size_t rank = 0;
+
+    for (std::size_t i = 0; i < Matrix_Rows; i++)
+    {
+        rows[i] = static_cast<std::uint32_t>(LoadWord(&octets[i * 4]));
+    }
+
+    for (std::uint32_t bit = 1; (bit != 0) && (rank < Matrix_Rows); bit <<= 1)
+    {
+        auto pivot = std::find_if(rows.begin() + rank,
+                                  rows.end(),
+                                  [bit](std::uint32_t row)
+                                  {
+                                      return (row & bit) != 0;
+                                  });
+        if (pivot == rows.end()) continue;
+
+        std::swap(rows[rank], *pivot);
+        for (std::size_t i = rank + 1; i < Matrix_Rows; i++)
+        {
+            if (rows[i] & bit) rows[i] ^= rows[rank];
+        }
+        rank++;
+    }
+
+    return rank;
+}
+
+/*
+ *  RadixSort()
+ *
+ *  Description:
+ *      Sort 32-bit values.
+ *
+ *  Parameters:
+ *      values [in/out]
+ *          The values to sort.
+ *
+ *      scratch [out]
+ *          A buffer of the same size as the values.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      Each of the four passes sorts by one octet of the values, least
+ *      significant first.
+ */
+void RadixSort(std::vector<std::uint32_t> &values,
+               std::vector<std::uint32_t> &scratch)
+{
+    for (unsigned shift = 0; shift < 32; shift += 8)
+    {
+        std::array<std::size_t, 256> offsets{};
+
+        for (auto value : values) offsets[(value >> shift) & 0xff]++;
+
+        std::size_t offset = 0;
+        for (auto &count : offsets) offset += std::exchange(count, offset);
+
+        for (auto value : values)
+        {
+            scratch[offsets[(value >> shift) & 0xff]++] = value;
+        }
+
+        values.swap(scratch);
+    }
+}
+
+/*
+ *  DuplicateSpacings()
+ *
+ *  Description:
+ *      Count the duplicate spacings among birthdays.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The birthdays, each formed from 4 octets.
+ *
+ *      birthdays [out]
+ *          A buffer of Birthdays values used to sort the birthdays.
+ *
+ *      scratch [out]
+ *          A buffer of Birthdays values used by RadixSort().
+ *
+ *  Returns:
+ *      The number of spacings between sorted birthdays that equal another
+ *      spacing.
+ *
+ *  Comments:
+ *      None.
+ */
+std::size_t DuplicateSpacings(std::span<const std::uint8_t> octets,
+                              std::vector<std::uint32_t> &birthdays,
+                              std::vector<std::uint32_t> &scratch)
+{
+    for (std::size_t i = 0; i < Birthdays; i++)
+    {
+        birthdays[i] = static_cast<std::uint32_t>(LoadWord(&octets[i * 4]));
+    }
+    RadixSort(birthdays, scratch);
+
+    // Replace each birthday with its spacing from the prior birthday
+    for (std::size_t i = Birthdays - 1; i > 0; i--)
+    {
+        birthdays[i] -= birthdays[i - 1];
+    }
+    RadixSort(birthdays, scratch);
+
+    std::size_t duplicates = 0;
+    for (std::size_t i = 1; i < Birthdays; i++)
+    {
+        if (birthdays[i] == birthdays[i - 1]) duplicates++;
+    }
+
+    return duplicates;
+}
+
+/*
+ *  TestBlock()
+ *
+ *  Description:
+ *      Accumulate the statistics of each test over a block of octets.
+ *
+ *  Parameters:
+ *      octets [in]
+ *          The block, which is at most Block_Size octets and starts at a
+ *          multiple of Block_Size within its chunk.
+ *
+ *      statistics [in/out]
+ *          The statistics to accumulate.
+ *
+ *      state [in/out]
+ *          The state of the tests that continue from the prior block of the
+ *          chunk.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void TestBlock(std::span<const std::uint8_t> octets,
+               Statistics &statistics,
+               ChunkState &state)
+{
+    static thread_local std::vector<std::uint32_t> birthdays(Birthdays);
+    static thread_local std::vector<std::uint32_t> scratch(Birthdays);
+
+    // Count octets in four tables, so consecutive equal octets do not wait
+    // for one another's increments
+    std::array<std::array<std::uint32_t, 256>, 4> counts{};
+    std::size_t i = 0;
+
+    for (; i + 4 <= octets.size(); i += 4)
+    {
+        for (std::size_t j = 0; j < 4; j++) counts[j][octets[i + j]]++;
+    }
+    for (; i < octets.size(); i++) counts[0][octets[i]]++;
+
+    for (std::size_t octet = 0; octet < 256; octet++)
+    {
+        statistics.octets[octet] += counts[0][octet] + counts[1][octet] +
+                                    counts[2][octet] + counts[3][octet];
+    }
+
+    for (i = 0; i + 2 <= octets.size(); i += 2)
+    {
+        statistics.pairs[octets[i] | (octets[i + 1] << 8)]++;
+    }
+
+    for (i = 0; i + 8 <= octets.size(); i += 8)
+    {
+        const std::uint64_t word = LoadWord(&octets[i], 8);
+
+        statistics.weights[HammingWeight(word)]++;
+
+        // A run ends (and the value is discarded) if the value does not
+        // exceed the prior one; this avoids unpredictable branches
+        for (auto value : {static_cast<std::uint32_t>(word),
+                           static_cast<std::uint32_t>(word >> 32)})
+        {
+            const bool ended = (state.run != 0) && (value <= state.previous);
+
+            statistics.runs[std::clamp<std::size_t>(state.run, 1, Run_Limit) -
+                            1] += ended ? 1 : 0;
+            state.run = ended ? 0 : state.run + 1;
+            state.previous = value;
+        }
+    }
+
+    // Find the octets below Gap_Octet 64 at a time, so the loop over them
+    // ends with one mispredicted branch per 64 octets rather than per octet
+    for (i = 0; i + 64 <= octets.size(); i += 64)
+    {
+        std::uint64_t starts = 0;
+
+        for (std::size_t j = 0; j < 8; j++)
+        {
+            starts |= GapStarts(LoadWord(&octets[i + j * 8], 8)) << (j * 8);
+        }
+
+        while (starts != 0)
+        {
+            const std::uint64_t position =
+                state.position + i + std::countr_zero(starts);
+
+            if (state.in_gap)
+            {
+                statistics.gaps[std::min<std::uint64_t>(
+                    position - state.gap_start - 1,
+                    Gap_Limit)]++;
+            }
+            state.in_gap = true;
+            state.gap_start = position;
+            starts &= starts - 1;
+        }
+    }
+
+    state.position += octets.size();
+
+    for (i = 0; i + Birthdays * 4 <= octets.size();
+         i += Birthday_Interval)
+    {
+        const std::size_t duplicates =
+            DuplicateSpacings(octets.subspan(i, Birthdays * 4),
+                              birthdays,
+                              scratch);
+
+        statistics.spacings[std::min(duplicates, Spacing_Limit)]++;
+    }
+
+    for (i = 0; i + Complexity_Bits / 8 <= octets.size();
+         i += Complexity_Interval)
+    {
+        const auto complexity = static_cast<long>(
+            LinearComplexity(octets.subspan(i, Complexity_Bits / 8)));
+        const long deviation = complexity -
+                               static_cast<long>(Complexity_Bits / 2);
+
+        statistics.complexity[std::clamp(deviation, -3L, 3L) + 3]++;
+    }
+
+    for (i = 0; i + Matrix_Rows * 4 <= octets.size();
+         i += Rank_Interval)
+    {
+        const std::size_t rank =
+            MatrixRank(octets.subspan(i, Matrix_Rows * 4));
+
+        statistics.ranks[std::min(Matrix_Rows - rank, std::size_t{2})]++;
+    }
+}
+
+/*
+ *  Evaluate()
+ *
+ *  Description:
+ *      Compute the result of each test from the accumulated statistics.
+ *
+ *  Parameters:
+ *      statistics [in]
+ *          The statistics accumulated over the stream.
+ *
+ *  Returns:
+ *      The results of the tests.
+ *
+ *  Comments:
+ *      None.
+ */
+std::vector<TestResult> Evaluate(const Statistics &statistics)
+{
+    static const auto octet_probabilities = UniformProbabilities(256);
+    static const auto pair_probabilities = UniformProbabilities(65536);
+    static const auto gap_probabilities = GapProbabilities();
+    static const auto run_probabilities = RunProbabilities();
+    static const auto weight_probabilities = WeightProbabilities();
+    static const auto spacing_probabilities = SpacingProbabilities();
+    static const auto complexity_probabilities = ComplexityProbabilities();
+    static const auto rank_probabilities = RankProbabilities();
+
+    return {
+        ChiSquareTest("frequency", statistics.octets, octet_probabilities),
+        ChiSquareTest("serial", statistics.pairs, pair_probabilities),
+        ChiSquareTest("gap", statistics.gaps, gap_probabilities),
+        ChiSquareTest("runs", statistics.runs, run_probabilities),
+        ChiSquareTest("weight", statistics.weights, weight_probabilities),
+        ChiSquareTest("birthday",
+                      statistics.spacings,
+                      spacing_probabilities),
+        ChiSquareTest("complexity",
+                      statistics.complexity,
+                      complexity_probabilities),
+        ChiSquareTest("rank", statistics.ranks, rank_probabilities)};
+}
+
+/*
+ *  FormatSize()
+ *
+ *  Description:
+ *      Format a number of octets using a binary unit.
+ *
+ *  Parameters:
+ *      size [in]
+ *          The number of octets.
+ *
+ *  Returns:
+ *      The formatted size (e.g., "64 MiB").
+ *
+ *  Comments:
+ *      None.
+ */
+std::string FormatSize(std::uint64_t size)
+{
+    constexpr std::array<const char *, 5> Units = {
+        "octets", "KiB", "MiB", "GiB", "TiB"};
+    std::size_t unit = 0;
+    double value = static_cast<double>(size);
+
+    while ((value >= 1024.0) && (unit + 1 < Units.size()))
+    {
+        value /= 1024.0;
+        unit++;
+    }
+
+    std::ostringstream stream;
+    stream << std::setprecision(4) << value << " " << Units[unit];
+
+    return stream.str();
+}
+
+/*
+ *  Report()
+ *
+ *  Description:
+ *      Print the results of the tests.
+ *
+ *  Parameters:
+ *      results [in]
+ *          The results of the tests.
+ *
+ *      length [in]
+ *          The number of octets tested.
+ *
+ *      seconds [in]
+ *          The time taken so far.
+ *
+ *  Returns:
+ *      True if no test failed, false if any did.
+ *
+ *  Comments:
+ *      None.
+ */
+bool Report(const std::vector<TestResult> &results,
+            std::uint64_t length,
+            double seconds)
+{
+    bool passed = true;
+
+    std::cout << "Length " << FormatSize(length) << " (" << std::fixed
+              << std::setprecision(1) << seconds << " s";
+    if (seconds > 0)
+    {
+        std::cout << ", "
+                  << FormatSize(static_cast<std::uint64_t>(length / seconds))
+                  << "/s";
+    }
+    std::cout << ")" << std::endl;
+
+    for (const auto &result : results)
+    {
+        std::cout << "  " << std::left << std::setw(12) << result.name
+                  << std::right;
+
+        if (!result.valid)
+        {
+            std::cout << "(too few samples)" << std::endl;
+            continue;
+        }
+
+        const double tail = std::min(result.p_value, 1.0 - result.p_value);
+
+        std::cout << "p = " << std::setprecision(6) << result.p_value;
+        if (tail < Fail_Threshold)
+        {
+            std::cout << "  FAIL";
+            passed = false;
+        }
+        else if (tail < Unusual_Threshold)
+        {
+            std::cout << "  unusual";
+        }
+        std::cout << std::endl;
+    }
+
+    return passed;
+}
+
+/*
+ *  RunBattery()
+ *
+ *  Description:
+ *      Apply the tests to the stream produced by a generator using the
+ *      given engine.
+ *
+ *  Parameters:
+ *      options [in]
+ *          The options given on the command line.
+ *
+ *  Returns:
+ *      The program's exit code: 0 if all tests pass, 1 if not.
+ *
+ *  Comments:
+ *      The stream is tested in rounds, each of which tests one chunk per
+ *      thread.  Results are reported after the first round in which the
+ *      length tested reaches each power of two multiple of the first
+ *      round's length.
+ */
+template<typename Engine>
+int RunBattery(const Options &options)
+{
+    using Generator = BasicRandomGenerator<Engine>;
+
+    const unsigned threads = std::max(options.threads, 1U);
+    const std::array<std::uint32_t, 2> seed_data = {
+        static_cast<std::uint32_t>(options.seed),
+        static_cast<std::uint32_t>(options.seed >> 32)};
+
+    // Divide small streams among the threads, in whole blocks
+    const std::uint64_t chunk_size = std::clamp<std::uint64_t>(
+        (options.size / threads + Block_Size - 1) / Block_Size * Block_Size,
+        Block_Size,
+        Chunk_Size);
+
+    std::vector<std::unique_ptr<Generator>> generators;
+    std::vector<Statistics> statistics(threads);
+
+    for (unsigned t = 0; t < threads; t++)
+    {
+        if (options.pseudo_random_only)
+        {
+            generators.push_back(std::make_unique<Generator>(seed_data));
+            generators.back()->Discard(t * chunk_size);
+        }
+        else
+        {
+            generators.push_back(std::make_unique<Generator>());
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t tested = 0;
+    std::uint64_t checkpoint = 0;
+
+    for (std::uint64_t chunk = 0; tested < options.size; chunk += threads)
+    {
+        std::vector<std::thread> workers;
+
+        for (unsigned t = 0; t < threads; t++)
+        {
+            const std::uint64_t offset = (chunk + t) * chunk_size;
+            if (offset >= options.size) break;
+
+            const std::uint64_t length =
+                std::min(chunk_size, options.size - offset);
+
+            workers.emplace_back(
+                [&, t, length]()
+                {
+                    std::vector<std::uint8_t> block(Block_Size);
+                    ChunkState state;
+
+                    for (std::uint64_t i = 0; i < length; i += Block_Size)
+                    {
+                        std::span<std::uint8_t> octets(
+                            block.data(),
+                            std::min<std::uint64_t>(Block_Size, length - i));
+
+                        generators[t]->GetRandomOctets(octets);
+                        TestBlock(octets, statistics[t], state);
+                    }
+
+                    // Skip the chunks tested by the other threads
+                    if (options.pseudo_random_only)
+                    {
+                        generators[t]->Discard((threads - 1) * chunk_size);
+                    }
+                });
+
+            tested += length;
+        }
+
+        for (auto &worker : workers) worker.join();
+
+        if ((tested < checkpoint) && (tested < options.size)) continue;
+
+        Statistics total;
+        for (const auto &thread_statistics : statistics)
+        {
+            total.Merge(thread_statistics);
+        }
+
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (!Report(Evaluate(total), tested, seconds)) return 1;
+
+        checkpoint = std::max(checkpoint * 2, tested * 2);
+    }
+
+    return 0;
+}
+
+/*
+ *  Usage()
+ *
+ *  Description:
+ *      Print the program usage.
+ *
+ *  Parameters:
+ *      program [in]
+ *          The name of the program.
+ *
+ *  Returns:
+ *      The program's exit code.
+ *
+ *  Comments:
+ *      None.
+ */
+int Usage(const std::string &program)
+{
+    std::cerr << "Usage: " << program
+              << " [-e engine] [-m prng|source] [-s size[K|M|G|T]]"
+              << std::endl
+              << "       [-S seed] [-t threads]" << std::endl
+              << std::endl
+              << "Engines: mt19937 (default), xoshiro256, xoshiro128, pcg32,"
+              << " philox" << std::endl;
+
+    return 2;
+}
+
+/*
+ *  ParseSize()
+ *
+ *  Description:
+ *      Parse a size with an optional binary unit suffix (e.g., "16G").
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to parse.
+ *
+ *  Returns:
+ *      The size in octets.
+ *
+ *  Comments:
+ *      Throws std::invalid_argument if the text is not a valid size.
+ */
+std::uint64_t ParseSize(const std::string &text)
+{
+    std::size_t length = 0;
+    std::uint64_t size = std::stoull(text, &length);
+    std::string suffix = text.substr(length);
+
+    if (suffix.empty()) return size;
+    if (suffix.size() == 1)
+    {
+        switch (suffix[0])
+        {
+            case 'K': case 'k': return size << 10;
+            case 'M': case 'm': return size << 20;
+            case 'G': case 'g': return size << 30;
+            case 'T': case 't': return size << 40;
+            default: break;
+        }
+    }
+
+    throw std::invalid_argument("Invalid size: " + text);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    options.threads = std::thread::hardware_concurrency();
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string option = argv[i];
+
+            if (i + 1 >= argc) return Usage(argv[0]);
+
+            const std::string value = argv[++i];
+
+            if (option == "-e")
+            {
+                options.engine = value;
+            }
+            else if (option == "-m")
+            {
+                if ((value != "prng") && (value != "source"))
+                {
+                    return Usage(argv[0]);
+                }
+                options.pseudo_random_only = (value == "prng");
+            }
+            else if (option == "-s")
+            {
+                options.size = ParseSize(value);
+            }
+            else if (option == "-S")
+            {
+                options.seed = std::stoull(value, nullptr, 0);
+            }
+            else if (option == "-t")
+            {
+                options.threads = std::stoul(value);
+            }
+            else
+            {
+                return Usage(argv[0]);
+            }
+        }
+
+        std::cout << "Engine " << options.engine << ", "
+                  << (options.pseudo_random_only ? "prng" : "source")
+                  << " mode, " << std::max(options.threads, 1U)
+                  << " threads" << std::endl;
+
+        if (options.engine == "mt19937") return RunBattery<MT19937>(options);
+        if (options.engine == "xoshiro256")
+        {
+            return RunBattery<Xoshiro256PlusPlus>(options);
+        }
+        if (options.engine == "xoshiro128")
+        {
+            return RunBattery<Xoshiro128PlusPlus>(options);
+        }
+        if (options.engine == "pcg32") return RunBattery<PCG32>(options);
+        if (options.engine == "philox") return RunBattery<Philox4x32>(options);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    return Usage(argv[0]);
+}
@@ -0,0 +1,672 @@
+/*
+ *  random_sources.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Utility to measure the throughput and latency of the random sources
+ *      available on this host, so that the size of the reads made to
+ *      refill a seed pool or buffer can be chosen for each class of host.
+ *
+ *      Usage:
+ *          random_sources [-s size[,size...]] [-t threads] [-d milliseconds]
+ *
+ *      Each source is read with each request size (by default, 16 octets
+ *      to 256 KiB) by 1 to the given number of threads (by default, one
+ *      per CPU), doubling the number of threads each time.  For each, the
+ *      aggregate throughput, the rate of reads, the percentiles of the
+ *      latency of each read, and the numbers of short and failed reads are
+ *      reported.  For each source, the smallest request size that reaches
+ *      90% of the source's greatest single-thread throughput is reported
+ *      as the suggested refill size.
+ *
+ *      The sources in the library's chain (see random_source.h) are read
+ *      with ReadRandomSource(), so the results include the cost of the
+ *      health tests and match what generators experience.  Sources that
+ *      the library does not use are read directly for comparison:
+ *      /dev/random, getrandom() with the flags 0, GRND_RANDOM, and
+ *      GRND_INSECURE, and the RDSEED instruction.  These "raw" results do
+ *      not include the health tests.  Before the kernel's random pool is
+ *      initialized, getrandom() with the flags 0 or GRND_RANDOM blocks.
+ *
+ *  Portability Issues:
+ *      The raw sources are available only on Linux (and RDSEED only on
+ *      x86-64 processors).
+ */
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/random.h>
+#define TERRA_RANDOM_RAW_SOURCES
+#endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define TERRA_RANDOM_RDSEED
+#endif
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <span>
+#include <thread>
+#include <latch>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <system_error>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <terra/random/random_source.h>
+#include <terra/random/generator_metrics.h>
+
+using namespace Terra::Random;
+
+namespace
+{
+
+// Fraction of the greatest throughput a suggested refill size reaches
+constexpr double Refill_Fraction = 0.9;
+
+// Octets read to determine whether a source is available
+constexpr std::size_t Probe_Size = 16;
+
+// Options given on the command line
+struct Options
+{
+    std::vector<std::size_t> sizes = {16, 64, 256, 1024, 4096,
+                                      16384, 65536, 262144};
+    unsigned threads = 0;
+    std::chrono::milliseconds duration{100};
+};
+
+// A source of random octets, which reads into the given octets and
+// returns the number of octets read
+struct Source
+{
+    std::string name;
+    std::function<std::size_t(std::span<std::uint8_t>, std::error_code &)>
+        read;
+};
+
+// Results of reading a source, for one thread or all threads
+struct Result
+{
+    std::uint64_t octets = 0;
+    std::uint64_t reads = 0;
+    std::uint64_t short_reads = 0;
+    std::uint64_t errors = 0;
+    LatencyHistogram latency;
+};
+
+#ifdef TERRA_RANDOM_RAW_SOURCES
+// A device opened for reading, which is closed when destroyed
+class Device
+{
+    public:
+        explicit Device(const char *path) :
+            descriptor{open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC)}
+        {
+        }
+        Device(const Device &) = delete;
+        ~Device()
+        {
+            if (descriptor >= 0) close(descriptor);
+        }
+        Device &operator=(const Device &) = delete;
+
+        std::size_t Read(std::span<std::uint8_t> octets,
+                         std::error_code &error) const
+        {
+            if (descriptor < 0)
+            {
+                error = std::make_error_code(std::errc::no_such_device);
+                return 0;
+            }
+
+            return SystemResult(read(descriptor, octets.data(), octets.size()),
+                                error);
+        }
+
+        static std::size_t SystemResult(ssize_t result,
+                                        std::error_code &error)
+        {
+            if (result < 0)
+            {
+                error = std::error_code(errno, std::generic_category());
+                return 0;
+            }
+
+            return static_cast<std::size_t>(result);
+        }
+
+    protected:
+        int descriptor;
+};
+#endif
+
+#ifdef TERRA_RANDOM_RDSEED
+/*
+ *  HaveRDSEED()
+ *
+ *  Description:
+ *      Determine whether the processor supports RDSEED.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      True if RDSEED is supported, false if not.
+ *
+ *  Comments:
+ *      Support is indicated by bit 18 of EBX for CPUID leaf 7.
+ */
+bool HaveRDSEED()
+{
+    unsigned registers[4];
+
+    return (__get_cpuid_count(7,
+                              0,
+                              &registers[0],
+                              &registers[1],
+                              &registers[2],
+                              &registers[3]) != 0) &&
+           ((registers[1] & (1U << 18)) != 0);
+}
+
+/*
+ *  ReadRDSEED()
+ *
+ *  Description:
+ *      Read random octets produced by RDSEED.
+ *
+ *  Parameters:
+ *      octets [out]
+ *          The octets to fill.
+ *
+ *      error [out]
+ *          Set if the processor does not support RDSEED.
+ *
+ *  Returns:
+ *      The number of octets read, which is smaller than the number
+ *      requested if the instruction failed 10 times in succession (as it
+ *      does when its entropy is exhausted).
+ *
+ *  Comments:
+ *      The retry limit is the same as the library uses for RDRAND.
+ */
+__attribute__((target("rdseed")))
+std::size_t ReadRDSEED(std::span<std::uint8_t> octets, std::error_code &error)
+{
+    static const bool supported = HaveRDSEED();
+    std::size_t octets_read = 0;
+
+    if (!supported)
+    {
+        error = std::make_error_code(std::errc::not_supported);
+        return 0;
+    }
+
+    while (octets_read < octets.size())
+    {
+        unsigned long long value;
+        unsigned attempts = 0;
+
+        while ((_rdseed64_step(&value) == 0) && (++attempts < 10)) {}
+        if (attempts == 10) break;
+
+        const std::size_t length =
+            std::min(sizeof(value), octets.size() - octets_read);
+        std::memcpy(octets.data() + octets_read, &value, length);
+        octets_read += length;
+    }
+
+    return octets_read;
+}
+#endif
+
+/*
+ *  ReadWorker()
+ *
+ *  Description:
+ *      Read from a source until told to stop, timing each read.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source to read.
+ *
+ *      size [in]
+ *          The number of octets to request in each read.
+ *
+ *      ready [in]
+ *          A latch on which to wait, so that all threads start together.
+ *
+ *      stop [in]
+ *          Set when the thread is to stop.
+ *
+ *      result [out]
+ *          The thread's results.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      None.
+ */
+void ReadWorker(const Source &source,
+                std::size_t size,
+                std::latch &ready,
+                const std::atomic<bool> &stop,
+                Result &result)
+{
+    std::vector<std::uint8_t> octets(size);
+
+    ready.arrive_and_wait();
+
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        std::error_code error;
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t octets_read = source.read(octets, error);
+        result.latency.Record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count()));
+
+        result.reads++;
+        result.octets += octets_read;
+        if (error)
+        {
+            result.errors++;
+        }
+        else if (octets_read < size)
+        {
+            result.short_reads++;
+        }
+    }
+}
+
+/*
+ *  Measure()
+ *
+ *  Description:
+ *      Read a source with the given request size and number of threads.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source to read.
+ *
+ *      size [in]
+ *          The number of octets to request in each read.
+ *
+ *      threads [in]
+ *          The number of threads reading.
+ *
+ *      duration [in]
+ *          The time for which to read.
+ *
+ *      seconds [out]
+ *          The time for which the threads read.
+ *
+ *  Returns:
+ *      The results of all threads together.
+ *
+ *  Comments:
+ *      None.
+ */
+Result Measure(const Source &source,
+               std::size_t size,
+               unsigned threads,
+               std::chrono::milliseconds duration,
+               double &seconds)
+{
+    std::vector<Result> results(threads);
+    std::vector<std::thread> workers;
+    std::latch ready(threads + 1);
+    std::atomic<bool> stop = false;
+
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back(ReadWorker,
+                             std::cref(source),
+                             size,
+                             std::ref(ready),
+                             std::cref(stop),
+                             std::ref(results[t]));
+    }
+
+    ready.arrive_and_wait();
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto &worker : workers) worker.join();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            start)
+                  .count();
+
+    Result total;
+
+    for (const auto &result : results)
+    {
+        total.octets += result.octets;
+        total.reads += result.reads;
+        total.short_reads += result.short_reads;
+        total.errors += result.errors;
+        total.latency.Merge(result.latency);
+    }
+
+    return total;
+}
+
+/*
+ *  Characterize()
+ *
+ *  Description:
+ *      Measure a source with each request size and number of threads, and
+ *      report the results.
+ *
+ *  Parameters:
+ *      source [in]
+ *          The source to measure.
+ *
+ *      options [in]
+ *          The options given on the command line.
+ *
+ *      thread_counts [in]
+ *          The numbers of threads with which to measure.
+ *
+ *  Returns:
+ *      Nothing.
+ *
+ *  Comments:
+ *      A source that fails to produce Probe_Size octets is reported as
+ *      unavailable and not measured.
+ */
+void Characterize(const Source &source,
+                  const Options &options,
+                  const std::vector<unsigned> &thread_counts)
+{
+    std::vector<std::uint8_t> probe(Probe_Size);
+    std::error_code error;
+
+    std::cout << source.name;
+
+    if ((source.read(probe, error) != probe.size()) || error)
+    {
+        std::cout << ": unavailable ("
+                  << (error ? error.message() : std::string("short read"))
+                  << ")" << std::endl;
+        return;
+    }
+
+    std::cout << std::endl
+              << "      size threads     MiB/s    reads/s     p50 ns"
+              << "     p99 ns   p99.9 ns     max ns   short  errors"
+              << std::endl;
+
+    // Single-thread throughput by size, to suggest a refill size
+    std::vector<double> single_thread;
+
+    for (auto size : options.sizes)
+    {
+        for (auto threads : thread_counts)
+        {
+            double seconds = 0.0;
+            const Result result =
+                Measure(source, size, threads, options.duration, seconds);
+            const double rate = static_cast<double>(result.octets) / seconds;
+
+            if (threads == thread_counts.front())
+            {
+                single_thread.push_back(rate);
+            }
+
+            std::cout << std::fixed << std::setw(10) << size << std::setw(8)
+                      << threads << std::setw(10) << std::setprecision(1)
+                      << rate / (1 << 20) << std::setw(11)
+                      << std::setprecision(0)
+                      << static_cast<double>(result.reads) / seconds
+                      << std::setw(11) << result.latency.GetPercentile(50.0)
+                      << std::setw(11) << result.latency.GetPercentile(99.0)
+                      << std::setw(11) << result.latency.GetPercentile(99.9)
+                      << std::setw(11) << result.latency.GetMaximum()
+                      << std::setw(8) << result.short_reads << std::setw(8)
+                      << result.errors << std::endl;
+        }
+    }
+
+    const double peak =
+        *std::max_element(single_thread.begin(), single_thread.end());
+
+    for (std::size_t i = 0; i < single_thread.size(); i++)
+    {
+        if (single_thread[i] >= Refill_Fraction * peak)
+        {
+            std::cout << "  suggested refill size: " << options.sizes[i]
+                      << " octets (" << std::setprecision(0)
+                      << 100.0 * single_thread[i] / peak
+                      << "% of the peak single-thread throughput)"
+                      << std::endl;
+            break;
+        }
+    }
+}
+
+/*
+ *  GetSources()
+ *
+ *  Description:
+ *      Get the sources to measure.
+ *
+ *  Parameters:
+ *      None.
+ *
+ *  Returns:
+ *      The library's sources, in the order of its chain, followed by the
+ *      raw sources.
+ *
+ *  Comments:
+ *      Timing jitter is excluded, as the library uses it only for seeding.
+ */
+std::vector<Source> GetSources()
+{
+    std::vector<Source> sources;
+
+    for (auto source : GetRandomSources())
+    {
+        if (source == RandomSource::Jitter) continue;
+
+        sources.push_back(
+            {std::string(GetRandomSourceName(source)) + " (library)",
+             [source](std::span<std::uint8_t> octets, std::error_code &error)
+             {
+                 return ReadRandomSource(source, octets, error);
+             }});
+    }
+
+#ifdef TERRA_RANDOM_RAW_SOURCES
+    static const Device dev_random("/dev/random");
+
+    sources.push_back(
+        {"/dev/random (raw)",
+         [](std::span<std::uint8_t> octets, std::error_code &error)
+         {
+             return dev_random.Read(octets, error);
+         }});
+
+    // The flags with which getrandom() is called directly
+    const std::vector<std::pair<std::string, unsigned>> flags =
+    {
+        {"0", 0},
+        {"GRND_RANDOM", GRND_RANDOM},
+#ifdef GRND_INSECURE
+        {"GRND_INSECURE", GRND_INSECURE}
+#else
+        {"GRND_INSECURE", 0x0004}
+#endif
+    };
+
+    for (const auto &[name, flag] : flags)
+    {
+        sources.push_back(
+            {"getrandom(" + name + ") (raw)",
+             [flag](std::span<std::uint8_t> octets, std::error_code &error)
+             {
+                 return Device::SystemResult(
+                     getrandom(octets.data(), octets.size(), flag),
+                     error);
+             }});
+    }
+#endif
+
+#ifdef TERRA_RANDOM_RDSEED
+    sources.push_back({"rdseed (raw)", ReadRDSEED});
+#endif
+
+    return sources;
+}
+
+/*
+ *  Usage()
+ *
+ *  Description:
+ *      Print the program usage.
+ *
+ *  Parameters:
+ *      program [in]
+ *          The name of the program.
+ *
+ *  Returns:
+ *      The program's exit code.
+ *
+ *  Comments:
+ *      None.
+ */
+int Usage(const std::string &program)
+{
+    std::cerr << "Usage: " << program
+              << " [-s size[,size...]] [-t threads] [-d milliseconds]"
+              << std::endl;
+
+    return 2;
+}
+
+/*
+ *  ParseSizes()
+ *
+ *  Description:
+ *      Parse a list of sizes separated by commas, each with an optional
+ *      binary unit suffix (e.g., "64,4K,1M").
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to parse.
+ *
+ *  Returns:
+ *      The sizes in octets.
+ *
+ *  Comments:
+ *      Throws std::invalid_argument if the text is not a valid list.
+ */
+std::vector<std::size_t> ParseSizes(const std::string &text)
+{
+    std::vector<std::size_t> sizes;
+    std::istringstream stream(text);
+    std::string item;
+
+    while (std::getline(stream, item, ','))
+    {
+        std::size_t length = 0;
+        std::size_t size = std::stoul(item, &length);
+        const std::string suffix = item.substr(length);
+
+        if (suffix == "K" || suffix == "k")
+        {
+            size <<= 10;
+        }
+        else if (suffix == "M" || suffix == "m")
+        {
+            size <<= 20;
+        }
+        else if (!suffix.empty() || (size == 0))
+        {
+            throw std::invalid_argument("Invalid size: " + item);
+        }
+
+        sizes.push_back(size);
+    }
+
+    if (sizes.empty()) throw std::invalid_argument("No sizes given");
+
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    options.threads = std::max(1U, std::thread::hardware_concurrency());
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string option = argv[i];
+
+            if (i + 1 >= argc) return Usage(argv[0]);
+
+            const std::string value = argv[++i];
+
+            if (option == "-s")
+            {
+                options.sizes = ParseSizes(value);
+            }
+            else if (option == "-t")
+            {
+                options.threads = std::stoul(value);
+                if (options.threads == 0) return Usage(argv[0]);
+            }
+            else if (option == "-d")
+            {
+                options.duration = std::chrono::milliseconds(std::stoul(value));
+            }
+            else
+            {
+                return Usage(argv[0]);
+            }
+        }
+
+        std::vector<unsigned> thread_counts;
+
+        for (unsigned threads = 1; threads < options.threads; threads *= 2)
+        {
+            thread_counts.push_back(threads);
+        }
+        thread_counts.push_back(options.threads);
+
+        for (const auto &source : GetSources())
+        {
+            Characterize(source, options, thread_counts);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
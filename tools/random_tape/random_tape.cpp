@@ -0,0 +1,151 @@
+/*
+ *  random_tape.cpp
+ *
+ *  Copyright (C) 2024
+ *  Terrapane Corporation
+ *  All Rights Reserved
+ *
+ *  Author:
+ *      Paul E. Jones <paulej@packetizer.com>
+ *
+ *  Description:
+ *      Utility to create and inspect random tape files (see RandomTape).
+ *
+ *      Usage:
+ *          random_tape create <file> <size>[K|M|G|T] [seed] [threads]
+ *          random_tape info <file>
+ *
+ *  Portability Issues:
+ *      None.
+ */
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <terra/random/random_tape.h>
+
+using namespace Terra::Random;
+
+namespace
+{
+
+/*
+ *  Usage()
+ *
+ *  Description:
+ *      Print the program usage.
+ *
+ *  Parameters:
+ *      program [in]
+ *          The name of the program.
+ *
+ *  Returns:
+ *      The program's exit code.
+ *
+ *  Comments:
+ *      None.
+ */
+int Usage(const std::string &program)
+{
+    std::cerr << "Usage: " << program
+              << " create <file> <size>[K|M|G|T] [seed] [threads]"
+              << std::endl
+              << "       " << program << " info <file>" << std::endl;
+
+    return 1;
+}
+
+/*
+ *  ParseSize()
+ *
+ *  Description:
+ *      Parse a size with an optional binary unit suffix (e.g., "16G").
+ *
+ *  Parameters:
+ *      text [in]
+ *          The text to parse.
+ *
+ *  Returns:
+ *      The size in octets.
+ *
+ *  Comments:
+ *      Throws std::invalid_argument if the text is not a valid size.
+ */
+std::uint64_t ParseSize(const std::string &text)
+{
+    std::size_t length = 0;
+    std::uint64_t size = std::stoull(text, &length);
+    std::string suffix = text.substr(length);
+
+    if (suffix.empty()) return size;
+    if (suffix.size() == 1)
+    {
+        switch (suffix[0])
+        {
+            case 'K': case 'k': return size << 10;
+            case 'M': case 'm': return size << 20;
+            case 'G': case 'g': return size << 30;
+            case 'T': case 't': return size << 40;
+            default: break;
+        }
+    }
+
+    throw std::invalid_argument("Invalid size: " + text);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) return Usage(argv[0]);
+
+    const std::string command = argv[1];
+    const std::string filename = argv[2];
+
+    try
+    {
+        if ((command == "create") && (argc >= 4) && (argc <= 6))
+        {
+            std::uint64_t size = ParseSize(argv[3]);
+            std::uint64_t seed = (argc > 4) ? std::stoull(argv[4], nullptr, 0)
+                                            : 0;
+            unsigned threads = (argc > 5) ? std::stoul(argv[5]) : 0;
+
+            auto start = std::chrono::steady_clock::now();
+            RandomTape::Create(filename, size, seed, threads);
+            std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+
+            std::cout << "Created " << filename << " with " << size
+                      << " octets in " << elapsed.count() << " s";
+            if (elapsed.count() > 0)
+            {
+                std::cout << " (" << (size / elapsed.count() / (1 << 20))
+                          << " MiB/s)";
+            }
+            std::cout << std::endl;
+
+            return 0;
+        }
+
+        if ((command == "info") && (argc == 3))
+        {
+            RandomTape tape(filename);
+
+            std::cout << "File: " << filename << std::endl
+                      << "Seed: " << tape.GetSeed() << std::endl
+                      << "Size: " << tape.Size() << std::endl;
+
+            return 0;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return Usage(argv[0]);
+}